@@ -0,0 +1,33 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tests/epoch_reclaimer_test.cc" "tests/CMakeFiles/test_freelist.dir/epoch_reclaimer_test.cc.o" "gcc" "tests/CMakeFiles/test_freelist.dir/epoch_reclaimer_test.cc.o.d"
+  "/root/repo/tests/freelist_allocator_test.cc" "tests/CMakeFiles/test_freelist.dir/freelist_allocator_test.cc.o" "gcc" "tests/CMakeFiles/test_freelist.dir/freelist_allocator_test.cc.o.d"
+  "/root/repo/tests/freelist_destructor_test.cc" "tests/CMakeFiles/test_freelist.dir/freelist_destructor_test.cc.o" "gcc" "tests/CMakeFiles/test_freelist.dir/freelist_destructor_test.cc.o.d"
+  "/root/repo/tests/freelist_test.cc" "tests/CMakeFiles/test_freelist.dir/freelist_test.cc.o" "gcc" "tests/CMakeFiles/test_freelist.dir/freelist_test.cc.o.d"
+  "/root/repo/tests/freelist_thread_test.cc" "tests/CMakeFiles/test_freelist.dir/freelist_thread_test.cc.o" "gcc" "tests/CMakeFiles/test_freelist.dir/freelist_thread_test.cc.o.d"
+  "/root/repo/tests/freelist_view_test.cc" "tests/CMakeFiles/test_freelist.dir/freelist_view_test.cc.o" "gcc" "tests/CMakeFiles/test_freelist.dir/freelist_view_test.cc.o.d"
+  "/root/repo/tests/growable_freelist_test.cc" "tests/CMakeFiles/test_freelist.dir/growable_freelist_test.cc.o" "gcc" "tests/CMakeFiles/test_freelist.dir/growable_freelist_test.cc.o.d"
+  "/root/repo/tests/sharded_freelist_test.cc" "tests/CMakeFiles/test_freelist.dir/sharded_freelist_test.cc.o" "gcc" "tests/CMakeFiles/test_freelist.dir/sharded_freelist_test.cc.o.d"
+  "/root/repo/tests/shared_freelist_test.cc" "tests/CMakeFiles/test_freelist.dir/shared_freelist_test.cc.o" "gcc" "tests/CMakeFiles/test_freelist.dir/shared_freelist_test.cc.o.d"
+  "/root/repo/tests/shared_handle_test.cc" "tests/CMakeFiles/test_freelist.dir/shared_handle_test.cc.o" "gcc" "tests/CMakeFiles/test_freelist.dir/shared_handle_test.cc.o.d"
+  "/root/repo/tests/size_class_pool_test.cc" "tests/CMakeFiles/test_freelist.dir/size_class_pool_test.cc.o" "gcc" "tests/CMakeFiles/test_freelist.dir/size_class_pool_test.cc.o.d"
+  "/root/repo/tests/soa_freelist_test.cc" "tests/CMakeFiles/test_freelist.dir/soa_freelist_test.cc.o" "gcc" "tests/CMakeFiles/test_freelist.dir/soa_freelist_test.cc.o.d"
+  "/root/repo/tests/spsc_freelist_test.cc" "tests/CMakeFiles/test_freelist.dir/spsc_freelist_test.cc.o" "gcc" "tests/CMakeFiles/test_freelist.dir/spsc_freelist_test.cc.o.d"
+  "/root/repo/tests/thread_cache_test.cc" "tests/CMakeFiles/test_freelist.dir/thread_cache_test.cc.o" "gcc" "tests/CMakeFiles/test_freelist.dir/thread_cache_test.cc.o.d"
+  "/root/repo/tests/virtual_freelist_test.cc" "tests/CMakeFiles/test_freelist.dir/virtual_freelist_test.cc.o" "gcc" "tests/CMakeFiles/test_freelist.dir/virtual_freelist_test.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
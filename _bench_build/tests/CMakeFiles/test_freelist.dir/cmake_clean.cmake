@@ -0,0 +1,39 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_freelist.dir/epoch_reclaimer_test.cc.o"
+  "CMakeFiles/test_freelist.dir/epoch_reclaimer_test.cc.o.d"
+  "CMakeFiles/test_freelist.dir/freelist_allocator_test.cc.o"
+  "CMakeFiles/test_freelist.dir/freelist_allocator_test.cc.o.d"
+  "CMakeFiles/test_freelist.dir/freelist_destructor_test.cc.o"
+  "CMakeFiles/test_freelist.dir/freelist_destructor_test.cc.o.d"
+  "CMakeFiles/test_freelist.dir/freelist_test.cc.o"
+  "CMakeFiles/test_freelist.dir/freelist_test.cc.o.d"
+  "CMakeFiles/test_freelist.dir/freelist_thread_test.cc.o"
+  "CMakeFiles/test_freelist.dir/freelist_thread_test.cc.o.d"
+  "CMakeFiles/test_freelist.dir/freelist_view_test.cc.o"
+  "CMakeFiles/test_freelist.dir/freelist_view_test.cc.o.d"
+  "CMakeFiles/test_freelist.dir/growable_freelist_test.cc.o"
+  "CMakeFiles/test_freelist.dir/growable_freelist_test.cc.o.d"
+  "CMakeFiles/test_freelist.dir/sharded_freelist_test.cc.o"
+  "CMakeFiles/test_freelist.dir/sharded_freelist_test.cc.o.d"
+  "CMakeFiles/test_freelist.dir/shared_freelist_test.cc.o"
+  "CMakeFiles/test_freelist.dir/shared_freelist_test.cc.o.d"
+  "CMakeFiles/test_freelist.dir/shared_handle_test.cc.o"
+  "CMakeFiles/test_freelist.dir/shared_handle_test.cc.o.d"
+  "CMakeFiles/test_freelist.dir/size_class_pool_test.cc.o"
+  "CMakeFiles/test_freelist.dir/size_class_pool_test.cc.o.d"
+  "CMakeFiles/test_freelist.dir/soa_freelist_test.cc.o"
+  "CMakeFiles/test_freelist.dir/soa_freelist_test.cc.o.d"
+  "CMakeFiles/test_freelist.dir/spsc_freelist_test.cc.o"
+  "CMakeFiles/test_freelist.dir/spsc_freelist_test.cc.o.d"
+  "CMakeFiles/test_freelist.dir/thread_cache_test.cc.o"
+  "CMakeFiles/test_freelist.dir/thread_cache_test.cc.o.d"
+  "CMakeFiles/test_freelist.dir/virtual_freelist_test.cc.o"
+  "CMakeFiles/test_freelist.dir/virtual_freelist_test.cc.o.d"
+  "test_freelist"
+  "test_freelist.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_freelist.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
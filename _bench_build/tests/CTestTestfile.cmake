@@ -0,0 +1,286 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/tests
+# Build directory: /root/repo/_bench_build/tests
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(EpochReclaimerTest.retire_waits_for_reader.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=EpochReclaimerTest.retire_waits_for_reader")
+set_tests_properties(EpochReclaimerTest.retire_waits_for_reader.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(EpochReclaimerTest.nested_guards.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=EpochReclaimerTest.nested_guards")
+set_tests_properties(EpochReclaimerTest.nested_guards.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(EpochReclaimerTest.batches_reclaim_without_readers.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=EpochReclaimerTest.batches_reclaim_without_readers")
+set_tests_properties(EpochReclaimerTest.batches_reclaim_without_readers.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(EpochReclaimerTest.destructor_flushes.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=EpochReclaimerTest.destructor_flushes")
+set_tests_properties(EpochReclaimerTest.destructor_flushes.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(EpochReclaimerTest.too_many_participants.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=EpochReclaimerTest.too_many_participants")
+set_tests_properties(EpochReclaimerTest.too_many_participants.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(EpochReclaimerTest.threads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=EpochReclaimerTest.threads")
+set_tests_properties(EpochReclaimerTest.threads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListAllocatorTest.traits.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListAllocatorTest.traits")
+set_tests_properties(FreeListAllocatorTest.traits.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListAllocatorTest.equality.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListAllocatorTest.equality")
+set_tests_properties(FreeListAllocatorTest.equality.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListAllocatorTest.single_objects_from_parent.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListAllocatorTest.single_objects_from_parent")
+set_tests_properties(FreeListAllocatorTest.single_objects_from_parent.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListAllocatorTest.full.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListAllocatorTest.full")
+set_tests_properties(FreeListAllocatorTest.full.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListAllocatorTest.list.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListAllocatorTest.list")
+set_tests_properties(FreeListAllocatorTest.list.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListAllocatorTest.map.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListAllocatorTest.map")
+set_tests_properties(FreeListAllocatorTest.map.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListAllocatorTest.unordered_map.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListAllocatorTest.unordered_map")
+set_tests_properties(FreeListAllocatorTest.unordered_map.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListAllocatorTest.siblings_outlive_original.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListAllocatorTest.siblings_outlive_original")
+set_tests_properties(FreeListAllocatorTest.siblings_outlive_original.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.sizeof_.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.sizeof_")
+set_tests_properties(FreeListTest/*.sizeof_.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.empty.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.empty")
+set_tests_properties(FreeListTest/*.empty.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.full.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.full")
+set_tests_properties(FreeListTest/*.full.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.size.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.size")
+set_tests_properties(FreeListTest/*.size.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.capacity.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.capacity")
+set_tests_properties(FreeListTest/*.capacity.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.alloc.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.alloc")
+set_tests_properties(FreeListTest/*.alloc.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.alloc_prefetched.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.alloc_prefetched")
+set_tests_properties(FreeListTest/*.alloc_prefetched.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.data_integrity.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.data_integrity")
+set_tests_properties(FreeListTest/*.data_integrity.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.alloc_and_free.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.alloc_and_free")
+set_tests_properties(FreeListTest/*.alloc_and_free.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.make_unique.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.make_unique")
+set_tests_properties(FreeListTest/*.make_unique.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.deleter.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.deleter")
+set_tests_properties(FreeListTest/*.deleter.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.make_shared.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.make_shared")
+set_tests_properties(FreeListTest/*.make_shared.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.vector_allocator.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.vector_allocator")
+set_tests_properties(FreeListTest/*.vector_allocator.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.push_and_pop_indices.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.push_and_pop_indices")
+set_tests_properties(FreeListTest/*.push_and_pop_indices.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.alloc_n_and_free_n.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.alloc_n_and_free_n")
+set_tests_properties(FreeListTest/*.alloc_n_and_free_n.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.reserve_fresh.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.reserve_fresh")
+set_tests_properties(FreeListTest/*.reserve_fresh.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.emplace.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.emplace")
+set_tests_properties(FreeListTest/*.emplace.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.live.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.live")
+set_tests_properties(FreeListTest/*.live.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.cache_line_aligned.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.cache_line_aligned")
+set_tests_properties(FreeListTest/*.cache_line_aligned.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListAlignmentTest.cache_line_aligned.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListAlignmentTest.cache_line_aligned")
+set_tests_properties(FreeListAlignmentTest.cache_line_aligned.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListOccupancyBitmapTest.capacity.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListOccupancyBitmapTest.capacity")
+set_tests_properties(FreeListOccupancyBitmapTest.capacity.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListOccupancyBitmapTest.queries.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListOccupancyBitmapTest.queries")
+set_tests_properties(FreeListOccupancyBitmapTest.queries.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListOccupancyBitmapTest.clear_destroys_items.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListOccupancyBitmapTest.clear_destroys_items")
+set_tests_properties(FreeListOccupancyBitmapTest.clear_destroys_items.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListAddressOrderedTest.lowest_first.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListAddressOrderedTest.lowest_first")
+set_tests_properties(FreeListAddressOrderedTest.lowest_first.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListAddressOrderedTest.alloc_near.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListAddressOrderedTest.alloc_near")
+set_tests_properties(FreeListAddressOrderedTest.alloc_near.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListAddressOrderedTest.reserve_fresh_after_alloc.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListAddressOrderedTest.reserve_fresh_after_alloc")
+set_tests_properties(FreeListAddressOrderedTest.reserve_fresh_after_alloc.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListTest/*.compact_free_list.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListTest/*.compact_free_list")
+set_tests_properties(FreeListTest/*.compact_free_list.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListHandleTest/*.try_get.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListHandleTest/*.try_get")
+set_tests_properties(FreeListHandleTest/*.try_get.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListHandleTest/*.batches_and_clear.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListHandleTest/*.batches_and_clear")
+set_tests_properties(FreeListHandleTest/*.batches_and_clear.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListHandleTest.capacity.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListHandleTest.capacity")
+set_tests_properties(FreeListHandleTest.capacity.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListWidthsTest.control_words.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListWidthsTest.control_words")
+set_tests_properties(FreeListWidthsTest.control_words.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListStatsTest.snapshot.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListStatsTest.snapshot")
+set_tests_properties(FreeListStatsTest.snapshot.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListForwardingTest.no_copies.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListForwardingTest.no_copies")
+set_tests_properties(FreeListForwardingTest.no_copies.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListForwardingTest.move_only.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListForwardingTest.move_only")
+set_tests_properties(FreeListForwardingTest.move_only.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListForwardingTest.emplace_noexcept.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListForwardingTest.emplace_noexcept")
+set_tests_properties(FreeListForwardingTest.emplace_noexcept.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListDestructorTest.empty.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListDestructorTest.empty")
+set_tests_properties(FreeListDestructorTest.empty.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListDestructorTest.push_and_pop.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListDestructorTest.push_and_pop")
+set_tests_properties(FreeListDestructorTest.push_and_pop.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListDestructorTest.missing_pop.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListDestructorTest.missing_pop")
+set_tests_properties(FreeListDestructorTest.missing_pop.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListDestructorTest.early_clear.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListDestructorTest.early_clear")
+set_tests_properties(FreeListDestructorTest.early_clear.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListDestructorTest.clear_scattered.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListDestructorTest.clear_scattered")
+set_tests_properties(FreeListDestructorTest.clear_scattered.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListDestructorTest.make_unique.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListDestructorTest.make_unique")
+set_tests_properties(FreeListDestructorTest.make_unique.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListDestructorTest.make_shared.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListDestructorTest.make_shared")
+set_tests_properties(FreeListDestructorTest.make_shared.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListDestructorTest.alloc_n_and_free_n.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListDestructorTest.alloc_n_and_free_n")
+set_tests_properties(FreeListDestructorTest.alloc_n_and_free_n.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListDestructorTest.alloc_n_throwing_constructor.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListDestructorTest.alloc_n_throwing_constructor")
+set_tests_properties(FreeListDestructorTest.alloc_n_throwing_constructor.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListThreadTest.twoThreads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListThreadTest.twoThreads")
+set_tests_properties(FreeListThreadTest.twoThreads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListThreadTest.tenThreads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListThreadTest.tenThreads")
+set_tests_properties(FreeListThreadTest.tenThreads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListThreadTest.oneHundredThreads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListThreadTest.oneHundredThreads")
+set_tests_properties(FreeListThreadTest.oneHundredThreads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListThreadTest.fourByteIndexTenThreads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListThreadTest.fourByteIndexTenThreads")
+set_tests_properties(FreeListThreadTest.fourByteIndexTenThreads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListThreadTest.occupancyBitmapTenThreads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListThreadTest.occupancyBitmapTenThreads")
+set_tests_properties(FreeListThreadTest.occupancyBitmapTenThreads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListThreadTest.addressOrderedTenThreads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListThreadTest.addressOrderedTenThreads")
+set_tests_properties(FreeListThreadTest.addressOrderedTenThreads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListThreadTest.statsTenThreads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListThreadTest.statsTenThreads")
+set_tests_properties(FreeListThreadTest.statsTenThreads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListThreadTest.eliminationTenThreads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListThreadTest.eliminationTenThreads")
+set_tests_properties(FreeListThreadTest.eliminationTenThreads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListThreadTest.head32TenThreads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListThreadTest.head32TenThreads")
+set_tests_properties(FreeListThreadTest.head32TenThreads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListViewTest.capacity.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListViewTest.capacity")
+set_tests_properties(FreeListViewTest.capacity.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListViewTest.invalid_buffer.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListViewTest.invalid_buffer")
+set_tests_properties(FreeListViewTest.invalid_buffer.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListViewTest.alloc_and_free.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListViewTest.alloc_and_free")
+set_tests_properties(FreeListViewTest.alloc_and_free.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListViewTest.indices.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListViewTest.indices")
+set_tests_properties(FreeListViewTest.indices.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListViewTest.attach.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListViewTest.attach")
+set_tests_properties(FreeListViewTest.attach.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListViewTest.emplace_move_only.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListViewTest.emplace_move_only")
+set_tests_properties(FreeListViewTest.emplace_move_only.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListViewTest.deleter.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListViewTest.deleter")
+set_tests_properties(FreeListViewTest.deleter.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListViewTest.live.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListViewTest.live")
+set_tests_properties(FreeListViewTest.live.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListViewTest.copies_share_buffer.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListViewTest.copies_share_buffer")
+set_tests_properties(FreeListViewTest.copies_share_buffer.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListViewTest.clear.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListViewTest.clear")
+set_tests_properties(FreeListViewTest.clear.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FreeListViewTest.mmap_buffer.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=FreeListViewTest.mmap_buffer")
+set_tests_properties(FreeListViewTest.mmap_buffer.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(GrowableFreeListTest.empty.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=GrowableFreeListTest.empty")
+set_tests_properties(GrowableFreeListTest.empty.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(GrowableFreeListTest.grows_on_demand.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=GrowableFreeListTest.grows_on_demand")
+set_tests_properties(GrowableFreeListTest.grows_on_demand.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(GrowableFreeListTest.slab_of_item.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=GrowableFreeListTest.slab_of_item")
+set_tests_properties(GrowableFreeListTest.slab_of_item.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(GrowableFreeListTest.make_unique.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=GrowableFreeListTest.make_unique")
+set_tests_properties(GrowableFreeListTest.make_unique.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(GrowableFreeListTest.for_each_live.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=GrowableFreeListTest.for_each_live")
+set_tests_properties(GrowableFreeListTest.for_each_live.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(GrowableFreeListTest.reuses_freed_space.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=GrowableFreeListTest.reuses_freed_space")
+set_tests_properties(GrowableFreeListTest.reuses_freed_space.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(GrowableFreeListTest.max_slabs.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=GrowableFreeListTest.max_slabs")
+set_tests_properties(GrowableFreeListTest.max_slabs.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(GrowableFreeListTest.release_empty_slabs.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=GrowableFreeListTest.release_empty_slabs")
+set_tests_properties(GrowableFreeListTest.release_empty_slabs.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(GrowableFreeListTest.destructor.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=GrowableFreeListTest.destructor")
+set_tests_properties(GrowableFreeListTest.destructor.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(GrowableFreeListTest.tenThreads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=GrowableFreeListTest.tenThreads")
+set_tests_properties(GrowableFreeListTest.tenThreads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(ShardedFreeListTest.empty.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=ShardedFreeListTest.empty")
+set_tests_properties(ShardedFreeListTest.empty.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(ShardedFreeListTest.local_first.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=ShardedFreeListTest.local_first")
+set_tests_properties(ShardedFreeListTest.local_first.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(ShardedFreeListTest.steals_when_full.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=ShardedFreeListTest.steals_when_full")
+set_tests_properties(ShardedFreeListTest.steals_when_full.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(ShardedFreeListTest.remote_free.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=ShardedFreeListTest.remote_free")
+set_tests_properties(ShardedFreeListTest.remote_free.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(ShardedFreeListTest.destructor.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=ShardedFreeListTest.destructor")
+set_tests_properties(ShardedFreeListTest.destructor.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(ShardedFreeListTest.eightThreads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=ShardedFreeListTest.eightThreads")
+set_tests_properties(ShardedFreeListTest.eightThreads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SharedMemoryFreeListTest.create_and_open.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SharedMemoryFreeListTest.create_and_open")
+set_tests_properties(SharedMemoryFreeListTest.create_and_open.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SharedMemoryFreeListTest.open_wrong_type.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SharedMemoryFreeListTest.open_wrong_type")
+set_tests_properties(SharedMemoryFreeListTest.open_wrong_type.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SharedMemoryFreeListTest.unlinked_mapping_remains_valid.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SharedMemoryFreeListTest.unlinked_mapping_remains_valid")
+set_tests_properties(SharedMemoryFreeListTest.unlinked_mapping_remains_valid.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SharedMemoryFreeListTest.processes.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SharedMemoryFreeListTest.processes")
+set_tests_properties(SharedMemoryFreeListTest.processes.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SharedHandleTest.size.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SharedHandleTest.size")
+set_tests_properties(SharedHandleTest.size.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SharedHandleTest.reference_count.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SharedHandleTest.reference_count")
+set_tests_properties(SharedHandleTest.reference_count.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SharedHandleTest.growable.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SharedHandleTest.growable")
+set_tests_properties(SharedHandleTest.growable.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SharedHandleTest.copied_item_has_own_count.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SharedHandleTest.copied_item_has_own_count")
+set_tests_properties(SharedHandleTest.copied_item_has_own_count.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SharedHandleTest.threads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SharedHandleTest.threads")
+set_tests_properties(SharedHandleTest.threads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SharedHandleTest.no_heap_allocation.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SharedHandleTest.no_heap_allocation")
+set_tests_properties(SharedHandleTest.no_heap_allocation.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SharedHandleTest.make_shared_full.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SharedHandleTest.make_shared_full")
+set_tests_properties(SharedHandleTest.make_shared_full.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SizeClassPoolTest.size_classes.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SizeClassPoolTest.size_classes")
+set_tests_properties(SizeClassPoolTest.size_classes.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SizeClassPoolTest.allocate_and_deallocate.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SizeClassPoolTest.allocate_and_deallocate")
+set_tests_properties(SizeClassPoolTest.allocate_and_deallocate.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SizeClassPoolTest.alignment.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SizeClassPoolTest.alignment")
+set_tests_properties(SizeClassPoolTest.alignment.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SizeClassPoolTest.full_class_uses_larger_class.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SizeClassPoolTest.full_class_uses_larger_class")
+set_tests_properties(SizeClassPoolTest.full_class_uses_larger_class.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SizeClassPoolTest.threads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SizeClassPoolTest.threads")
+set_tests_properties(SizeClassPoolTest.threads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SoAFreeListTest.columns.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SoAFreeListTest.columns")
+set_tests_properties(SoAFreeListTest.columns.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SoAFreeListTest.alloc_and_free.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SoAFreeListTest.alloc_and_free")
+set_tests_properties(SoAFreeListTest.alloc_and_free.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SoAFreeListTest.for_each_live.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SoAFreeListTest.for_each_live")
+set_tests_properties(SoAFreeListTest.for_each_live.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SoAFreeListTest.capacity_out_of_range.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SoAFreeListTest.capacity_out_of_range")
+set_tests_properties(SoAFreeListTest.capacity_out_of_range.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SoAFreeListTest.threads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SoAFreeListTest.threads")
+set_tests_properties(SoAFreeListTest.threads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SpscFreeListTest.empty.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SpscFreeListTest.empty")
+set_tests_properties(SpscFreeListTest.empty.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SpscFreeListTest.alloc_and_free.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SpscFreeListTest.alloc_and_free")
+set_tests_properties(SpscFreeListTest.alloc_and_free.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SpscFreeListTest.reuses_returned_chain.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SpscFreeListTest.reuses_returned_chain")
+set_tests_properties(SpscFreeListTest.reuses_returned_chain.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SpscFreeListTest.clear.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SpscFreeListTest.clear")
+set_tests_properties(SpscFreeListTest.clear.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SpscFreeListTest.small_index.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SpscFreeListTest.small_index")
+set_tests_properties(SpscFreeListTest.small_index.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SpscFreeListTest.pipeline.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=SpscFreeListTest.pipeline")
+set_tests_properties(SpscFreeListTest.pipeline.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(ThreadCacheTest.refill_takes_half_magazine.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=ThreadCacheTest.refill_takes_half_magazine")
+set_tests_properties(ThreadCacheTest.refill_takes_half_magazine.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(ThreadCacheTest.flush_returns_to_parent.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=ThreadCacheTest.flush_returns_to_parent")
+set_tests_properties(ThreadCacheTest.flush_returns_to_parent.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(ThreadCacheTest.mixed_with_parent.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=ThreadCacheTest.mixed_with_parent")
+set_tests_properties(ThreadCacheTest.mixed_with_parent.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(ThreadCacheTest.exhausted_parent.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=ThreadCacheTest.exhausted_parent")
+set_tests_properties(ThreadCacheTest.exhausted_parent.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(ThreadCacheTest.tenThreads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=ThreadCacheTest.tenThreads")
+set_tests_properties(ThreadCacheTest.tenThreads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(VirtualMemoryFreeListTest.commit_on_use.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=VirtualMemoryFreeListTest.commit_on_use")
+set_tests_properties(VirtualMemoryFreeListTest.commit_on_use.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(VirtualMemoryFreeListTest.trim_after_burst.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=VirtualMemoryFreeListTest.trim_after_burst")
+set_tests_properties(VirtualMemoryFreeListTest.trim_after_burst.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(VirtualMemoryFreeListTest.trim_keeps_interior_free_elements.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=VirtualMemoryFreeListTest.trim_keeps_interior_free_elements")
+set_tests_properties(VirtualMemoryFreeListTest.trim_keeps_interior_free_elements.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(VirtualMemoryFreeListTest.clear.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=VirtualMemoryFreeListTest.clear")
+set_tests_properties(VirtualMemoryFreeListTest.clear.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(VirtualMemoryFreeListTest.too_small.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=VirtualMemoryFreeListTest.too_small")
+set_tests_properties(VirtualMemoryFreeListTest.too_small.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(VirtualMemoryFreeListTest.threads.noArgs "/root/repo/_bench_build/tests/test_freelist" "--gtest_filter=VirtualMemoryFreeListTest.threads")
+set_tests_properties(VirtualMemoryFreeListTest.threads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;46;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(PoolResourceTest/*.size_classes.noArgs "/root/repo/_bench_build/tests/test_pool_resource" "--gtest_filter=PoolResourceTest/*.size_classes")
+set_tests_properties(PoolResourceTest/*.size_classes.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;57;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(PoolResourceTest/*.alignment.noArgs "/root/repo/_bench_build/tests/test_pool_resource" "--gtest_filter=PoolResourceTest/*.alignment")
+set_tests_properties(PoolResourceTest/*.alignment.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;57;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(PoolResourceTest/*.oversized_upstream.noArgs "/root/repo/_bench_build/tests/test_pool_resource" "--gtest_filter=PoolResourceTest/*.oversized_upstream")
+set_tests_properties(PoolResourceTest/*.oversized_upstream.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;57;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(PoolResourceTest/*.reuse.noArgs "/root/repo/_bench_build/tests/test_pool_resource" "--gtest_filter=PoolResourceTest/*.reuse")
+set_tests_properties(PoolResourceTest/*.reuse.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;57;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(PoolResourceTest/*.containers.noArgs "/root/repo/_bench_build/tests/test_pool_resource" "--gtest_filter=PoolResourceTest/*.containers")
+set_tests_properties(PoolResourceTest/*.containers.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;57;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(PoolResourceTest/*.equality.noArgs "/root/repo/_bench_build/tests/test_pool_resource" "--gtest_filter=PoolResourceTest/*.equality")
+set_tests_properties(PoolResourceTest/*.equality.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;57;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SynchronizedPoolResourceTest.threads.noArgs "/root/repo/_bench_build/tests/test_pool_resource" "--gtest_filter=SynchronizedPoolResourceTest.threads")
+set_tests_properties(SynchronizedPoolResourceTest.threads.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;57;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SizeClassPoolResourceTest.upstream_when_full.noArgs "/root/repo/_bench_build/tests/test_pool_resource" "--gtest_filter=SizeClassPoolResourceTest.upstream_when_full")
+set_tests_properties(SizeClassPoolResourceTest.upstream_when_full.noArgs PROPERTIES  _BACKTRACE_TRIPLES "/usr/share/cmake-3.25/Modules/GoogleTest.cmake;402;add_test;/root/repo/tests/CMakeLists.txt;57;gtest_add_tests;/root/repo/tests/CMakeLists.txt;0;")
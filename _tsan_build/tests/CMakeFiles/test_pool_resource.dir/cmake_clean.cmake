@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_pool_resource.dir/pool_resource_test.cc.o"
+  "CMakeFiles/test_pool_resource.dir/pool_resource_test.cc.o.d"
+  "test_pool_resource"
+  "test_pool_resource.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_pool_resource.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
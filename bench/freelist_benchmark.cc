@@ -0,0 +1,410 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Benchmarks of FreeList against other allocation strategies.
+//
+// Run with --benchmark_filter to select pools or patterns, for example:
+//   bench_freelist --benchmark_filter='BM_AllocFreeBatch<.*Bytes<8>'
+
+#include <freelist/freelist.h>
+#include <freelist/pool_resource.h>
+#include <freelist/sharded_freelist.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Item of a given size in bytes
+template <size_t N>
+struct Bytes {
+  uint64_t data[N / sizeof(uint64_t)];
+};
+
+constexpr uint64_t kPoolBytes = 1 << 22;
+
+// For working sets larger than the caches
+constexpr uint64_t kLargePoolBytes = 1 << 26;
+
+const int kMaxThreads =
+    static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+// Each pool provides T* alloc() and void free(T*), constructing and destroying
+// the item like FreeList does.
+
+template <typename T, uint64_t Size = kPoolBytes,
+          typename Options = freelist::FreeListOptions>
+class FreeListPool {
+ public:
+  using value_type = T;
+  T* alloc() { return fl->alloc(); }
+  void free(T* t) { fl->free(t); }
+
+ private:
+  using FreeListType = freelist::FreeList<T, Size, Options>;
+  std::unique_ptr<FreeListType> fl{new FreeListType()};
+};
+
+template <typename T>
+using SingleThreadedFreeListPool =
+    FreeListPool<T, kPoolBytes, freelist::SingleThreaded>;
+
+struct EliminationOptions : freelist::FreeListOptions {
+  static constexpr std::size_t kEliminationSlots = 8;
+};
+
+template <typename T>
+using EliminationFreeListPool = FreeListPool<T, kPoolBytes, EliminationOptions>;
+
+struct PrefetchOptions : freelist::FreeListOptions {
+  static constexpr bool kPrefetch = true;
+};
+
+template <typename T>
+using LargeFreeListPool = FreeListPool<T, kLargePoolBytes>;
+
+// Options::kPrefetch, allocating with alloc()
+template <typename T>
+using PrefetchFreeListPool = FreeListPool<T, kLargePoolBytes, PrefetchOptions>;
+
+// Allocates with alloc_prefetched(), which also warms the next element
+template <typename T>
+class AllocPrefetchedFreeListPool {
+ public:
+  using value_type = T;
+  T* alloc() { return fl->alloc_prefetched(); }
+  void free(T* t) { fl->free(t); }
+
+ private:
+  using FreeListType =
+      freelist::FreeList<T, kLargePoolBytes, PrefetchOptions>;
+  std::unique_ptr<FreeListType> fl{new FreeListType()};
+};
+
+// One shard per group of CPUs, so that threads on different CPUs mostly use
+// different shards even on a single NUMA node
+template <typename T>
+class ShardedFreeListPool {
+ public:
+  using value_type = T;
+  T* alloc() { return fl.alloc(); }
+  void free(T* t) { fl.free(t); }
+
+ private:
+  freelist::ShardedFreeList<T, kPoolBytes, 4> fl{&freelist::thread_cpu};
+};
+
+template <typename T>
+class NewDeletePool {
+ public:
+  using value_type = T;
+  T* alloc() { return new T(); }
+  void free(T* t) { delete t; }
+};
+
+template <typename T, typename Resource>
+class PmrPool {
+ public:
+  using value_type = T;
+  T* alloc() { return new (resource.allocate(sizeof(T), alignof(T))) T(); }
+  void free(T* t) {
+    t->~T();
+    resource.deallocate(t, sizeof(T), alignof(T));
+  }
+
+ private:
+  Resource resource;
+};
+
+template <typename T>
+using UnsynchronizedPmrPool =
+    PmrPool<T, std::pmr::unsynchronized_pool_resource>;
+
+template <typename T>
+using SynchronizedPmrPool = PmrPool<T, std::pmr::synchronized_pool_resource>;
+
+template <typename T>
+using FreeListPmrPool = PmrPool<T, freelist::pool_resource>;
+
+template <typename T>
+using UnsynchronizedFreeListPmrPool =
+    PmrPool<T, freelist::unsynchronized_pool_resource>;
+
+// Fixed-capacity stack of free items, guarded by a mutex
+template <typename T>
+class MutexStackPool {
+ public:
+  using value_type = T;
+
+  MutexStackPool() : storage(new Storage[kCapacity]) {
+    freeItems.reserve(kCapacity);
+    for (size_t i = kCapacity; i > 0; --i) {
+      freeItems.push_back(reinterpret_cast<T*>(&storage[i - 1]));
+    }
+  }
+
+  T* alloc() {
+    T* t;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (freeItems.empty()) throw std::bad_alloc();
+      t = freeItems.back();
+      freeItems.pop_back();
+    }
+    return new (t) T();
+  }
+
+  void free(T* t) {
+    t->~T();
+    std::lock_guard<std::mutex> lock(mutex);
+    freeItems.push_back(t);
+  }
+
+ private:
+  using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+  static constexpr size_t kCapacity = kPoolBytes / sizeof(T);
+
+  std::unique_ptr<Storage[]> storage;
+  std::vector<T*> freeItems;
+  std::mutex mutex;
+};
+
+// One pool of each type, shared by all threads of a benchmark
+template <typename Pool>
+Pool& shared_pool() {
+  static Pool pool;
+  return pool;
+}
+
+// Value at the given quantile, reorders samples
+double percentile(std::vector<int64_t>& samples, double quantile) {
+  if (samples.empty()) return 0;
+  auto nth = samples.begin() + static_cast<ptrdiff_t>(
+                                   quantile * (samples.size() - 1));
+  std::nth_element(samples.begin(), nth, samples.end());
+  return static_cast<double>(*nth);
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Allocate and immediately free one item
+template <typename Pool>
+void BM_AllocFree(benchmark::State& state) {
+  Pool& pool = shared_pool<Pool>();
+  for (auto _ : state) {
+    auto* t = pool.alloc();
+    benchmark::DoNotOptimize(t);
+    pool.free(t);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Allocate a batch of items, then free them in allocation order, so that the
+// free list does not remain in address order
+template <typename Pool>
+void BM_AllocFreeBatch(benchmark::State& state) {
+  Pool& pool = shared_pool<Pool>();
+  std::vector<typename Pool::value_type*> items(state.range(0));
+  for (auto _ : state) {
+    for (auto& t : items) {
+      t = pool.alloc();
+      benchmark::DoNotOptimize(t);
+    }
+    for (auto t : items) {
+      pool.free(t);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Allocates a batch of items after freeing the previous batch in random
+// order, so that the free list visits elements in no particular order.
+// Only the allocations are timed.
+template <typename Pool>
+void BM_AllocShuffledBatch(benchmark::State& state) {
+  Pool& pool = shared_pool<Pool>();
+  std::vector<typename Pool::value_type*> items(state.range(0));
+  for (auto& t : items) t = pool.alloc();
+  std::mt19937 rng(1);
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::shuffle(items.begin(), items.end(), rng);
+    for (auto t : items) pool.free(t);
+    state.ResumeTiming();
+    for (auto& t : items) {
+      t = pool.alloc();
+      benchmark::DoNotOptimize(t);
+    }
+  }
+  for (auto t : items) pool.free(t);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// As BM_AllocFreeBatch, timing each operation to report its distribution.
+// Times include the overhead of reading the clock.
+template <typename Pool>
+void BM_Latency(benchmark::State& state) {
+  using Clock = std::chrono::steady_clock;
+  Pool& pool = shared_pool<Pool>();
+  std::vector<typename Pool::value_type*> items(state.range(0));
+  std::vector<int64_t> allocNs, freeNs;
+
+  for (auto _ : state) {
+    for (auto& t : items) {
+      auto start = Clock::now();
+      t = pool.alloc();
+      auto end = Clock::now();
+      benchmark::DoNotOptimize(t);
+      allocNs.push_back(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+              .count());
+    }
+    for (auto t : items) {
+      auto start = Clock::now();
+      pool.free(t);
+      auto end = Clock::now();
+      freeNs.push_back(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+              .count());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+
+  using benchmark::Counter;
+  state.counters["alloc_p50_ns"] =
+      Counter(percentile(allocNs, 0.5), Counter::kAvgThreads);
+  state.counters["alloc_p99_ns"] =
+      Counter(percentile(allocNs, 0.99), Counter::kAvgThreads);
+  state.counters["alloc_p999_ns"] =
+      Counter(percentile(allocNs, 0.999), Counter::kAvgThreads);
+  state.counters["free_p50_ns"] =
+      Counter(percentile(freeNs, 0.5), Counter::kAvgThreads);
+  state.counters["free_p99_ns"] =
+      Counter(percentile(freeNs, 0.99), Counter::kAvgThreads);
+  state.counters["free_p999_ns"] =
+      Counter(percentile(freeNs, 0.999), Counter::kAvgThreads);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Single thread, against other allocators
+
+#define SINGLE_THREAD_BENCHMARKS(T)                                    \
+  BENCHMARK_TEMPLATE(BM_AllocFree, FreeListPool<T>);                   \
+  BENCHMARK_TEMPLATE(BM_AllocFree, SingleThreadedFreeListPool<T>);     \
+  BENCHMARK_TEMPLATE(BM_AllocFree, NewDeletePool<T>);                  \
+  BENCHMARK_TEMPLATE(BM_AllocFree, UnsynchronizedPmrPool<T>);          \
+  BENCHMARK_TEMPLATE(BM_AllocFree, MutexStackPool<T>);                 \
+  BENCHMARK_TEMPLATE(BM_AllocFree, UnsynchronizedFreeListPmrPool<T>);  \
+  BENCHMARK_TEMPLATE(BM_AllocFreeBatch, FreeListPool<T>)->Arg(64);     \
+  BENCHMARK_TEMPLATE(BM_AllocFreeBatch, SingleThreadedFreeListPool<T>) \
+      ->Arg(64);                                                       \
+  BENCHMARK_TEMPLATE(BM_AllocFreeBatch, NewDeletePool<T>)->Arg(64);    \
+  BENCHMARK_TEMPLATE(BM_AllocFreeBatch, UnsynchronizedPmrPool<T>)      \
+      ->Arg(64);                                                       \
+  BENCHMARK_TEMPLATE(BM_AllocFreeBatch, MutexStackPool<T>)->Arg(64);
+
+SINGLE_THREAD_BENCHMARKS(Bytes<8>)
+SINGLE_THREAD_BENCHMARKS(Bytes<64>)
+SINGLE_THREAD_BENCHMARKS(Bytes<256>)
+
+// Thread scaling and tail latency under contention, with thread-safe pools
+
+#define THREAD_BENCHMARKS(Pool)               \
+  BENCHMARK_TEMPLATE(BM_AllocFreeBatch, Pool) \
+      ->Arg(64)                               \
+      ->ThreadRange(1, kMaxThreads)           \
+      ->UseRealTime();                        \
+  BENCHMARK_TEMPLATE(BM_Latency, Pool)->Arg(64)->ThreadRange(1, kMaxThreads);
+
+THREAD_BENCHMARKS(FreeListPool<Bytes<8>>)
+THREAD_BENCHMARKS(EliminationFreeListPool<Bytes<8>>)
+THREAD_BENCHMARKS(ShardedFreeListPool<Bytes<8>>)
+THREAD_BENCHMARKS(NewDeletePool<Bytes<8>>)
+THREAD_BENCHMARKS(SynchronizedPmrPool<Bytes<8>>)
+THREAD_BENCHMARKS(FreeListPmrPool<Bytes<8>>)
+THREAD_BENCHMARKS(MutexStackPool<Bytes<8>>)
+
+// Elimination against the plain free list with fixed thread counts, so that
+// threads contend even on machines with few CPUs. Batches of one item make
+// threads alternate between alloc and free, which elimination pairs.
+
+#define ELIMINATION_BENCHMARKS(Pool)          \
+  BENCHMARK_TEMPLATE(BM_AllocFreeBatch, Pool) \
+      ->Arg(1)                                \
+      ->Threads(2)                            \
+      ->Threads(4)                            \
+      ->Threads(16)                           \
+      ->UseRealTime();
+
+ELIMINATION_BENCHMARKS(FreeListPool<Bytes<8>>)
+ELIMINATION_BENCHMARKS(EliminationFreeListPool<Bytes<8>>)
+
+// Index widths: uint8_t, uint16_t and uint32_t. A uint64_t index requires a
+// pool of more than 16 GiB, so is not benchmarked. The uint8_t pool holds 30
+// items, too few to share between threads.
+
+BENCHMARK_TEMPLATE(BM_AllocFreeBatch, FreeListPool<Bytes<8>, 248>)->Arg(16);
+BENCHMARK_TEMPLATE(BM_AllocFreeBatch, FreeListPool<Bytes<8>, 131064>)
+    ->Arg(16);
+BENCHMARK_TEMPLATE(BM_AllocFreeBatch, FreeListPool<Bytes<8>, kPoolBytes>)
+    ->Arg(16);
+BENCHMARK_TEMPLATE(BM_AllocFreeBatch, FreeListPool<Bytes<8>, 131064>)
+    ->Arg(16)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+// Prefetching, with batches of 32 MiB, larger than L2. With frees in order,
+// elements are allocated in address order, which the hardware prefetcher
+// covers, so prefetching only adds work. With shuffled frees, each index in
+// the free list is a cache miss, which kPrefetch overlaps with the previous
+// allocation.
+
+#define PREFETCH_BENCHMARKS(T, N)                                              \
+  BENCHMARK_TEMPLATE(BM_AllocFreeBatch, LargeFreeListPool<T>)->Arg(N);         \
+  BENCHMARK_TEMPLATE(BM_AllocFreeBatch, PrefetchFreeListPool<T>)->Arg(N);      \
+  BENCHMARK_TEMPLATE(BM_AllocFreeBatch, AllocPrefetchedFreeListPool<T>)        \
+      ->Arg(N);                                                                \
+  BENCHMARK_TEMPLATE(BM_AllocShuffledBatch, LargeFreeListPool<T>)->Arg(N);     \
+  BENCHMARK_TEMPLATE(BM_AllocShuffledBatch, PrefetchFreeListPool<T>)->Arg(N);  \
+  BENCHMARK_TEMPLATE(BM_AllocShuffledBatch, AllocPrefetchedFreeListPool<T>)    \
+      ->Arg(N);
+
+PREFETCH_BENCHMARKS(Bytes<64>, 1 << 19)
+PREFETCH_BENCHMARKS(Bytes<128>, 1 << 18)
+
+BENCHMARK_MAIN();
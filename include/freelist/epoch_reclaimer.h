@@ -0,0 +1,372 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef INCLUDE_FREELIST_EPOCH_RECLAIMER_H_
+#define INCLUDE_FREELIST_EPOCH_RECLAIMER_H_
+
+#include <freelist/freelist.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace freelist {
+
+/**
+ * Epoch-based reclamation for items of a FreeList that are read without
+ * locks. A thread that unlinks an item from a concurrent data structure
+ * retires it instead of freeing it; the item is destroyed and returned to
+ * the FreeList only once no reader can still hold a pointer to it.
+ *
+ * Each thread that reads or retires items owns a Participant, and reads
+ * items only inside a critical section, marked by a Guard. The reclaimer
+ * keeps a global epoch, which advances once every thread inside a critical
+ * section has seen the current epoch. An item retired in epoch e is
+ * unreachable for every critical section that starts in epoch e + 1 or
+ * later, so it can be reclaimed once the epoch reaches e + 2.
+ *
+ * Retired items are kept by their Participant in one batch per epoch, and
+ * each batch is returned to the FreeList with a single atomic update (see
+ * FreeList::pop_indices). A thread that stays inside a critical section
+ * holds back reclamation by all threads, so critical sections should be
+ * short.
+ *
+ * All Participants must be destroyed before the EpochReclaimer, and the
+ * EpochReclaimer before the parent FreeList.
+ *
+ * @tparam FreeListType Type of the parent FreeList.
+ * @tparam MaxThreads Maximum number of Participants at any time.
+ * @tparam BatchSize Number of items retired in one epoch by one Participant
+ * after which it tries to reclaim.
+ */
+template <typename FreeListType, std::size_t MaxThreads = 64,
+          std::size_t BatchSize = 64>
+class EpochReclaimer {
+ public:
+  static_assert(MaxThreads >= 1, "MaxThreads must be at least 1");
+  static_assert(BatchSize >= 1, "BatchSize must be at least 1");
+
+  using value_type = typename FreeListType::value_type;
+  using index_type = typename FreeListType::index_type;
+  using size_type = typename FreeListType::size_type;
+
+  class Participant;
+  class Guard;
+
+  /**
+   * Construct a reclaimer for items of the specified FreeList.
+   * @param parent FreeList to return reclaimed items to.
+   */
+  explicit EpochReclaimer(FreeListType& parent) : parent(parent) {}
+
+  EpochReclaimer(EpochReclaimer const&) = delete;
+  EpochReclaimer& operator=(EpochReclaimer const&) = delete;
+
+  /**
+   * Get the current global epoch.
+   * @return Current epoch.
+   */
+  uint64_t epoch() const noexcept {
+    return globalEpoch.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Advance the global epoch, if every thread inside a critical section has
+   * seen the current epoch.
+   * @return True if the epoch was advanced, by this or another thread.
+   */
+  inline bool try_advance() noexcept;
+
+ private:
+  // Reader state of one Participant, (epoch << 1) | 1 while inside a
+  // critical section, 0 otherwise
+  struct alignas(FreeListType::options_type::kCacheLineSize) Slot {
+    std::atomic<uint64_t> state{0};
+    std::atomic<bool> used{false};
+  };
+
+  FreeListType& parent;
+  std::atomic<uint64_t> globalEpoch{0};
+  Slot slots[MaxThreads];
+};
+
+/**
+ * Per-thread state for an EpochReclaimer. Like ThreadCache, a Participant
+ * must only be used by one thread at a time.
+ */
+template <typename FreeListType, std::size_t MaxThreads, std::size_t BatchSize>
+class EpochReclaimer<FreeListType, MaxThreads, BatchSize>::Participant {
+ public:
+  /**
+   * Register a thread with the reclaimer.
+   * @param domain Reclaimer to register with.
+   * @exception std::bad_alloc If MaxThreads Participants already exist, or
+   * the batches cannot be allocated.
+   */
+  inline explicit Participant(EpochReclaimer& domain);
+
+  Participant(Participant const&) = delete;
+  Participant& operator=(Participant const&) = delete;
+
+  /**
+   * Destructor, waits until all items retired by this Participant are
+   * reclaimed. Must not be called inside a critical section.
+   */
+  inline ~Participant() noexcept;
+
+  /**
+   * Enter a critical section, during which items read from the data
+   * structure will not be reclaimed. Critical sections may be nested.
+   * Prefer Guard to calling enter() and leave() directly.
+   */
+  inline void enter() noexcept;
+
+  /**
+   * Leave a critical section entered with enter().
+   */
+  inline void leave() noexcept;
+
+  /**
+   * Check if the thread is inside a critical section.
+   * @return True if inside a critical section.
+   */
+  bool active() const noexcept { return depth != 0; }
+
+  /**
+   * Retires an item that has been made unreachable for new readers: it is
+   * destroyed and removed from the FreeList once no critical section that
+   * could have read it remains. May be called inside or outside a critical
+   * section.
+   * @param item Pointer to item to retire.
+   * @exception std::bad_alloc If a batch grows past BatchSize, because a
+   * reader holds back reclamation, and cannot be extended. The item is then
+   * not retired.
+   */
+  inline void retire(value_type* item);
+
+  /**
+   * Tries to advance the epoch, and reclaims every batch of retired items
+   * that no reader can still access.
+   * @return Number of items reclaimed.
+   */
+  inline size_type reclaim() noexcept;
+
+  /**
+   * Waits until all items retired by this Participant are reclaimed. Must
+   * not be called inside a critical section.
+   */
+  inline void flush() noexcept;
+
+  /**
+   * Check the number of retired items not yet reclaimed.
+   * @return Number of retired items.
+   */
+  inline size_type size() const noexcept;
+
+ private:
+  // Items retired in one epoch
+  struct Batch {
+    uint64_t epoch{0};
+    std::vector<index_type> indexes;
+  };
+
+  // Destroys the items of a batch and returns them to the FreeList
+  inline size_type release(Batch& batch) noexcept;
+
+  EpochReclaimer& domain;
+  Slot* slot{nullptr};
+  std::size_t depth{0};
+  // Batches for the last three epochs, indexed by epoch % 3
+  Batch batches[3];
+};
+
+/**
+ * Critical section of a Participant, from construction to destruction.
+ */
+template <typename FreeListType, std::size_t MaxThreads, std::size_t BatchSize>
+class EpochReclaimer<FreeListType, MaxThreads, BatchSize>::Guard {
+ public:
+  /**
+   * Enter a critical section.
+   * @param participant Participant of the calling thread.
+   */
+  explicit Guard(Participant& participant) noexcept
+      : participant(participant) {
+    participant.enter();
+  }
+
+  Guard(Guard const&) = delete;
+  Guard& operator=(Guard const&) = delete;
+
+  /**
+   * Leave the critical section.
+   */
+  ~Guard() noexcept { participant.leave(); }
+
+ private:
+  Participant& participant;
+};
+
+template <typename FreeListType, std::size_t MaxThreads, std::size_t BatchSize>
+bool EpochReclaimer<FreeListType, MaxThreads,
+                    BatchSize>::try_advance() noexcept {
+  uint64_t current = globalEpoch.load(std::memory_order_relaxed);
+  // Pairs with the fence in Participant::enter(): either this sees the
+  // reader's state, or the reader sees everything unlinked before now
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  for (Slot const& s : slots) {
+    const uint64_t state = s.state.load(std::memory_order_acquire);
+    if ((state & 1) && (state >> 1) != current) {
+      return false;
+    }
+  }
+  globalEpoch.compare_exchange_strong(current, current + 1,
+                                      std::memory_order_acq_rel,
+                                      std::memory_order_relaxed);
+  return true;
+}
+
+template <typename FreeListType, std::size_t MaxThreads, std::size_t BatchSize>
+EpochReclaimer<FreeListType, MaxThreads, BatchSize>::Participant::Participant(
+    EpochReclaimer& domain)
+    : domain(domain) {
+  for (Batch& batch : batches) {
+    batch.indexes.reserve(BatchSize);
+  }
+  for (Slot& s : domain.slots) {
+    bool used = false;
+    if (!s.used.load(std::memory_order_relaxed) &&
+        s.used.compare_exchange_strong(used, true,
+                                       std::memory_order_acquire)) {
+      slot = &s;
+      return;
+    }
+  }
+  throw std::bad_alloc();
+}
+
+template <typename FreeListType, std::size_t MaxThreads, std::size_t BatchSize>
+EpochReclaimer<FreeListType, MaxThreads,
+               BatchSize>::Participant::~Participant() noexcept {
+  flush();
+  slot->used.store(false, std::memory_order_release);
+}
+
+template <typename FreeListType, std::size_t MaxThreads, std::size_t BatchSize>
+void EpochReclaimer<FreeListType, MaxThreads,
+                    BatchSize>::Participant::enter() noexcept {
+  if (depth++ == 0) {
+    const uint64_t e = domain.globalEpoch.load(std::memory_order_relaxed);
+    slot->state.store((e << 1) | 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
+template <typename FreeListType, std::size_t MaxThreads, std::size_t BatchSize>
+void EpochReclaimer<FreeListType, MaxThreads,
+                    BatchSize>::Participant::leave() noexcept {
+  assert(depth > 0);
+  if (--depth == 0) {
+    slot->state.store(0, std::memory_order_release);
+  }
+}
+
+template <typename FreeListType, std::size_t MaxThreads, std::size_t BatchSize>
+void EpochReclaimer<FreeListType, MaxThreads, BatchSize>::Participant::retire(
+    value_type* item) {
+  assert(item);
+  // The item was unlinked before now, so before the epoch read here
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const uint64_t e = domain.globalEpoch.load(std::memory_order_acquire);
+  Batch& batch = batches[e % 3];
+  if (batch.epoch != e) {
+    // Retired three or more epochs ago, so no reader remains
+    release(batch);
+    batch.epoch = e;
+  }
+  batch.indexes.push_back(domain.parent.index(item));
+  if (batch.indexes.size() >= BatchSize) {
+    reclaim();
+  }
+}
+
+template <typename FreeListType, std::size_t MaxThreads, std::size_t BatchSize>
+typename EpochReclaimer<FreeListType, MaxThreads, BatchSize>::size_type
+EpochReclaimer<FreeListType, MaxThreads,
+               BatchSize>::Participant::reclaim() noexcept {
+  domain.try_advance();
+  const uint64_t e = domain.epoch();
+  size_type n = 0;
+  for (Batch& batch : batches) {
+    if (batch.epoch + 2 <= e) {
+      n += release(batch);
+    }
+  }
+  return n;
+}
+
+template <typename FreeListType, std::size_t MaxThreads, std::size_t BatchSize>
+void EpochReclaimer<FreeListType, MaxThreads,
+                    BatchSize>::Participant::flush() noexcept {
+  assert(!active());
+  reclaim();
+  while (size()) {
+    std::this_thread::yield();
+    reclaim();
+  }
+}
+
+template <typename FreeListType, std::size_t MaxThreads, std::size_t BatchSize>
+typename EpochReclaimer<FreeListType, MaxThreads, BatchSize>::size_type
+EpochReclaimer<FreeListType, MaxThreads,
+               BatchSize>::Participant::size() const noexcept {
+  size_type n = 0;
+  for (Batch const& batch : batches) {
+    n += batch.indexes.size();
+  }
+  return n;
+}
+
+template <typename FreeListType, std::size_t MaxThreads, std::size_t BatchSize>
+typename EpochReclaimer<FreeListType, MaxThreads, BatchSize>::size_type
+EpochReclaimer<FreeListType, MaxThreads, BatchSize>::Participant::release(
+    Batch& batch) noexcept {
+  const size_type n = batch.indexes.size();
+  if (n) {
+    for (index_type index : batch.indexes) {
+      // placement-delete the item
+      domain.parent.get(index)->~value_type();
+    }
+    domain.parent.pop_indices(batch.indexes.data(), n);
+    batch.indexes.clear();
+  }
+  return n;
+}
+
+}  // namespace freelist
+
+#endif  // INCLUDE_FREELIST_EPOCH_RECLAIMER_H_
@@ -28,466 +28,3316 @@
 
 #include <atomic>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
 #include <type_traits>
 #include <utility>
 
-namespace freelist {
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
 
-template <typename T, uint64_t Size>
-class FreeListAllocator;
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace freelist {
 
 /**
- * FreeList allows random allocation and deletion of items of a fixed type,
- * without the need for dynamic memory allocation.
- *
- * FreeList is defined by the type to be stored and the number of bytes that
- * the FreeList should occupy.
- *
- * The alloc function constructs new items passing provided arguments to any
- * constructor. The free function destructs items.
+ * Compile-time options for FreeList. To change options, derive from this
+ * struct and hide the members to change, for example:
  *
- * @tparam T Data type to store.
- * @tparam Size Total number of bytes for this FreeList: sizeof(*this) == Size.
+ *     struct AlignedOptions : freelist::FreeListOptions {
+ *       static constexpr bool kCacheLineAligned = true;
+ *     };
+ *     freelist::FreeList<double, 4096, AlignedOptions> fl;
  */
-template <typename T, uint64_t Size>
-class FreeList {
- public:
-  static_assert(!std::is_abstract<T>::value,
-                "Stored data type must not be abstract");
-
+struct FreeListOptions {
   /**
-   * Type that is stored in each active element.
+   * Place the control words on their own cache line, so that updates to them
+   * do not invalidate the cache lines of the first few items. The FreeList is
+   * then aligned to kCacheLineSize, Size must be a multiple of kCacheLineSize,
+   * and up to kCacheLineSize bytes are used for the control words, reducing
+   * the capacity; sizeof(FreeList) == Size still holds. Note that before
+   * C++17, new does not respect the alignment of over-aligned types.
    */
-  using value_type = T;
-
-  using this_type = FreeList<T, Size>;
+  static constexpr bool kCacheLineAligned = false;
 
   /**
-   * Type used for storing indexes. Set to an unsigned integer large enough to
-   * store all indexes.
+   * Size of a cache line (or of the destructive interference block) in bytes.
    */
-  using index_type = typename std::conditional<
-      Size <= std::numeric_limits<uint8_t>::max(), uint8_t,
-      typename std::conditional<
-          (Size / 2) <= std::numeric_limits<uint16_t>::max(), uint16_t,
-          typename std::conditional<(Size / 4) <=
-                                        std::numeric_limits<uint32_t>::max(),
-                                    uint32_t, uint64_t>::type>::type>::type;
-
-  using size_type = uint64_t;
+  static constexpr std::size_t kCacheLineSize = 64;
 
   /**
-   * Type of function used to free items.
+   * Use atomic operations, so that the FreeList may be used concurrently by
+   * multiple threads. If false, the FreeList must only be used by one thread
+   * at a time, and plain loads and stores are used instead.
    */
-  using Deleter = std::function<void(T*)>;
+  static constexpr bool kThreadSafe = true;
 
   /**
-   * Type of std::unique_ptr returned by make_unique.
+   * Keep one bit per element, set while the element is active, so that
+   * for_each_live(), clear(), is_live(), count_live() and find_live() scan
+   * the bitmap a word at a time instead of following the free list. Each
+   * allocation and free also updates the bitmap, with an atomic update if
+   * kThreadSafe. The bitmap is stored in the first elements, reducing the
+   * capacity by up to one bit per element, and Size must be a multiple of 8.
    */
-  using UniquePtr = std::unique_ptr<T, Deleter>;
+  static constexpr bool kOccupancyBitmap = false;
 
   /**
-   * Type of an allocator created from this FreeList.
+   * Allocate the free element with the lowest index, instead of the most
+   * recently freed one, so that active items stay packed at the start of the
+   * FreeList after churn. Also enables alloc_near(). Requires
+   * kOccupancyBitmap: the bitmap replaces the free list, and allocation
+   * searches it for a clear bit, starting from the lowest word that may have
+   * one. reserve_fresh() fails if it races with an allocation.
    */
-  using Allocator = FreeListAllocator<T, Size>;
+  static constexpr bool kAddressOrdered = false;
 
   /**
-   * Construct an empty FreeList.
+   * Keep a 32-bit generation counter per element, incremented each time the
+   * element is freed, enabling handle() and try_get(). The counters are
+   * stored in the first elements, reducing the capacity by 4 bytes per
+   * element, and each free also increments a counter.
    */
-  inline FreeList();
+  static constexpr bool kGenerations = false;
 
   /**
-   * Destructor, calls delete on all existing items.
+   * Record allocation, free and failure counts, a histogram of
+   * compare-and-swap retries, and peak occupancy, returned by snapshot().
+   * The counters are spread over several cache lines, chosen by thread, so
+   * that recording does not add contention. They are stored in the first
+   * elements, reducing the capacity, and Size must be a multiple of
+   * kCacheLineSize.
    */
-  inline ~FreeList() noexcept;
+  static constexpr bool kStats = false;
 
   /**
-   * Check if the FreeList is empty.
-   * @return True if the FreeList contains no items.
+   * Number of elimination slots, or 0 for none. When an update of the head of
+   * the free list fails because of contention, the thread backs off
+   * exponentially, and a thread freeing one item and a thread allocating one
+   * try to meet in a slot: the freed element is handed over directly, without
+   * updating the free list. This helps when many threads allocate and free
+   * at similar rates. Each slot takes one cache line of the first elements,
+   * and Size must be a multiple of kCacheLineSize. Ignored if not
+   * kThreadSafe.
+   *
+   * Experimental, and off by default: no gain has been measured yet. Each
+   * failed compare-and-swap of a single alloc or free also scans the slots,
+   * so measure with the elimination benchmarks on the target machine before
+   * enabling it.
    */
-  inline bool empty() const noexcept;
+  static constexpr std::size_t kEliminationSlots = 0;
 
   /**
-   * Check if the FreeList is full.
-   * @return True if the FreeList is full.
+   * Unsigned integer type of the indexes stored in free elements, or void to
+   * choose one from Size alone, assuming elements no larger than the index.
+   * When T is larger than that, a narrower type may still hold every index
+   * (checked with static_assert), making the control words smaller: for
+   * example, a FreeList of 2^15 doubles has a uint32_t index by default, but
+   * fits a uint16_t index with a 4-byte head word.
    */
-  inline bool full() const noexcept;
+  using IndexType = void;
 
   /**
-   * Check the number of active items in the FreeList.
-   * @return Number of active items in the FreeList.
+   * Unsigned integer type of the head word, which packs the index of the
+   * first free element in its low bits and an ABA tag in the remaining bits,
+   * or void for twice the width of IndexType, at most 8 bytes. The tag must
+   * have at least 8 bits. For example, a uint32_t head word holds indexes of
+   * up to 24 bits with an 8-bit tag, and a uint64_t head word holds them with
+   * a 40-bit tag; either needs no wider compare-and-swap than 8 bytes.
    */
-  inline index_type size() const noexcept;
+  using HeadType = void;
 
   /**
-   * Get the maximum number of items that can be stored.
-   * @return Maximum number of stored items.
+   * Unsigned integer type of the count of active items, or void for
+   * IndexType. Must hold the capacity (checked with static_assert).
    */
-  inline static index_type max_size() noexcept;
+  using CountType = void;
 
   /**
-   * Synonym for max_size()
+   * Prefetch the element after the head of the free list while taking the
+   * head, so that the next allocation does not wait for the cache miss on
+   * the index stored in it. Costs one prefetch instruction per allocation
+   * from the free list; has no effect on never-used elements, which the
+   * hardware prefetcher already handles.
+   *
+   * Worthwhile when items are freed in no particular order and the free
+   * list spans more memory than the caches: BM_AllocShuffledBatch allocates
+   * about 15% faster with it. When items are freed in address order, or the
+   * free list fits in cache, it gains nothing and may cost up to 10%.
    */
-  inline static index_type capacity() noexcept { return max_size(); }
+  static constexpr bool kPrefetch = false;
+};
 
-  /**
-   * Removes all items from the list, calling destructor for each.
-   */
-  inline void clear() noexcept;
+/**
+ * Options for a FreeList that is only used by one thread at a time.
+ */
+struct SingleThreaded : FreeListOptions {
+  static constexpr bool kThreadSafe = false;
+};
 
+/**
+ * Counters of a FreeList with FreeListOptions::kStats, see
+ * FreeList::snapshot(). Counts are of items, and cover the lifetime of the
+ * FreeList. With concurrent updates, the counters are not a consistent
+ * snapshot of a single moment.
+ */
+struct FreeListStats {
   /**
-   * Allocates a new item in the FreeList, and calls constructor.
-   * @tparam Args Type of arguments for item constructor.
-   * @param args Arguments to provide to item constructor.
-   * @return Pointer to new item.
-   * @exception std::bad_alloc If the freelist is full.
-   * @exception any Exceptions thrown by the constructor are forwarded.
-   * If any exception is thrown, the freelist state will be unchanged.
+   * Number of buckets of the retry histogram.
    */
-  template <typename... Args>
-  inline T* alloc(Args... args);
+  static constexpr std::size_t kRetryBuckets = 5;
 
   /**
-   * Synonym for alloc().
+   * Number of items allocated.
    */
-  template <typename... Args>
-  inline T* push(Args... args) {
-    return alloc(args...);
-  }
+  uint64_t allocs;
 
   /**
-   * Constructs item in the Freelist with arguments, and returns unique_ptr.
-   * @tparam Args Type of arguments for item constructor.
-   * @param args Arguments to provide to item constructor.
-   * @return unique_ptr to the item.
-   * @exception std::bad_alloc If the freelist is full.
-   * @exception any Exceptions thrown by the constructor are forwarded.
-   * If any exception is thrown, the freelist state will be unchanged.
+   * Number of items freed, including by clear().
    */
-  template <typename... Args>
-  inline UniquePtr make_unique(Args... args);
+  uint64_t frees;
 
   /**
-   * Constructs item in the Freelist with arguments, and returns shared_ptr.
-   * @tparam Args Type of arguments for item constructor.
-   * @param args Arguments to provide to item constructor.
-   * @return shared_ptr to the item.
-   * @exception std::bad_alloc If the freelist is full.
-   * @exception any Exceptions thrown by the constructor are forwarded.
-   * If any exception is thrown, the freelist state will be unchanged.
+   * Number of allocations that failed because the FreeList was full, each of
+   * which threw std::bad_alloc from alloc().
    */
-  template <typename... Args>
-  inline std::shared_ptr<T> make_shared(Args... args);
+  uint64_t failures;
 
   /**
-   * Deletes an item from the FreeList, and calls destructor.
-   * @param item Pointer to item to delete.
+   * Histogram of failed compare-and-swaps per operation, an operation being
+   * an allocation or free of one item or one batch. retries[0] counts
+   * operations without retries, retries[i] those with 2^(i-1) to 2^i - 1
+   * retries, and the last bucket also those with more.
    */
-  inline void free(T* item) noexcept;
+  uint64_t retries[kRetryBuckets];
 
   /**
-   * Synonym for free().
+   * Number of active items.
    */
-  inline void pop(T* item) noexcept { free(item); }
+  uint64_t size;
 
   /**
-   * Creates new item in the FreeList, does not call constructor.
-   * @return Index of new item, or 0 if full.
+   * Highest number of active items that was observed.
    */
-  inline index_type push_index() noexcept;
+  uint64_t peak_size;
 
   /**
-   * Removes item at specified index, does not call destructor.
-   * @param index Index of item to remove.
+   * Highest number of elements that were ever in use, whether active or
+   * since freed.
    */
-  inline void pop_index(index_type index) noexcept;
+  uint64_t peak_used;
 
   /**
-   * Get the index of the specified item.
-   * @param item Pointer of item to find.
-   * @return Index of the specified item.
+   * Maximum number of items, see FreeList::capacity().
    */
-  inline index_type index(T* item);
+  uint64_t capacity;
+};
 
-  /**
-   * Get the index of the specified item.
-   * @param item Pointer of item to find.
-   * @return Index of the specified item.
-   */
-  inline index_type index(T const* item) const;
+template <typename T, uint64_t Size, typename Options = FreeListOptions>
+class FreeList;
 
-  /**
-   * Convert an index into a pointer to the corresponding item.
-   * @param index Index of item to retrieve.
-   * @return Pointer to item.
-   */
-  inline T* get(index_type index);
+template <typename T, uint64_t Size, typename Options = FreeListOptions>
+class FreeListAllocator;
 
-  /**
-   * Convert an index into a pointer to the corresponding item, const version.
-   * @param index Index of item to retrieve.
-   * @return Pointer to item.
-   */
-  inline T const* get(index_type index) const;
+template <typename T, uint64_t Size, typename Options = FreeListOptions>
+class FreeListDeleter;
 
-  /**
-   * Returns a function to delete items from this freelist.
-   * @return Deleter function.
-   */
-  inline Deleter deleter() {
-    return std::bind(&FreeList::free, this, std::placeholders::_1);
+template <typename T, uint64_t Size, typename Options = FreeListOptions>
+class AlignedFreeListDeleter;
+
+template <typename T, typename Deleter>
+class SharedHandle;
+
+namespace detail {
+
+template <uint64_t Size, typename Options>
+class AllocatorState;
+
+template <typename T, uint64_t Size, typename Options, uint64_t Capacity>
+class ControlBlockAllocator;
+
+/**
+ * Allocate size bytes aligned to alignment, which must be a power of two.
+ * @return Pointer to the allocated memory, or nullptr on failure.
+ */
+inline void* aligned_allocate(std::size_t size, std::size_t alignment) {
+#if defined(_WIN32)
+  return _aligned_malloc(size, alignment);
+#else
+  void* ptr = nullptr;
+  if (posix_memalign(&ptr, alignment, size) != 0) {
+    return nullptr;
   }
+  return ptr;
+#endif
+}
 
-  inline Allocator allocator() { return Allocator(*this); }
+/**
+ * Free memory allocated by aligned_allocate.
+ */
+inline void aligned_deallocate(void* ptr) {
+#if defined(_WIN32)
+  _aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
 
- private:
-  union Element {
-    // Define empty constructor and destructor - defaults are ill-formed
-    Element() {}
-    ~Element() {}
+/**
+ * Number of bits required to represent the value v.
+ */
+constexpr uint32_t bit_width(uint64_t v) {
+  return v ? 1 + bit_width(v >> 1) : 0;
+}
 
-    T data;
-    index_type index;
-  };
+/**
+ * Round v up to a multiple of alignment.
+ */
+constexpr uint64_t round_up(uint64_t v, uint64_t alignment) {
+  return (v + alignment - 1) / alignment * alignment;
+}
 
-  struct ControlFlags {
-    ControlFlags() = default;
-    ControlFlags(ControlFlags const& other) = default;
-    ~ControlFlags() = default;
+/**
+ * Compile-time sequence of indexes, as std::index_sequence in C++14.
+ */
+template <std::size_t... I>
+struct index_sequence {};
 
-    index_type next{0};
-    index_type count{0};
-    index_type free{0};
-    index_type tag{0};
-  };
+template <typename First, typename Second>
+struct concat_index_sequence;
 
-  static constexpr uint64_t kElementSize = sizeof(Element);
+template <std::size_t... I, std::size_t... J>
+struct concat_index_sequence<index_sequence<I...>, index_sequence<J...>> {
+  using type = index_sequence<I..., (sizeof...(I) + J)...>;
+};
 
-  static constexpr index_type kIndexCount = Size / kElementSize;
+/**
+ * make_index_sequence<N>::type is index_sequence<0, ..., N - 1>. Built by
+ * halving, so that long sequences do not exceed the template depth limit.
+ */
+template <std::size_t N>
+struct make_index_sequence
+    : concat_index_sequence<typename make_index_sequence<N / 2>::type,
+                            typename make_index_sequence<N - N / 2>::type> {
+};
 
-  union _data {
-    // Define empty constructor and destructor - defaults are ill-formed
-    _data() {}
-    ~_data() {}
+template <>
+struct make_index_sequence<0> {
+  using type = index_sequence<>;
+};
 
-    std::atomic<ControlFlags> control;
-    Element elements[kIndexCount];
-  } data;
+template <>
+struct make_index_sequence<1> {
+  using type = index_sequence<0>;
+};
 
-  static constexpr index_type kElementOverheadCount =
-      (sizeof(data.control) + kElementSize - 1) / kElementSize;
+/**
+ * Whether std::atomic of an integer type of the given size is always
+ * lock-free. Equivalent to std::atomic<T>::is_always_lock_free in C++17.
+ */
+template <std::size_t Bytes>
+struct is_always_lock_free : std::false_type {};
+template <>
+struct is_always_lock_free<1>
+    : std::integral_constant<bool, ATOMIC_CHAR_LOCK_FREE == 2> {};
+template <>
+struct is_always_lock_free<2>
+    : std::integral_constant<bool, ATOMIC_SHORT_LOCK_FREE == 2> {};
+template <>
+struct is_always_lock_free<4>
+    : std::integral_constant<bool, ATOMIC_INT_LOCK_FREE == 2> {};
+template <>
+struct is_always_lock_free<8>
+    : std::integral_constant<bool, ATOMIC_LLONG_LOCK_FREE == 2> {};
 
-  static_assert(alignof(data.control) < sizeof(T) ||
-                    Size % alignof(data.control) == 0 ||
-                    sizeof(index_type) != 1,
-                "Size must be a multiple of 4 (for Size <= 256)");
-  static_assert(alignof(data.control) < sizeof(T) ||
-                    Size % alignof(data.control) == 0 ||
-                    sizeof(index_type) != 2,
-                "Size must be a multiple of 8 (for Size <= 131072)");
-  static_assert(alignof(data.control) < sizeof(T) ||
-                    Size % alignof(data.control) == 0 ||
-                    sizeof(index_type) != 4,
-                "Size must be a multiple of 16 (for Size <= 17179869184)");
-  static_assert(alignof(data.control) < sizeof(T) ||
-                    Size % alignof(data.control) == 0 ||
-                    sizeof(index_type) != 8,
-                "Size must be a multiple of 32 (for Size > 17179869184)");
+/**
+ * Drop-in replacement for std::atomic for objects with no concurrent access,
+ * all operations are plain loads and stores.
+ */
+template <typename T>
+class NonAtomic {
+ public:
+  T load(std::memory_order = std::memory_order_seq_cst) const noexcept {
+    return value;
+  }
 
-  static_assert(alignof(data.control) >= sizeof(T) || Size % alignof(T) == 0,
-                "Size must be a multiple of alignof(T)");
+  void store(T desired,
+             std::memory_order = std::memory_order_seq_cst) noexcept {
+    value = desired;
+  }
 
-  static_assert(kIndexCount > kElementOverheadCount,
-                "FreeList is too small to contain an element");
+  bool compare_exchange_weak(
+      T& expected, T desired,
+      std::memory_order = std::memory_order_seq_cst,
+      std::memory_order = std::memory_order_seq_cst) noexcept {
+    if (value == expected) {
+      value = desired;
+      return true;
+    }
+    expected = value;
+    return false;
+  }
+
+  bool compare_exchange_strong(
+      T& expected, T desired,
+      std::memory_order order = std::memory_order_seq_cst,
+      std::memory_order failure = std::memory_order_seq_cst) noexcept {
+    return compare_exchange_weak(expected, desired, order, failure);
+  }
+
+  T fetch_add(T arg, std::memory_order = std::memory_order_seq_cst) noexcept {
+    T result = value;
+    value += arg;
+    return result;
+  }
+
+  T fetch_sub(T arg, std::memory_order = std::memory_order_seq_cst) noexcept {
+    T result = value;
+    value -= arg;
+    return result;
+  }
+
+  T fetch_or(T arg, std::memory_order = std::memory_order_seq_cst) noexcept {
+    T result = value;
+    value |= arg;
+    return result;
+  }
+
+  T fetch_and(T arg, std::memory_order = std::memory_order_seq_cst) noexcept {
+    T result = value;
+    value &= arg;
+    return result;
+  }
+
+ private:
+  T value;
 };
 
-template <typename T, uint64_t Size>
-FreeList<T, Size>::FreeList() {
-  ControlFlags flags;
-  flags.next = kElementOverheadCount;
-  flags.count = 0;
-  flags.free = 0;
-  flags.tag = 0;
-  data.control.store(flags);
-}
+/**
+ * std::atomic<T> if ThreadSafe, otherwise NonAtomic<T>.
+ */
+template <typename T, bool ThreadSafe>
+using atomic_t = typename std::conditional<ThreadSafe, std::atomic<T>,
+                                           NonAtomic<T>>::type;
 
-template <typename T, uint64_t Size>
-FreeList<T, Size>::~FreeList() noexcept {
-  clear();
-}
+/**
+ * Element of a FreeList: either an active item, or the index of the next free
+ * element.
+ */
+template <typename T, typename IndexType>
+union FreeListElement {
+  // Define empty constructor and destructor - defaults are ill-formed
+  FreeListElement() {}
+  ~FreeListElement() {}
+
+  T data;
+  IndexType index;
+};
 
-template <typename T, uint64_t Size>
-bool FreeList<T, Size>::empty() const noexcept {
-  return data.control.load().count == 0;
+/**
+ * Index of the lowest set bit of v, which must be non-zero.
+ */
+inline uint32_t ctz64(uint64_t v) noexcept {
+  assert(v);
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<uint32_t>(__builtin_ctzll(v));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long i;
+  _BitScanForward64(&i, v);
+  return static_cast<uint32_t>(i);
+#else
+  uint32_t n = 0;
+  for (; !(v & 1); v >>= 1) ++n;
+  return n;
+#endif
 }
 
-template <typename T, uint64_t Size>
-bool FreeList<T, Size>::full() const noexcept {
-  return data.control.load().count >= max_size();
+/**
+ * Number of leading zero bits of v, which must be non-zero.
+ */
+inline uint32_t clz64(uint64_t v) noexcept {
+  assert(v);
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<uint32_t>(__builtin_clzll(v));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long i;
+  _BitScanReverse64(&i, v);
+  return static_cast<uint32_t>(63 - i);
+#else
+  uint32_t n = 0;
+  for (; !(v & (uint64_t(1) << 63)); v <<= 1) ++n;
+  return n;
+#endif
 }
 
-template <typename T, uint64_t Size>
-typename FreeList<T, Size>::index_type FreeList<T, Size>::size() const
-    noexcept {
-  return data.control.load().count;
+/**
+ * Number of set bits in v.
+ */
+inline uint32_t popcount64(uint64_t v) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<uint32_t>(__builtin_popcountll(v));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  return static_cast<uint32_t>(__popcnt64(v));
+#else
+  v = v - ((v >> 1) & 0x5555555555555555ULL);
+  v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+  v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return static_cast<uint32_t>((v * 0x0101010101010101ULL) >> 56);
+#endif
 }
 
-template <typename T, uint64_t Size>
-typename FreeList<T, Size>::index_type FreeList<T, Size>::max_size() noexcept {
-  return kIndexCount - kElementOverheadCount;
-}
+/**
+ * One bit per element of a FreeList, set while the element is active, see
+ * FreeListOptions::kOccupancyBitmap. set() and reset() may be called
+ * concurrently with each other and with the const queries, which then
+ * observe each bit as of some recent point. clear() and for_each() require
+ * exclusive access. Where AVX2 is available and ThreadSafe is false, find()
+ * and for_each() skip runs of empty words four at a time, and count() counts
+ * whole words four at a time. Thread-safe bitmaps always load one atomic word
+ * at a time, since a vector load of atomic words races with their updates.
+ * @tparam Bits Number of bits.
+ * @tparam ThreadSafe Use atomic updates.
+ */
+template <uint64_t Bits, bool ThreadSafe>
+class OccupancyBitmap {
+ public:
+  // Define empty constructor, the bits are initialised by clear()
+  OccupancyBitmap() {}
 
-template <typename T, uint64_t Size>
-void FreeList<T, Size>::clear() noexcept {
-  // TODO(dj): This could be improved by merge-sorting the free-linked-list
+  void clear() noexcept {
+    for (uint64_t w = 0; w < kWordCount; ++w) {
+      words[w].store(0, std::memory_order_relaxed);
+    }
+  }
 
-  // Traverse the free list to find already-freed items
-  bool itemIsFree[kIndexCount];
-  for (index_type i = kElementOverheadCount; i < kIndexCount; ++i) {
-    itemIsFree[i] = false;
+  void set(uint64_t i) noexcept {
+    assert(i < Bits);
+    words[i / 64].fetch_or(bit(i), std::memory_order_relaxed);
   }
 
-  ControlFlags currFlags = data.control.load(std::memory_order_relaxed);
-  while (currFlags.free != 0) {
-    itemIsFree[currFlags.free] = true;
-    currFlags.free = data.elements[currFlags.free].index;
+  void reset(uint64_t i) noexcept {
+    assert(i < Bits);
+    words[i / 64].fetch_and(~bit(i), std::memory_order_relaxed);
   }
 
-  // Delete all non-freed items up to next
-  for (index_type i = kElementOverheadCount; i < currFlags.next; ++i) {
-    if (!itemIsFree[i]) {
-      // Call destructor
-      data.elements[i].data.~T();
+  // Sets bits [first, first + n)
+  void set_range(uint64_t first, uint64_t n) noexcept {
+    assert(first + n <= Bits);
+    const uint64_t last = first + n;
+    for (uint64_t w = first / 64; first < last && w <= (last - 1) / 64; ++w) {
+      words[w].fetch_or(mask(w, first, last), std::memory_order_relaxed);
     }
   }
 
-  currFlags.free = 0;
-  currFlags.tag = 0;
-  currFlags.count = 0;
-  currFlags.next = kElementOverheadCount;
-  data.control.store(currFlags);
-}
+  bool test(uint64_t i) const noexcept {
+    assert(i < Bits);
+    return words[i / 64].load(std::memory_order_relaxed) & bit(i);
+  }
 
-template <typename T, uint64_t Size>
-template <typename... Args>
-T* FreeList<T, Size>::alloc(Args... args) {
-  index_type index = push_index();
-  if (!index) {
-    throw std::bad_alloc();
+  // Number of set bits in [first, last)
+  uint64_t count(uint64_t first, uint64_t last) const noexcept {
+    if (first >= last) return 0;
+    const uint64_t lastWord = (last - 1) / 64;
+    uint64_t w = first / 64;
+    uint64_t n = 0;
+#if defined(__AVX2__)
+    if (kVectorLoads && w < lastWord) {
+      n += popcount64(words[w].load(std::memory_order_relaxed) &
+                      mask(w, first, last));
+      // Count runs of four whole words before the last one with AVX2
+      n += popcount(&words[w + 1], (lastWord - w - 1) / 4);
+      w += 1 + (lastWord - w - 1) / 4 * 4;
+    }
+#endif
+    for (; w <= lastWord; ++w) {
+      n += popcount64(words[w].load(std::memory_order_relaxed) &
+                      mask(w, first, last));
+    }
+    return n;
   }
 
-  try {
-    // placement-new the item
-    return new (get(index)) T(args...);
-  } catch (...) {
-    pop_index(index);
-    throw;
+  // Lowest set bit in [first, last), or last if there is none
+  uint64_t find(uint64_t first, uint64_t last) const noexcept {
+    if (first >= last) return last;
+    const uint64_t lastWord = (last - 1) / 64;
+    for (uint64_t w = first / 64; w <= lastWord; ++w) {
+#if defined(__AVX2__)
+      // Skip runs of four empty words with one test
+      while (kVectorLoads && w + 3 <= lastWord && is_zero(&words[w])) w += 4;
+      if (w > lastWord) break;
+#endif
+      const uint64_t bits =
+          words[w].load(std::memory_order_relaxed) & mask(w, first, last);
+      if (bits) return w * 64 + ctz64(bits);
+    }
+    return last;
   }
-}
 
-template <typename T, uint64_t Size>
-template <typename... Args>
-typename FreeList<T, Size>::UniquePtr FreeList<T, Size>::make_unique(
-    Args... args) {
-  T* ptr = alloc(args...);
-  return UniquePtr(ptr, deleter());
-}
+  // Calls f(i) for each set bit i in [first, last), in increasing order
+  template <typename F>
+  void for_each(uint64_t first, uint64_t last, F&& f) const {
+    if (first >= last) return;
+    const uint64_t lastWord = (last - 1) / 64;
+    for (uint64_t w = first / 64; w <= lastWord; ++w) {
+#if defined(__AVX2__)
+      // Skip runs of four empty words with one test
+      while (kVectorLoads && w + 3 <= lastWord && is_zero(&words[w])) w += 4;
+      if (w > lastWord) break;
+#endif
+      uint64_t bits =
+          words[w].load(std::memory_order_relaxed) & mask(w, first, last);
+      for (; bits; bits &= bits - 1) {
+        f(w * 64 + ctz64(bits));
+      }
+    }
+  }
 
-template <typename T, uint64_t Size>
-template <typename... Args>
-std::shared_ptr<T> FreeList<T, Size>::make_shared(Args... args) {
-  return make_unique(args...);
-}
+ protected:
+  using word_type = atomic_t<uint64_t, ThreadSafe>;
 
-template <typename T, uint64_t Size>
-typename FreeList<T, Size>::index_type
-FreeList<T, Size>::push_index() noexcept {
-  // Read the free index
-  ControlFlags currFlags = data.control.load();
+  static constexpr uint64_t kWordCount = (Bits + 63) / 64;
 
-  do {
-    ControlFlags newFlags = currFlags;
-    if (currFlags.free) {
-      // While free is not zero, then there is a previously-freed item
+  static constexpr uint64_t bit(uint64_t i) noexcept {
+    return uint64_t(1) << (i % 64);
+  }
 
-      // Read the index stored at that element
-      newFlags.free = *reinterpret_cast<index_type*>(get(currFlags.free));
-      // Increment the tag to avoid the ABA problem
-      ++newFlags.tag;
-      // Creating a new item
-      ++newFlags.count;
+  // Bits of word w that lie within [first, last)
+  static uint64_t mask(uint64_t w, uint64_t first, uint64_t last) noexcept {
+    const uint64_t low = w * 64;
+    uint64_t result = ~uint64_t(0);
+    if (first > low) result &= ~uint64_t(0) << (first - low);
+    if (last < low + 64) result &= (uint64_t(1) << (last - low)) - 1;
+    return result;
+  }
 
-      if (data.control.compare_exchange_strong(currFlags, newFlags)) {
-        // Return the previously freed item
-        return currFlags.free;
-      }
-    } else if (currFlags.next < kIndexCount) {
-      // Increment the next
-      ++newFlags.next;
-      // Creating a new item
-      ++newFlags.count;
-
-      if (data.control.compare_exchange_strong(currFlags, newFlags)) {
-        // Return the pre-increment next index
-        return currFlags.next;
-      }
-    } else {
-      return 0;
+#if defined(__AVX2__)
+  // Whether words may be read four at a time, only without concurrent updates
+  static constexpr bool kVectorLoads = !ThreadSafe;
+
+  // Whether the four words starting at p are all zero
+  static bool is_zero(word_type const* p) noexcept {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    return _mm256_testz_si256(v, v);
+  }
+
+  // Number of set bits in the 4 * blocks words starting at p, counting the
+  // bits of each nibble with a table lookup
+  static uint64_t popcount(word_type const* p, uint64_t blocks) noexcept {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3,
+                                           2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3,
+                                           1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i total = _mm256_setzero_si256();
+    for (uint64_t b = 0; b < blocks; ++b, p += 4) {
+      const __m256i v =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+      const __m256i bytes = _mm256_add_epi8(
+          _mm256_shuffle_epi8(table, _mm256_and_si256(v, nibble)),
+          _mm256_shuffle_epi8(
+              table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble)));
+      total = _mm256_add_epi64(total,
+                               _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
     }
-  } while (1);
-}
+    return static_cast<uint64_t>(_mm256_extract_epi64(total, 0)) +
+           static_cast<uint64_t>(_mm256_extract_epi64(total, 1)) +
+           static_cast<uint64_t>(_mm256_extract_epi64(total, 2)) +
+           static_cast<uint64_t>(_mm256_extract_epi64(total, 3));
+  }
+#endif
 
-template <typename T, uint64_t Size>
-void FreeList<T, Size>::free(T* item) noexcept {
-  assert(item);
+  static_assert(sizeof(word_type) == sizeof(uint64_t),
+                "Bitmap words must have the size of uint64_t");
+
+  word_type words[kWordCount];
+};
+
+/**
+ * OccupancyBitmap from which elements are also allocated, see
+ * FreeListOptions::kAddressOrdered. A clear bit is a free element, which is
+ * taken by setting the bit with compare-and-swap, and returned by reset().
+ * @tparam Bits Number of bits.
+ * @tparam ThreadSafe Use atomic updates.
+ */
+template <uint64_t Bits, bool ThreadSafe>
+class OrderedOccupancyBitmap : public OccupancyBitmap<Bits, ThreadSafe> {
+  using Base = OccupancyBitmap<Bits, ThreadSafe>;
+
+ public:
+  void clear() noexcept {
+    Base::clear();
+    low.store(0, std::memory_order_relaxed);
+  }
+
+  // Clears bit i, publishing the element to the thread that next claims it
+  void reset(uint64_t i) noexcept {
+    assert(i < Bits);
+    words[i / 64].fetch_and(~bit(i), std::memory_order_release);
+    lower(i / 64);
+  }
+
+  // Sets the lowest clear bit in [first, last), returns it or last if none
+  uint64_t claim(uint64_t first, uint64_t last) noexcept {
+    const uint64_t firstWord = first / 64;
+    uint64_t start = low.load(std::memory_order_relaxed);
+    if (start < firstWord) start = firstWord;
+    uint64_t found = claim_lowest(start, first, last);
+    if (found == last && start > firstWord) {
+      // low may have been raised past a word just as an element was freed
+      found = claim_lowest(firstWord, first, last);
+    }
+    return found;
+  }
+
+  // Sets a clear bit in [first, last) close to hint: in the word of hint if
+  // possible, else in the nearest word with a clear bit. Returns it or last.
+  uint64_t claim_near(uint64_t hint, uint64_t first, uint64_t last) noexcept {
+    if (first >= last) return last;
+    if (hint < first) hint = first;
+    if (hint >= last) hint = last - 1;
+    const uint64_t firstWord = first / 64;
+    const uint64_t lastWord = (last - 1) / 64;
+    const uint64_t hintWord = hint / 64;
+    const uint64_t above = ~uint64_t(0) << (hint % 64);
+
+    // In the word of hint, prefer the first clear bit after hint
+    const auto nearest = [above](uint64_t clear) noexcept {
+      return (clear & above) ? lowest(clear & above) : highest(clear);
+    };
+    uint64_t found =
+        claim_in_word(hintWord, mask(hintWord, first, last), nearest);
+    for (uint64_t d = 1; found == kNone; ++d) {
+      const bool up = hintWord + d <= lastWord;
+      const bool down = hintWord >= firstWord + d;
+      if (!up && !down) return last;
+      if (up) {
+        found = claim_in_word(hintWord + d, mask(hintWord + d, first, last),
+                              lowest);
+      }
+      if (found == kNone && down) {
+        found = claim_in_word(hintWord - d, mask(hintWord - d, first, last),
+                              highest);
+      }
+    }
+    return found;
+  }
+
+  // Sets bits [first, first + n) if they are all clear
+  bool claim_range(uint64_t first, uint64_t n) noexcept {
+    assert(n && first + n <= Bits);
+    const uint64_t last = first + n;
+    for (uint64_t w = first / 64; w <= (last - 1) / 64; ++w) {
+      const uint64_t m = mask(w, first, last);
+      uint64_t bits = words[w].load(std::memory_order_relaxed);
+      do {
+        if (bits & m) {
+          // Another thread claimed an element, return the words taken so far
+          for (uint64_t u = first / 64; u < w; ++u) {
+            words[u].fetch_and(~mask(u, first, last),
+                               std::memory_order_relaxed);
+          }
+          return false;
+        }
+      } while (!words[w].compare_exchange_weak(bits, bits | m,
+                                               std::memory_order_acquire,
+                                               std::memory_order_relaxed));
+    }
+    return true;
+  }
+
+ private:
+  using Base::bit;
+  using Base::mask;
+  using Base::words;
+
+  static constexpr uint64_t kNone = ~uint64_t(0);
+
+  static uint64_t lowest(uint64_t v) noexcept { return v & (~v + 1); }
+  static uint64_t highest(uint64_t v) noexcept {
+    return uint64_t(1) << (63 - clz64(v));
+  }
+
+  // Sets the bit chosen by pick(clear) from the clear bits of word w within
+  // m, returns it or kNone if there is no such bit
+  template <typename Pick>
+  uint64_t claim_in_word(uint64_t w, uint64_t m, Pick pick) noexcept {
+    uint64_t bits = words[w].load(std::memory_order_relaxed);
+    while (const uint64_t clear = ~bits & m) {
+      const uint64_t b = pick(clear);
+      // Acquire, to see the element as it was when it was freed
+      if (words[w].compare_exchange_weak(bits, bits | b,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+        return w * 64 + ctz64(b);
+      }
+    }
+    return kNone;
+  }
+
+  // Sets the lowest clear bit in [first, last), searching from word start
+  uint64_t claim_lowest(uint64_t start, uint64_t first,
+                        uint64_t last) noexcept {
+    for (uint64_t w = start; first < last && w <= (last - 1) / 64; ++w) {
+      const uint64_t found = claim_in_word(w, mask(w, first, last), lowest);
+      if (found != kNone) return found;
+      // Word w is full, start later searches after it
+      uint64_t expected = w;
+      low.compare_exchange_strong(expected, w + 1, std::memory_order_relaxed);
+    }
+    return last;
+  }
+
+  // Lowers low to w, after a bit of word w was cleared
+  void lower(uint64_t w) noexcept {
+    uint64_t curr = low.load(std::memory_order_relaxed);
+    while (w < curr &&
+           !low.compare_exchange_weak(curr, w, std::memory_order_relaxed)) {
+    }
+  }
+
+  // No word below low has a clear bit, except briefly during a race
+  atomic_t<uint64_t, ThreadSafe> low;
+};
+
+/**
+ * Stand-in for OccupancyBitmap when FreeListOptions::kOccupancyBitmap is
+ * false, all updates do nothing.
+ */
+struct NoOccupancyBitmap {
+  void clear() noexcept {}
+  void set(uint64_t) noexcept {}
+  void reset(uint64_t) noexcept {}
+  void set_range(uint64_t, uint64_t) noexcept {}
+  uint64_t count(uint64_t, uint64_t) const noexcept { return 0; }
+};
+
+/**
+ * Generation counter for each element of a FreeList, incremented when the
+ * element is freed, see FreeListOptions::kGenerations. Incremented with
+ * release and loaded with acquire, so that a thread that observes a freed
+ * item's new generation also observes the free.
+ * @tparam Count Number of counters.
+ * @tparam ThreadSafe Use atomic updates.
+ */
+template <uint64_t Count, bool ThreadSafe>
+class GenerationCounters {
+ public:
+  // Define empty constructor, the counters are initialised by clear()
+  GenerationCounters() {}
+
+  void clear() noexcept {
+    for (uint64_t i = 0; i < Count; ++i) {
+      counters[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  uint32_t load(uint64_t i) const noexcept {
+    assert(i < Count);
+    return counters[i].load(std::memory_order_acquire);
+  }
+
+  void bump(uint64_t i) noexcept {
+    assert(i < Count);
+    counters[i].fetch_add(1, std::memory_order_release);
+  }
+
+  // Increments counters [first, last)
+  void bump_range(uint64_t first, uint64_t last) noexcept {
+    for (uint64_t i = first; i < last; ++i) {
+      bump(i);
+    }
+  }
+
+ private:
+  atomic_t<uint32_t, ThreadSafe> counters[Count];
+};
+
+/**
+ * Stand-in for GenerationCounters when FreeListOptions::kGenerations is
+ * false, all updates do nothing.
+ */
+struct NoGenerationCounters {
+  void clear() noexcept {}
+  void bump(uint64_t) noexcept {}
+  void bump_range(uint64_t, uint64_t) noexcept {}
+};
+
+/**
+ * Small number identifying the calling thread, assigned in order of first
+ * use, for spreading per-thread updates over shards.
+ */
+inline uint32_t thread_shard() noexcept {
+  static std::atomic<uint32_t> nextShard{0};
+  static thread_local const uint32_t shard =
+      nextShard.fetch_add(1, std::memory_order_relaxed);
+  return shard;
+}
+
+/**
+ * Counters of a FreeList, see FreeListOptions::kStats. Each thread updates
+ * one of several shards, each on its own cache line.
+ * @tparam ThreadSafe Use atomic updates, and more than one shard.
+ * @tparam CacheLineSize Size of a cache line in bytes.
+ */
+template <bool ThreadSafe, std::size_t CacheLineSize>
+class StatsCounters {
+ public:
+  // Define empty constructor, the counters are initialised by clear()
+  StatsCounters() {}
+
+  void clear() noexcept {
+    for (Shard& s : shards) {
+      s.allocs.store(0, std::memory_order_relaxed);
+      s.frees.store(0, std::memory_order_relaxed);
+      s.failures.store(0, std::memory_order_relaxed);
+      for (counter& c : s.retries) {
+        c.store(0, std::memory_order_relaxed);
+      }
+    }
+    peakSize.store(0, std::memory_order_relaxed);
+    peakUsed.store(0, std::memory_order_relaxed);
+  }
+
+  void record_alloc(uint64_t n, uint32_t retries) noexcept {
+    Shard& s = shard();
+    add(s.allocs, n);
+    add(s.retries[bucket(retries)], 1);
+  }
+
+  void record_failure(uint32_t retries) noexcept {
+    Shard& s = shard();
+    add(s.failures, 1);
+    add(s.retries[bucket(retries)], 1);
+  }
+
+  void record_free(uint64_t n, uint32_t retries) noexcept {
+    Shard& s = shard();
+    add(s.frees, n);
+    add(s.retries[bucket(retries)], 1);
+  }
+
+  void update_peak_size(uint64_t size) noexcept { raise(peakSize, size); }
+
+  void update_peak_used(uint64_t used) noexcept { raise(peakUsed, used); }
+
+  // Sums the shards into stats
+  void snapshot(FreeListStats& stats) const noexcept {
+    for (const Shard& s : shards) {
+      stats.allocs += s.allocs.load(std::memory_order_relaxed);
+      stats.frees += s.frees.load(std::memory_order_relaxed);
+      stats.failures += s.failures.load(std::memory_order_relaxed);
+      for (std::size_t i = 0; i < FreeListStats::kRetryBuckets; ++i) {
+        stats.retries[i] += s.retries[i].load(std::memory_order_relaxed);
+      }
+    }
+    stats.peak_size = peakSize.load(std::memory_order_relaxed);
+    stats.peak_used = peakUsed.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr std::size_t kShards = ThreadSafe ? 8 : 1;
+
+  using counter = atomic_t<uint64_t, ThreadSafe>;
+
+  struct alignas(CacheLineSize) Shard {
+    counter allocs;
+    counter frees;
+    counter failures;
+    counter retries[FreeListStats::kRetryBuckets];
+  };
+
+  static void add(counter& c, uint64_t n) noexcept {
+    c.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  static void raise(counter& c, uint64_t v) noexcept {
+    uint64_t curr = c.load(std::memory_order_relaxed);
+    while (v > curr &&
+           !c.compare_exchange_weak(curr, v, std::memory_order_relaxed)) {
+    }
+  }
+
+  static std::size_t bucket(uint32_t retries) noexcept {
+    const std::size_t b = bit_width(retries);
+    return b < FreeListStats::kRetryBuckets ? b
+                                            : FreeListStats::kRetryBuckets - 1;
+  }
+
+  Shard& shard() noexcept {
+    return shards[ThreadSafe ? thread_shard() % kShards : 0];
+  }
+
+  Shard shards[kShards];
+  // Peaks are updated rarely, so share a cache line
+  alignas(CacheLineSize) counter peakSize;
+  counter peakUsed;
+};
+
+/**
+ * Stand-in for StatsCounters when FreeListOptions::kStats is false, all
+ * updates do nothing.
+ */
+struct NoStatsCounters {
+  void clear() noexcept {}
+  void record_alloc(uint64_t, uint32_t) noexcept {}
+  void record_failure(uint32_t) noexcept {}
+  void record_free(uint64_t, uint32_t) noexcept {}
+  void update_peak_size(uint64_t) noexcept {}
+  void update_peak_used(uint64_t) noexcept {}
+};
+
+// Placement-new a T at ptr, constructor cannot throw
+template <typename T, typename Undo, typename... Args>
+inline T* construct(std::true_type, void* ptr, Undo&&,
+                    Args&&... args) noexcept {
+  return new (ptr) T(std::forward<Args>(args)...);
+}
+
+// Placement-new a T at ptr, calling undo() if the constructor throws
+template <typename T, typename Undo, typename... Args>
+inline T* construct(std::false_type, void* ptr, Undo&& undo, Args&&... args) {
+  try {
+    return new (ptr) T(std::forward<Args>(args)...);
+  } catch (...) {
+    undo();
+    throw;
+  }
+}
+
+/**
+ * Placement-new a T at ptr, forwarding args to the constructor. If the
+ * constructor throws, undo() is called and the exception rethrown. The
+ * try/catch is omitted if the constructor is noexcept.
+ */
+template <typename T, typename Undo, typename... Args>
+inline T* construct(void* ptr, Undo&& undo, Args&&... args) noexcept(
+    std::is_nothrow_constructible<T, Args&&...>::value) {
+  return construct<T>(
+      typename std::is_nothrow_constructible<T, Args&&...>::type(), ptr,
+      std::forward<Undo>(undo), std::forward<Args>(args)...);
+}
+
+/**
+ * Hint to the processor that the cache line at p will soon be read, or
+ * written if Write.
+ */
+template <bool Write = false>
+inline void prefetch(void const* p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(p, Write ? 1 : 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_prefetch(static_cast<char const*>(p), _MM_HINT_T0);
+#else
+  (void)p;
+#endif
+}
+
+/**
+ * Prefetches each cache line of [p, p + bytes) for writing.
+ */
+template <std::size_t LineSize>
+inline void prefetch_for_write(void const* p, std::size_t bytes) noexcept {
+  char const* line = static_cast<char const*>(p);
+  char const* const end = line + bytes;
+  for (; line < end; line += LineSize) prefetch<true>(line);
+}
+
+/**
+ * Hint to the processor that the caller is spinning.
+ */
+inline void cpu_relax() noexcept {
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+  __builtin_ia32_pause();
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_pause();
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * Slots through which a thread freeing an element can hand it directly to a
+ * thread allocating one, both having failed to update the head of the free
+ * list, as in the elimination-backoff stack of Hendler, Shavit and Yerushalmi.
+ * See FreeListOptions::kEliminationSlots. Each slot is on its own cache line
+ * and holds an offered index, or 0.
+ * @tparam IndexType Unsigned integer type used for indexes.
+ * @tparam Slots Number of slots.
+ * @tparam CacheLineSize Size of a cache line in bytes.
+ */
+template <typename IndexType, std::size_t Slots, std::size_t CacheLineSize>
+class EliminationArray {
+ public:
+  // Define empty constructor, the slots are initialised by clear()
+  EliminationArray() {}
+
+  void clear() noexcept {
+    for (Slot& s : slots) {
+      s.index.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // Takes an index offered in slot i, or returns 0 if there is none
+  IndexType take(uint32_t i) noexcept {
+    std::atomic<IndexType>& slot = slots[i % Slots].index;
+    IndexType offered = slot.load(std::memory_order_relaxed);
+    // Acquire, to see the element as it was when it was freed
+    if (offered && slot.compare_exchange_strong(offered, 0,
+                                                std::memory_order_acquire,
+                                                std::memory_order_relaxed)) {
+      return offered;
+    }
+    return 0;
+  }
+
+  // Offers index in slot i for up to spins iterations, returns true if it
+  // was taken by another thread
+  bool give(uint32_t i, IndexType index, uint32_t spins) noexcept {
+    std::atomic<IndexType>& slot = slots[i % Slots].index;
+    IndexType expected = 0;
+    // Release, to publish the freed element to the taker
+    if (!slot.compare_exchange_strong(expected, index,
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed)) {
+      return false;
+    }
+    for (uint32_t n = 0; n < spins; ++n) {
+      if (slot.load(std::memory_order_relaxed) != index) return true;
+      cpu_relax();
+    }
+    // Withdraw the offer, which fails if it was taken in the meantime
+    expected = index;
+    return !slot.compare_exchange_strong(expected, 0,
+                                         std::memory_order_relaxed);
+  }
+
+ private:
+  struct alignas(CacheLineSize) Slot {
+    std::atomic<IndexType> index;
+  };
+
+  Slot slots[Slots];
+};
+
+/**
+ * Stand-in for EliminationArray when FreeListOptions::kEliminationSlots is 0.
+ */
+template <typename IndexType>
+struct NoEliminationArray {
+  void clear() noexcept {}
+  IndexType take(uint32_t) noexcept { return 0; }
+  bool give(uint32_t, IndexType, uint32_t) noexcept { return false; }
+};
+
+/**
+ * Called by FreeListControl after each failed compare-and-swap on the head of
+ * the free list. Counts the retries, and if Eliminate, backs off
+ * exponentially and tries to exchange the element through an
+ * EliminationArray.
+ * @tparam IndexType Unsigned integer type used for indexes.
+ * @tparam Elimination EliminationArray or NoEliminationArray.
+ * @tparam Eliminate Whether to back off and use the elimination array.
+ */
+template <typename IndexType, typename Elimination, bool Eliminate>
+class Contention {
+ public:
+  explicit Contention(Elimination& array) noexcept
+      : elimination(array), retries(0) {}
+
+  // After a failed allocation, returns an index taken from a freeing thread,
+  // or 0 to retry the free list
+  IndexType on_push_retry() noexcept {
+    ++retries;
+    if (!Eliminate) return 0;
+    if (IndexType index = elimination.take(slot())) return index;
+    backoff();
+    return elimination.take(slot());
+  }
+
+  // After a failed free of one element, returns true if it was handed to an
+  // allocating thread
+  bool on_pop_retry(IndexType index) noexcept {
+    ++retries;
+    return Eliminate && elimination.give(slot(), index, spins());
+  }
+
+  // After any other failed update
+  void on_retry() noexcept { ++retries; }
+
+  // Number of failed updates
+  uint32_t retry_count() const noexcept { return retries; }
+
+ private:
+  static constexpr uint32_t kMaxBackoffShift = 8;
+
+  uint32_t spins() const noexcept {
+    return 1u << (retries < kMaxBackoffShift ? retries : kMaxBackoffShift);
+  }
+
+  void backoff() const noexcept {
+    for (uint32_t n = spins(); n > 0; --n) cpu_relax();
+  }
+
+  // Vary the slot between threads and between attempts
+  uint32_t slot() const noexcept { return thread_shard() + retries; }
+
+  Elimination& elimination;
+  uint32_t retries;
+};
+
+/**
+ * Default contention handling of FreeListControl, which does nothing.
+ */
+template <typename IndexType>
+struct NoContention {
+  IndexType on_push_retry() noexcept { return 0; }
+  bool on_pop_retry(IndexType) noexcept { return false; }
+  void on_retry() noexcept {}
+};
+
+/**
+ * Unsigned integer type holding an index of IndexType and an ABA tag. It is
+ * never wider than 8 bytes, so that it is lock-free on all common targets.
+ */
+template <typename IndexType>
+using tagged_index_t = typename std::conditional<
+    sizeof(IndexType) == 1, uint16_t,
+    typename std::conditional<sizeof(IndexType) == 2, uint32_t,
+                              uint64_t>::type>::type;
+
+/**
+ * Chosen if it is not void, otherwise Default. Used for the type members of
+ * FreeListOptions.
+ */
+template <typename Chosen, typename Default>
+using chosen_or_t =
+    typename std::conditional<std::is_void<Chosen>::value, Default,
+                              Chosen>::type;
+
+/**
+ * Type of the head word of FreeListControl, see FreeListOptions::HeadType.
+ */
+template <typename IndexType, typename Options>
+using head_type_t =
+    chosen_or_t<typename Options::HeadType, tagged_index_t<IndexType>>;
+
+/**
+ * Control words of a FreeList, and the lock-free algorithm operating on them.
+ * Shared by all FreeList variants; the elements are stored by the owner and
+ * passed to each function.
+ *
+ * Element 0 is never used, index 0 means "no element". The owner decides the
+ * range of usable indexes [first, end), where elements before first are
+ * overlaid by the control words.
+ *
+ * @tparam IndexType Unsigned integer type used for indexes.
+ * @tparam IndexBits Number of bits required for the largest index.
+ * @tparam Options Compile-time options, see FreeListOptions.
+ */
+template <typename IndexType, uint32_t IndexBits, typename Options>
+class alignas(Options::kCacheLineAligned ? Options::kCacheLineSize
+                                         : alignof(head_type_t<IndexType,
+                                                               Options>))
+    FreeListControl {
+ public:
+  using index_type = IndexType;
+  using size_type = uint64_t;
+
+  /**
+   * Type of the word holding the head of the free list, which is updated by
+   * compare-and-swap. The low IndexBits hold the index of the first free
+   * element, the remaining bits hold a tag that is incremented on every
+   * update to avoid the ABA problem. See FreeListOptions::HeadType.
+   */
+  using head_type = head_type_t<index_type, Options>;
+
+  /**
+   * Type of the count of active items, see FreeListOptions::CountType.
+   */
+  using count_type = chosen_or_t<typename Options::CountType, index_type>;
+
+  static_assert(std::is_unsigned<head_type>::value &&
+                    std::is_unsigned<count_type>::value,
+                "HeadType and CountType must be unsigned integer types");
+  static_assert(IndexBits <= sizeof(index_type) * 8,
+                "index_type is too small for IndexBits");
+  static_assert(IndexBits + 8 <= sizeof(head_type) * 8,
+                "FreeList is too large for an ABA-safe tag in HeadType");
+  static_assert(sizeof(count_type) * 8 >= IndexBits,
+                "CountType is too small for IndexBits");
+
+  static constexpr uint32_t kTagBits = sizeof(head_type) * 8 - IndexBits;
+
+  /**
+   * Number of bytes used by the control words, the rest of sizeof() is
+   * padding, for example to a cache line with kCacheLineAligned.
+   */
+  static constexpr uint64_t kUsedBytes =
+      round_up(sizeof(head_type) + sizeof(index_type), alignof(count_type)) +
+      sizeof(count_type);
+
+  static_assert(!Options::kThreadSafe ||
+                    (is_always_lock_free<sizeof(head_type)>::value &&
+                     is_always_lock_free<sizeof(index_type)>::value &&
+                     is_always_lock_free<sizeof(count_type)>::value),
+                "FreeList requires lock-free atomics for its control words");
+
+  /**
+   * Reset to contain no items, with first as the next never-used element.
+   */
+  void reset(index_type first) noexcept {
+    head.store(0, std::memory_order_relaxed);
+    next.store(first, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * Number of active items.
+   */
+  index_type size() const noexcept {
+    return static_cast<index_type>(count.load(std::memory_order_relaxed));
+  }
+
+  /**
+   * Index of the first free element, or 0. Only for use without concurrent
+   * modification.
+   */
+  index_type free_index() const noexcept {
+    return head_index(head.load(std::memory_order_relaxed));
+  }
+
+  /**
+   * Index of the next never-used element, at most end. Only for use without
+   * concurrent modification.
+   */
+  index_type next_index(index_type end) const noexcept {
+    // next may briefly overshoot end, see take_one_fresh()
+    index_type result = next.load(std::memory_order_relaxed);
+    return result < end ? result : end;
+  }
+
+  /**
+   * Index of the element that push_index() will probably take next, or 0 if
+   * all elements were used. Other threads may take it first, so this is only
+   * a hint, for prefetching.
+   */
+  index_type next_hint(index_type end) const noexcept {
+    if (index_type free = free_index()) return free;
+    index_type result = next.load(std::memory_order_relaxed);
+    return result < end ? result : 0;
+  }
+
+  /**
+   * Takes a free element, see FreeList::push_index. If contention is not
+   * null, it is called after each failed compare-and-swap, see Contention.
+   */
+  template <typename Element,
+            typename ContentionType = NoContention<index_type>>
+  inline index_type push_index(Element* elements, index_type end,
+                               ContentionType* contention = nullptr) noexcept;
+
+  /**
+   * Takes up to n free elements, see FreeList::push_indices.
+   */
+  template <typename Element,
+            typename ContentionType = NoContention<index_type>>
+  inline size_type push_indices(Element* elements, index_type first,
+                                index_type end, index_type* out, size_type n,
+                                ContentionType* contention = nullptr) noexcept;
+
+  /**
+   * Returns a chain of n elements, linked from head to tail via
+   * Element::index, to the free list with a single atomic update.
+   */
+  template <typename Element,
+            typename ContentionType = NoContention<index_type>>
+  inline void pop_chain(Element* elements, index_type chainHead,
+                        index_type tail, size_type n,
+                        ContentionType* contention = nullptr) noexcept;
+
+  /**
+   * Makes a chain of n elements, linked via Element::index and ending with 0,
+   * the free list, which must be empty. Only for use without concurrent
+   * modification.
+   */
+  void adopt_chain(index_type chainHead, size_type n) noexcept {
+    assert(!free_index());
+    head.store(make_head(chainHead, head.load(std::memory_order_relaxed)),
+               std::memory_order_relaxed);
+    count.fetch_sub(static_cast<count_type>(n), std::memory_order_relaxed);
+  }
+
+  /**
+   * Takes n contiguous never-used elements, see FreeList::reserve_fresh.
+   */
+  inline index_type reserve_fresh(index_type end, size_type n) noexcept;
+
+  /**
+   * Calls f(index) for each active element in [first, end), in increasing
+   * order. The free list is sorted in place first, so no memory is allocated.
+   * Only for use without concurrent modification; f must not alloc or free.
+   */
+  template <typename Element, typename F>
+  inline void for_each_active(Element* elements, index_type first,
+                              index_type end, F&& f) noexcept(noexcept(f(0)));
+
+  /**
+   * Sorts the first n elements of the free list by index in place, with a
+   * bottom-up merge sort of the chain. Only for use without concurrent
+   * modification.
+   * @return Index of the first free element, or 0.
+   */
+  template <typename Element>
+  inline index_type sort_free_list(
+      Element* elements,
+      size_type n = std::numeric_limits<size_type>::max()) noexcept;
+
+  /**
+   * Sorts the free list, then returns the free elements directly below next
+   * to the never-used elements by lowering next past them. Only for use
+   * without concurrent modification.
+   * @return The new index of the next never-used element, at most end.
+   */
+  template <typename Element>
+  inline index_type trim_fresh(Element* elements, index_type end) noexcept;
+
+  /**
+   * Takes the free element with the lowest index, or one near hint if hint is
+   * not 0, from an OrderedOccupancyBitmap instead of the free list, see
+   * FreeListOptions::kAddressOrdered.
+   */
+  template <typename Bitmap>
+  inline index_type push_ordered(Bitmap& bitmap, index_type first,
+                                 index_type end, index_type hint) noexcept;
+
+  /**
+   * Returns an element taken by push_ordered() or reserve_ordered().
+   */
+  template <typename Bitmap>
+  inline void pop_ordered(Bitmap& bitmap, index_type index) noexcept;
+
+  /**
+   * Takes n contiguous never-used elements, claiming them in an
+   * OrderedOccupancyBitmap. Fails if an element was claimed concurrently.
+   */
+  template <typename Bitmap>
+  inline index_type reserve_ordered(Bitmap& bitmap, index_type end,
+                                    size_type n) noexcept;
+
+ private:
+  static constexpr head_type kIndexMask =
+      static_cast<head_type>((uint64_t{1} << IndexBits) - 1);
+
+  // Takes up to n never-used items, returns the first index and sets n to the
+  // number of items taken
+  inline index_type take_fresh(index_type end, size_type& n) noexcept;
+
+  // Takes one never-used item, returns 0 if all items were used
+  inline index_type take_one_fresh(index_type end) noexcept;
+
+  // Extract the index of the first free element from a head word
+  static index_type head_index(head_type h) noexcept {
+    return static_cast<index_type>(h & kIndexMask);
+  }
+
+  // Create a head word pointing to index, with the tag of prev incremented
+  static head_type make_head(index_type index, head_type prev) noexcept {
+    return static_cast<head_type>(
+        ((static_cast<uint64_t>(prev >> IndexBits) + 1) << IndexBits) | index);
+  }
+
+  // Head of the free list, and ABA tag
+  atomic_t<head_type, Options::kThreadSafe> head;
+  // Next never-used element
+  atomic_t<index_type, Options::kThreadSafe> next;
+  // Number of active items
+  atomic_t<count_type, Options::kThreadSafe> count;
+};
+
+template <typename IndexType, uint32_t IndexBits, typename Options>
+template <typename Element, typename ContentionType>
+IndexType FreeListControl<IndexType, IndexBits, Options>::push_index(
+    Element* elements, const index_type end,
+    ContentionType* contention) noexcept {
+  // Count the item before it exists, so that count never underflows when the
+  // item is freed by another thread
+  count.fetch_add(1, std::memory_order_relaxed);
+
+  do {
+    // Read the free index. Acquire, to see the index stored in the element by
+    // the thread that freed it.
+    head_type currHead = head.load(std::memory_order_acquire);
+
+    while (index_type free = head_index(currHead)) {
+      // While free is not zero, then there is a previously-freed item
+
+      // Read the index stored at that element, and increment the tag to avoid
+      // the ABA problem
+      head_type newHead = make_head(elements[free].index, currHead);
+
+      // Fetch the new head during the update, for the next allocation
+      if (Options::kPrefetch) prefetch(&elements[head_index(newHead)]);
+
+      if (head.compare_exchange_weak(currHead, newHead,
+                                     std::memory_order_acquire,
+                                     std::memory_order_acquire)) {
+        // Return the previously freed item
+        return free;
+      }
+      if (contention) {
+        // An element may be handed over by a thread freeing one
+        if (index_type index = contention->on_push_retry()) return index;
+        currHead = head.load(std::memory_order_acquire);
+      }
+    }
+
+    // No previously-freed item, take a never-used item
+    if (index_type index = take_one_fresh(end)) {
+      return index;
+    }
+
+    // All items were used, but one may have been freed in the meantime
+  } while (head_index(head.load(std::memory_order_relaxed)));
+
+  count.fetch_sub(1, std::memory_order_relaxed);
+  return 0;
+}
+
+template <typename IndexType, uint32_t IndexBits, typename Options>
+template <typename Element, typename ContentionType>
+typename FreeListControl<IndexType, IndexBits, Options>::size_type
+FreeListControl<IndexType, IndexBits, Options>::push_indices(
+    Element* elements, const index_type first, const index_type end,
+    index_type* out, const size_type n, ContentionType* contention) noexcept {
+  if (!n) return 0;
+
+  // Count the items before they exist, see push_index()
+  count.fetch_add(n, std::memory_order_relaxed);
+
+  size_type taken = 0;
+  do {
+    // Take as many previously-freed items as possible
+    head_type currHead = head.load(std::memory_order_acquire);
+    while (head_index(currHead)) {
+      index_type free = head_index(currHead);
+      size_type walked = 0;
+      bool stale = false;
+
+      while (walked < n - taken && free) {
+        out[taken + walked++] = free;
+        free = elements[free].index;
+        if ((free && free < first) || free >= end) {
+          // Another thread re-used an element while we were walking the chain
+          stale = true;
+          break;
+        }
+      }
+
+      if (stale) {
+        if (contention) contention->on_retry();
+        currHead = head.load(std::memory_order_acquire);
+        continue;
+      }
+
+      if (head.compare_exchange_weak(currHead, make_head(free, currHead),
+                                     std::memory_order_acquire,
+                                     std::memory_order_acquire)) {
+        taken += walked;
+        break;
+      }
+      if (contention) contention->on_retry();
+    }
+
+    // Take the remainder from the never-used items
+    size_type fresh = n - taken;
+    index_type index = take_fresh(end, fresh);
+    // fresh <= n - taken, the test on taken lets the compiler see it too
+    for (size_type i = 0; i < fresh && taken < n; ++i) {
+      out[taken++] = index + i;
+    }
+
+    // If all items were used, one may have been freed in the meantime
+  } while (taken < n && head_index(head.load(std::memory_order_relaxed)));
+
+  count.fetch_sub(n - taken, std::memory_order_relaxed);
+  return taken;
+}
+
+template <typename IndexType, uint32_t IndexBits, typename Options>
+template <typename Element, typename ContentionType>
+void FreeListControl<IndexType, IndexBits, Options>::pop_chain(
+    Element* elements, const index_type chainHead, const index_type tail,
+    const size_type n, ContentionType* contention) noexcept {
+  // We need to atomically:
+  // - read the current value of the free index
+  // - set the tail of the chain to contain that free index
+  // - change the free index to point to the head of the chain
+  // - include a tag increment to avoid ABA problem
+  index_type& tailElement = elements[tail].index;
+
+  head_type currHead = head.load(std::memory_order_relaxed);
+  tailElement = head_index(currHead);
+  // Release, to publish the index stored in the tail element
+  while (!head.compare_exchange_weak(currHead, make_head(chainHead, currHead),
+                                     std::memory_order_release,
+                                     std::memory_order_relaxed)) {
+    if (contention && n == 1 && contention->on_pop_retry(chainHead)) {
+      // Handed to an allocating thread, which counted it
+      count.fetch_sub(1, std::memory_order_relaxed);
+      return;
+    }
+    tailElement = head_index(currHead);
+  }
+
+  count.fetch_sub(n, std::memory_order_relaxed);
+}
+
+template <typename IndexType, uint32_t IndexBits, typename Options>
+IndexType FreeListControl<IndexType, IndexBits, Options>::reserve_fresh(
+    const index_type end, const size_type n) noexcept {
+  if (!n) return 0;
+
+  index_type curr = next.load(std::memory_order_relaxed);
+  do {
+    if (curr >= end || n > size_type(end - curr)) {
+      return 0;
+    }
+  } while (!next.compare_exchange_weak(curr, static_cast<index_type>(curr + n),
+                                       std::memory_order_relaxed));
+
+  count.fetch_add(n, std::memory_order_relaxed);
+  return curr;
+}
+
+template <typename IndexType, uint32_t IndexBits, typename Options>
+IndexType FreeListControl<IndexType, IndexBits, Options>::take_fresh(
+    const index_type end, size_type& n) noexcept {
+  // Never-used elements are not shared with other threads, so no ordering is
+  // required
+  index_type curr = next.load(std::memory_order_relaxed);
+  do {
+    if (curr >= end) {
+      n = 0;
+      return 0;
+    }
+    if (n > size_type(end - curr)) {
+      n = end - curr;
+    }
+  } while (!next.compare_exchange_weak(curr, static_cast<index_type>(curr + n),
+                                       std::memory_order_relaxed));
+
+  // Return the pre-increment next index
+  return curr;
+}
+
+template <typename IndexType, uint32_t IndexBits, typename Options>
+IndexType FreeListControl<IndexType, IndexBits, Options>::take_one_fresh(
+    const index_type end) noexcept {
+  // fetch_add may briefly advance next past end (one per concurrent caller),
+  // so it is only used when index_type has ample headroom above end
+  if (uint64_t{std::numeric_limits<index_type>::max()} - end <
+      (uint64_t{1} << 15)) {
+    size_type n = 1;
+    index_type index = take_fresh(end, n);
+    return n ? index : 0;
+  }
+
+  if (next.load(std::memory_order_relaxed) >= end) {
+    return 0;
+  }
+  index_type curr = next.fetch_add(1, std::memory_order_relaxed);
+  if (curr < end) {
+    return curr;
+  }
+  // Overshot the end, undo the increment
+  next.fetch_sub(1, std::memory_order_relaxed);
+  return 0;
+}
+
+template <typename IndexType, uint32_t IndexBits, typename Options>
+template <typename Element, typename F>
+void FreeListControl<IndexType, IndexBits, Options>::for_each_active(
+    Element* elements, const index_type first, const index_type end,
+    F&& f) noexcept(noexcept(f(0))) {
+  // Walk the sorted free list alongside the used elements, skipping free ones
+  index_type free = sort_free_list(elements);
+  const index_type used = next_index(end);
+  for (index_type i = first; i < used; ++i) {
+    if (i == free) {
+      free = elements[free].index;
+    } else {
+      f(i);
+    }
+  }
+}
+
+template <typename IndexType, uint32_t IndexBits, typename Options>
+template <typename Element>
+IndexType FreeListControl<IndexType, IndexBits, Options>::sort_free_list(
+    Element* elements, const size_type n) noexcept {
+  index_type list = free_index();
+  if (!list || !n) return list;
+
+  // Detach the elements after the first n, to be reattached after sorting
+  index_type rest = 0;
+  {
+    index_type last = list;
+    for (size_type i = 1; i < n && elements[last].index; ++i) {
+      last = elements[last].index;
+    }
+    rest = elements[last].index;
+    elements[last].index = 0;
+  }
+
+  // Merge runs of width elements pairwise, doubling width until one run
+  // remains
+  index_type tail = 0;
+  for (size_type width = 1;; width *= 2) {
+    index_type p = list;
+    size_type merges = 0;
+    tail = 0;
+    list = 0;
+
+    while (p) {
+      ++merges;
+      index_type q = p;
+      size_type pSize = 0;
+      while (pSize < width && q) {
+        ++pSize;
+        q = elements[q].index;
+      }
+      size_type qSize = width;
+
+      while (pSize > 0 || (qSize > 0 && q)) {
+        index_type e;
+        if (pSize > 0 && (qSize == 0 || !q || p < q)) {
+          e = p;
+          p = elements[p].index;
+          --pSize;
+        } else {
+          e = q;
+          q = elements[q].index;
+          --qSize;
+        }
+        if (tail) {
+          elements[tail].index = e;
+        } else {
+          list = e;
+        }
+        tail = e;
+      }
+      p = q;
+    }
+    elements[tail].index = 0;
+
+    if (merges <= 1) break;
+  }
+  elements[tail].index = rest;
+
+  head.store(make_head(list, head.load(std::memory_order_relaxed)),
+             std::memory_order_relaxed);
+  return list;
+}
+
+template <typename IndexType, uint32_t IndexBits, typename Options>
+template <typename Element>
+IndexType FreeListControl<IndexType, IndexBits, Options>::trim_fresh(
+    Element* elements, const index_type end) noexcept {
+  index_type used = next_index(end);
+
+  // Find the last run of consecutive free elements, and the one before it
+  index_type beforeRun = 0;
+  index_type runStart = 0;
+  index_type prev = 0;
+  for (index_type i = sort_free_list(elements); i; i = elements[i].index) {
+    if (!prev || i != prev + 1) {
+      beforeRun = prev;
+      runStart = i;
+    }
+    prev = i;
+  }
+
+  // Only a run ending at next is adjacent to the never-used elements
+  if (runStart && prev + 1 == used) {
+    if (beforeRun) {
+      elements[beforeRun].index = 0;
+    } else {
+      head.store(make_head(0, head.load(std::memory_order_relaxed)),
+                 std::memory_order_relaxed);
+    }
+    used = runStart;
+  }
+  next.store(used, std::memory_order_relaxed);
+  return used;
+}
+
+template <typename IndexType, uint32_t IndexBits, typename Options>
+template <typename Bitmap>
+IndexType FreeListControl<IndexType, IndexBits, Options>::push_ordered(
+    Bitmap& bitmap, const index_type first, const index_type end,
+    const index_type hint) noexcept {
+  // Count the item before it exists, see push_index()
+  count.fetch_add(1, std::memory_order_relaxed);
+
+  const uint64_t found =
+      hint ? bitmap.claim_near(hint, first, end) : bitmap.claim(first, end);
+  if (found >= end) {
+    count.fetch_sub(1, std::memory_order_relaxed);
+    return 0;
+  }
+
+  // Keep next past every element taken, for reserve_ordered() and scans
+  const index_type index = static_cast<index_type>(found);
+  index_type curr = next.load(std::memory_order_relaxed);
+  while (curr <= index &&
+         !next.compare_exchange_weak(curr, static_cast<index_type>(index + 1),
+                                     std::memory_order_relaxed)) {
+  }
+  return index;
+}
+
+template <typename IndexType, uint32_t IndexBits, typename Options>
+template <typename Bitmap>
+void FreeListControl<IndexType, IndexBits, Options>::pop_ordered(
+    Bitmap& bitmap, const index_type index) noexcept {
+  bitmap.reset(index);
+  count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template <typename IndexType, uint32_t IndexBits, typename Options>
+template <typename Bitmap>
+IndexType FreeListControl<IndexType, IndexBits, Options>::reserve_ordered(
+    Bitmap& bitmap, const index_type end, const size_type n) noexcept {
+  const index_type first = reserve_fresh(end, n);
+  if (first && !bitmap.claim_range(first, n)) {
+    // The elements stay behind next as free elements
+    count.fetch_sub(n, std::memory_order_relaxed);
+    return 0;
+  }
+  return first;
+}
+
+/**
+ * Forward iterator over the active items of a FreeList, in address order. It
+ * walks the used elements alongside the sorted free list, skipping free ones.
+ */
+template <typename T, typename IndexType>
+class LiveIterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T*;
+  using reference = T&;
+
+  LiveIterator() noexcept : elements(nullptr), i(0), free(0), used(0) {}
+
+  /**
+   * @param elements Elements of the FreeList.
+   * @param first First index to visit.
+   * @param free First index of the sorted free list.
+   * @param used One past the last used index.
+   */
+  LiveIterator(FreeListElement<T, IndexType>* elements, IndexType first,
+               IndexType free, IndexType used) noexcept
+      : elements(elements), i(first), free(free), used(used) {
+    skip_free();
+  }
+
+  T& operator*() const noexcept { return elements[i].data; }
+  T* operator->() const noexcept { return &elements[i].data; }
+
+  LiveIterator& operator++() noexcept {
+    ++i;
+    skip_free();
+    return *this;
+  }
+
+  LiveIterator operator++(int) noexcept {
+    LiveIterator result = *this;
+    ++*this;
+    return result;
+  }
+
+  /**
+   * @return Index of the current item.
+   */
+  IndexType index() const noexcept { return i; }
+
+  bool operator==(LiveIterator const& other) const noexcept {
+    return i == other.i;
+  }
+
+  bool operator!=(LiveIterator const& other) const noexcept {
+    return i != other.i;
+  }
+
+ private:
+  void skip_free() noexcept {
+    while (i < used && i == free) {
+      free = elements[free].index;
+      ++i;
+    }
+  }
+
+  FreeListElement<T, IndexType>* elements;
+  IndexType i;
+  // Next free index at or after i, or 0
+  IndexType free;
+  IndexType used;
+};
+
+/**
+ * Range of the active items of a FreeList, for use in range-based for.
+ */
+template <typename T, typename IndexType>
+class LiveRange {
+ public:
+  using iterator = LiveIterator<T, IndexType>;
+
+  LiveRange(iterator begin, iterator end) noexcept : first(begin), last(end) {}
+
+  iterator begin() const noexcept { return first; }
+  iterator end() const noexcept { return last; }
+
+ private:
+  iterator first;
+  iterator last;
+};
+
+}  // namespace detail
+
+/**
+ * FreeList allows random allocation and deletion of items of a fixed type,
+ * without the need for dynamic memory allocation.
+ *
+ * FreeList is defined by the type to be stored and the number of bytes that
+ * the FreeList should occupy.
+ *
+ * The alloc function constructs new items passing provided arguments to any
+ * constructor. The free function destructs items.
+ *
+ * @tparam T Data type to store.
+ * @tparam Size Total number of bytes for this FreeList: sizeof(*this) == Size.
+ * @tparam Options Compile-time options, see FreeListOptions.
+ */
+template <typename T, uint64_t Size, typename Options>
+class FreeList {
+ public:
+  static_assert(!std::is_abstract<T>::value,
+                "Stored data type must not be abstract");
+
+  /**
+   * Type that is stored in each active element.
+   */
+  using value_type = T;
+
+  using this_type = FreeList<T, Size, Options>;
+
+  using options_type = Options;
+
+  /**
+   * Type used for storing indexes. Set to Options::IndexType, or by default to
+   * an unsigned integer large enough to store all indexes.
+   */
+  using index_type = detail::chosen_or_t<
+      typename Options::IndexType,
+      typename std::conditional<
+          Size <= std::numeric_limits<uint8_t>::max(), uint8_t,
+          typename std::conditional<
+              (Size / 2) <= std::numeric_limits<uint16_t>::max(), uint16_t,
+              typename std::conditional<
+                  (Size / 4) <= std::numeric_limits<uint32_t>::max(),
+                  uint32_t, uint64_t>::type>::type>::type>;
+
+  using size_type = uint64_t;
+
+  /**
+   * Type of function object used to free items.
+   */
+  using Deleter = FreeListDeleter<T, Size, Options>;
+
+  /**
+   * Type of std::unique_ptr returned by make_unique.
+   */
+  using UniquePtr = std::unique_ptr<T, Deleter>;
+
+  /**
+   * Type of intrusive shared pointer returned by make_handle.
+   */
+  using SharedHandle = freelist::SharedHandle<T, Deleter>;
+
+  /**
+   * Type of an allocator created from this FreeList.
+   */
+  using Allocator = FreeListAllocator<T, Size, Options>;
+
+  /**
+   * Construct an empty FreeList.
+   */
+  inline FreeList();
+
+  /**
+   * Destructor, calls delete on all existing items.
+   */
+  inline ~FreeList() noexcept;
+
+  /**
+   * Check if the FreeList is empty.
+   * @return True if the FreeList contains no items.
+   */
+  inline bool empty() const noexcept;
+
+  /**
+   * Check if the FreeList is full.
+   * @return True if the FreeList is full.
+   */
+  inline bool full() const noexcept;
+
+  /**
+   * Check the number of active items in the FreeList.
+   * @return Number of active items in the FreeList.
+   */
+  inline index_type size() const noexcept;
+
+  /**
+   * Get the maximum number of items that can be stored.
+   * @return Maximum number of stored items.
+   */
+  inline static index_type max_size() noexcept;
+
+  /**
+   * Synonym for max_size()
+   */
+  inline static index_type capacity() noexcept { return max_size(); }
+
+  /**
+   * Removes all items from the list, calling destructor for each.
+   */
+  inline void clear() noexcept;
+
+  /**
+   * Allocates a new item in the FreeList, and calls constructor.
+   * @tparam Args Type of arguments for item constructor.
+   * @param args Arguments to provide to item constructor.
+   * @return Pointer to new item.
+   * @exception std::bad_alloc If the freelist is full.
+   * @exception any Exceptions thrown by the constructor are forwarded.
+   * If any exception is thrown, the freelist state will be unchanged.
+   */
+  template <typename... Args>
+  inline T* alloc(Args&&... args);
+
+  /**
+   * Synonym for alloc().
+   */
+  template <typename... Args>
+  inline T* push(Args&&... args) {
+    return alloc(std::forward<Args>(args)...);
+  }
+
+  /**
+   * Constructs a new item in the FreeList, without throwing if the freelist is
+   * full. Does not throw at all if the constructor is noexcept.
+   * @tparam Args Type of arguments for item constructor.
+   * @param args Arguments to provide to item constructor.
+   * @return Index of the new item, or 0 if the freelist is full.
+   * @exception any Exceptions thrown by the constructor are forwarded.
+   * If any exception is thrown, the freelist state will be unchanged.
+   */
+  template <typename... Args>
+  inline index_type emplace(Args&&... args) noexcept(
+      std::is_nothrow_constructible<T, Args&&...>::value);
+
+  /**
+   * Constructs item in the Freelist with arguments, and returns unique_ptr.
+   * @tparam Args Type of arguments for item constructor.
+   * @param args Arguments to provide to item constructor.
+   * @return unique_ptr to the item.
+   * @exception std::bad_alloc If the freelist is full.
+   * @exception any Exceptions thrown by the constructor are forwarded.
+   * If any exception is thrown, the freelist state will be unchanged.
+   */
+  template <typename... Args>
+  inline UniquePtr make_unique(Args&&... args);
+
+  /**
+   * Constructs item in the Freelist with arguments, and returns shared_ptr.
+   *
+   * The shared_ptr control block does not live in the item's slot. It is taken
+   * from a sibling FreeList owned by this FreeList, with room for one control
+   * block per item, allocated on first use and freed with this FreeList.
+   * FreeLists smaller than 256 bytes have no room to own it, and allocate
+   * control blocks with std::allocator. Use the overload taking an allocator
+   * to control where they live.
+   * @tparam Args Type of arguments for item constructor.
+   * @param args Arguments to provide to item constructor.
+   * @return shared_ptr to the item.
+   * @exception std::bad_alloc If the freelist is full.
+   * @exception any Exceptions thrown by the constructor are forwarded.
+   * If any exception is thrown, the freelist state will be unchanged.
+   */
+  template <typename... Args>
+  inline std::shared_ptr<T> make_shared(Args&&... args);
+
+  /**
+   * Constructs item in the Freelist with arguments, and returns shared_ptr
+   * whose control block is allocated with alloc.
+   * @tparam Alloc Allocator type, rebound to the control block type.
+   * @tparam Args Type of arguments for item constructor.
+   * @param allocator Allocator for the control block.
+   * @param args Arguments to provide to item constructor.
+   * @return shared_ptr to the item.
+   * @exception std::bad_alloc If the freelist is full.
+   * @exception any Exceptions thrown by alloc or the constructor are
+   * forwarded. If any exception is thrown, the freelist state will be
+   * unchanged.
+   */
+  template <typename Alloc, typename... Args>
+  inline std::shared_ptr<T> make_shared(std::allocator_arg_t,
+                                        Alloc allocator, Args&&... args);
+
+  /**
+   * Constructs item in the Freelist with arguments, and returns a SharedHandle
+   * to it. T must derive from RefCounted.
+   * @tparam Args Type of arguments for item constructor.
+   * @param args Arguments to provide to item constructor.
+   * @return SharedHandle to the item.
+   * @exception std::bad_alloc If the freelist is full.
+   * @exception any Exceptions thrown by the constructor are forwarded.
+   * If any exception is thrown, the freelist state will be unchanged.
+   */
+  template <typename... Args>
+  inline SharedHandle make_handle(Args&&... args);
+
+  /**
+   * Allocates n new items in the FreeList, and calls constructor for each.
+   * Indexes are taken from the FreeList in batches, with one atomic update of
+   * the FreeList per batch.
+   * @tparam Args Type of arguments for item constructor.
+   * @param out Array to receive n pointers to new items.
+   * @param n Number of items to allocate.
+   * @param args Arguments to provide to each item constructor, as lvalues.
+   * @exception std::bad_alloc If the freelist cannot hold n more items.
+   * @exception any Exceptions thrown by the constructor are forwarded.
+   * If any exception is thrown, the freelist state will be unchanged.
+   */
+  template <typename... Args>
+  inline void alloc_n(T** out, size_type n, Args&&... args);
+
+  /**
+   * Allocates a new item in the FreeList close to hint, and calls
+   * constructor. Requires Options::kAddressOrdered.
+   * @tparam Args Type of arguments for item constructor.
+   * @param hint Item near which to allocate; if nullptr, the item with the
+   * lowest free address is allocated, as for alloc().
+   * @param args Arguments to provide to item constructor.
+   * @return Pointer to new item.
+   * @exception std::bad_alloc If the freelist is full.
+   * @exception any Exceptions thrown by the constructor are forwarded.
+   * If any exception is thrown, the freelist state will be unchanged.
+   */
+  template <typename... Args>
+  inline T* alloc_near(T const* hint, Args&&... args);
+
+  /**
+   * Allocates a new item in the FreeList, and calls constructor, as alloc().
+   * Also prefetches the element that the next allocation will probably
+   * take, for writing, so that when items are allocated and initialised in
+   * a loop, each one is already in cache. Most useful with
+   * Options::kPrefetch, which covers the index stored in that element.
+   *
+   * The extra prefetches are not free: when elements are allocated in
+   * address order, which the hardware prefetcher already covers, this is
+   * about 20% slower than alloc() (BM_AllocFreeBatch). With a free list in
+   * no particular order and larger than the caches, it is at most a few
+   * percent faster than alloc() with Options::kPrefetch. Measure before
+   * using it in place of alloc().
+   * @tparam Args Type of arguments for item constructor.
+   * @param args Arguments to provide to item constructor.
+   * @return Pointer to new item.
+   * @exception std::bad_alloc If the freelist is full.
+   * @exception any Exceptions thrown by the constructor are forwarded.
+   * If any exception is thrown, the freelist state will be unchanged.
+   */
+  template <typename... Args>
+  inline T* alloc_prefetched(Args&&... args);
+
+  /**
+   * Deletes an item from the FreeList, and calls destructor.
+   * @param item Pointer to item to delete.
+   */
+  inline void free(T* item) noexcept;
+
+  /**
+   * Deletes n items from the FreeList, and calls destructor for each. The
+   * items are returned to the FreeList with a single atomic update.
+   * @param items Array of pointers to items to delete.
+   * @param n Number of items to delete.
+   */
+  inline void free_n(T* const* items, size_type n) noexcept;
+
+  /**
+   * Synonym for free().
+   */
+  inline void pop(T* item) noexcept { free(item); }
+
+  /**
+   * Creates new item in the FreeList, does not call constructor.
+   * @return Index of new item, or 0 if full.
+   */
+  inline index_type push_index() noexcept;
+
+  /**
+   * Creates new item in the FreeList close to hint, does not call
+   * constructor. Requires Options::kAddressOrdered.
+   * @param hint Index near which to allocate, or 0 for the lowest free index.
+   * @return Index of new item, or 0 if full.
+   */
+  inline index_type push_index_near(index_type hint) noexcept;
+
+  /**
+   * Removes item at specified index, does not call destructor.
+   * @param index Index of item to remove.
+   */
+  inline void pop_index(index_type index) noexcept;
+
+  /**
+   * Creates up to n new items in the FreeList with a single atomic update,
+   * does not call constructors.
+   * @param out Array to receive the indexes of the new items.
+   * @param n Maximum number of items to create.
+   * @return Number of items created, less than n only if the FreeList is full.
+   */
+  inline size_type push_indices(index_type* out, size_type n) noexcept;
+
+  /**
+   * Removes n items with a single atomic update, does not call destructors.
+   * @param in Array of indexes of items to remove.
+   * @param n Number of items to remove.
+   */
+  inline void pop_indices(index_type const* in, size_type n) noexcept;
+
+  /**
+   * Creates n new items at contiguous indexes, taken from never-used elements
+   * with a single atomic update, does not call constructors. The items can be
+   * accessed with get(first + i) for i < n, and removed with pop_index().
+   * @param n Number of items to create.
+   * @return Index of the first new item, or 0 if fewer than n never-used
+   * elements remain, in which case no items are created.
+   */
+  inline index_type reserve_fresh(size_type n) noexcept;
+
+  /**
+   * Marks an item whose destructor has been called as no longer live, without
+   * removing it: try_get() of its handles returns nullptr and live scans skip
+   * it. For caches such as ThreadCache that keep freed indexes to reuse. Not
+   * available with kAddressOrdered, whose occupancy bitmap is its free list.
+   * @param index Index of item to retire.
+   */
+  inline void retire_index(index_type index) noexcept;
+
+  /**
+   * Marks an item retired by retire_index() as live again, before its
+   * constructor is called.
+   * @param index Index of item to revive.
+   */
+  inline void revive_index(index_type index) noexcept;
+
+  /**
+   * Get the index of the specified item.
+   * @param item Pointer of item to find.
+   * @return Index of the specified item.
+   */
+  inline index_type index(T* item);
+
+  /**
+   * Get the index of the specified item.
+   * @param item Pointer of item to find.
+   * @return Index of the specified item.
+   */
+  inline index_type index(T const* item) const;
+
+  /**
+   * Convert an index into a pointer to the corresponding item.
+   * @param index Index of item to retrieve.
+   * @return Pointer to item.
+   */
+  inline T* get(index_type index);
+
+  /**
+   * Convert an index into a pointer to the corresponding item, const version.
+   * @param index Index of item to retrieve.
+   * @return Pointer to item.
+   */
+  inline T const* get(index_type index) const;
+
+  /**
+   * Compact reference to an item, holding its index and the generation of its
+   * element in one 64-bit word. Unlike an index, it detects that the item was
+   * freed, even if the element was reused: try_get() then returns nullptr.
+   * Generations wrap around after 2^32 frees of the same element.
+   */
+  class Handle {
+   public:
+    /**
+     * Construct a null handle, for which try_get() returns nullptr.
+     */
+    Handle() noexcept : word(0) {}
+
+    /**
+     * Construct a handle from a value returned by value().
+     */
+    explicit Handle(uint64_t value) noexcept : word(value) {}
+
+    /**
+     * Get the handle as an integer, for example to pass between threads.
+     */
+    uint64_t value() const noexcept { return word; }
+
+    explicit operator bool() const noexcept { return word != 0; }
+
+    friend bool operator==(Handle a, Handle b) noexcept {
+      return a.word == b.word;
+    }
+    friend bool operator!=(Handle a, Handle b) noexcept {
+      return a.word != b.word;
+    }
+
+   private:
+    uint64_t word;
+  };
+
+  /**
+   * Get a handle to the specified active item.
+   * Requires Options::kGenerations.
+   * @param item Pointer of item.
+   * @return Handle to the item.
+   */
+  inline Handle handle(T const* item) const noexcept;
+
+  /**
+   * Convert a handle into a pointer to the item, if it has not been freed.
+   * The check does not keep the item alive: if the item may be freed
+   * concurrently, the caller must synchronise with the thread freeing it.
+   * Requires Options::kGenerations.
+   * @param handle Handle returned by handle().
+   * @return Pointer to the item, or nullptr if it was freed or the handle is
+   * null.
+   */
+  inline T* try_get(Handle handle) noexcept;
+
+  /**
+   * Convert a handle into a pointer to the item, const version.
+   * @see try_get
+   */
+  inline T const* try_get(Handle handle) const noexcept;
+
+  /**
+   * Type of range returned by live().
+   */
+  using LiveRange = detail::LiveRange<T, index_type>;
+
+  /**
+   * Get a range of the active items, in address order, for a linear sweep:
+   *
+   *     for (T& item : fl.live()) { ... }
+   *
+   * The free list is sorted when the range is created. No item may be
+   * allocated or freed while the range is in use, including from other
+   * threads. Elements taken by push_index() or reserve_fresh() are included,
+   * whether or not an item has been constructed in them. So are indexes held
+   * by a ThreadCache: flush all ThreadCaches first, which is checked by an
+   * assertion with Options::kOccupancyBitmap.
+   * @return Range of active items.
+   */
+  inline LiveRange live() noexcept;
+
+  /**
+   * Call f(item) for each active item, in address order. With
+   * Options::kOccupancyBitmap, indexes held by a ThreadCache are skipped;
+   * without it they are included, so flush all ThreadCaches first.
+   * @see live
+   * @param f Function object taking T&.
+   */
+  template <typename F>
+  inline void for_each_live(F&& f);
+
+  /**
+   * Check whether the element at index is active. May be called concurrently
+   * with allocations and frees, in which case the result may be stale.
+   * Requires Options::kOccupancyBitmap.
+   * @param index Index of the element, as returned by index() or emplace().
+   * @return True if the element is active.
+   */
+  inline bool is_live(index_type index) const noexcept;
+
+  /**
+   * Count the active elements with indexes in [first, last).
+   * Requires Options::kOccupancyBitmap.
+   * @param first First index to count.
+   * @param last Index after the last index to count; clamped to the end.
+   * @return Number of active elements in the range.
+   */
+  inline size_type count_live(index_type first,
+                              index_type last) const noexcept;
+
+  /**
+   * Find the first active element with an index of at least first.
+   * Requires Options::kOccupancyBitmap.
+   * @param first First index to search.
+   * @return Index of the first active element, or 0 if there is none.
+   */
+  inline index_type find_live(index_type first = 0) const noexcept;
+
+  /**
+   * Sorts the next n elements to be allocated by address, so that the next n
+   * allocations are in address order. With a small n this bounds the work,
+   * and may be repeated as items are freed. Does nothing if
+   * Options::kAddressOrdered, as allocations are then always in address
+   * order. No item may be allocated or freed during the call, including from
+   * other threads.
+   * @param n Number of free elements to sort, by default all of them.
+   */
+  inline void compact_free_list(
+      size_type n = std::numeric_limits<size_type>::max()) noexcept {
+    data.control.sort_free_list(data.elements, n);
+  }
+
+  /**
+   * Get the statistics recorded since construction, for export to a
+   * monitoring system. May be called concurrently with allocations and
+   * frees. Requires Options::kStats.
+   * @return Current statistics.
+   */
+  inline FreeListStats snapshot() const noexcept;
+
+  /**
+   * Returns a function object to delete items from this freelist.
+   * @return Deleter function object.
+   */
+  inline Deleter deleter() noexcept { return Deleter(*this); }
+
+  /**
+   * Returns an allocator taking single objects from this FreeList, for use
+   * with standard containers. All allocators from the same FreeList share one
+   * state, created by the first call and destroyed with the FreeList, so they
+   * compare equal and share sibling FreeLists for other node sizes. The
+   * pointer to the state takes 9 bytes, in the padding of the control words if
+   * they have it, else of the first elements. FreeLists of less than 256
+   * bytes, or with no room for it, do not keep it, and each call then returns
+   * an allocator with its own state.
+   * @see FreeListAllocator
+   * @return Allocator.
+   * @exception std::bad_alloc If the shared state cannot be allocated.
+   */
+  inline Allocator allocator() { return Allocator(*this); }
+
+ private:
+  template <typename, uint64_t, typename>
+  friend class FreeListAllocator;
+
+  using Element = detail::FreeListElement<T, index_type>;
+
+  static constexpr uint64_t kElementSize = sizeof(Element);
+
+  // Number of indexes alloc_n() takes from the FreeList in one update
+  static constexpr size_type kBatchSize = 64;
+
+  static_assert(std::is_unsigned<index_type>::value,
+                "IndexType must be an unsigned integer type");
+  static_assert(Size / kElementSize - 1 <=
+                    std::numeric_limits<index_type>::max(),
+                "IndexType is too small for the number of elements");
+
+  static constexpr index_type kIndexCount = Size / kElementSize;
+
+  using Control = detail::FreeListControl<
+      index_type, detail::bit_width(kIndexCount - 1), Options>;
+
+  static constexpr bool kOccupancyBitmap = Options::kOccupancyBitmap;
+
+  static constexpr bool kAddressOrdered = Options::kAddressOrdered;
+
+  static_assert(!kAddressOrdered || kOccupancyBitmap,
+                "kAddressOrdered requires kOccupancyBitmap");
+
+  using Ordered = std::integral_constant<bool, kAddressOrdered>;
+
+  using Bitmap = typename std::conditional<
+      kAddressOrdered,
+      detail::OrderedOccupancyBitmap<kIndexCount, Options::kThreadSafe>,
+      typename std::conditional<
+          kOccupancyBitmap,
+          detail::OccupancyBitmap<kIndexCount, Options::kThreadSafe>,
+          detail::NoOccupancyBitmap>::type>::type;
+
+  static constexpr bool kGenerations = Options::kGenerations;
+
+  using Generations = typename std::conditional<
+      kGenerations,
+      detail::GenerationCounters<kIndexCount, Options::kThreadSafe>,
+      detail::NoGenerationCounters>::type;
+
+  static constexpr bool kStats = Options::kStats;
+
+  using Stats = typename std::conditional<
+      kStats,
+      detail::StatsCounters<Options::kThreadSafe, Options::kCacheLineSize>,
+      detail::NoStatsCounters>::type;
+
+  static constexpr std::size_t kEliminationSlots =
+      Options::kThreadSafe ? Options::kEliminationSlots : 0;
+
+  using Elimination = typename std::conditional<
+      kEliminationSlots != 0,
+      detail::EliminationArray<index_type,
+                               kEliminationSlots ? kEliminationSlots : 1,
+                               Options::kCacheLineSize>,
+      detail::NoEliminationArray<index_type>>::type;
+
+  using Contention =
+      detail::Contention<index_type, Elimination, kEliminationSlots != 0>;
+
+  // The bitmap and generation counters, if enabled, follow the control words
+  static constexpr uint64_t kBitmapOffset =
+      kOccupancyBitmap ? detail::round_up(sizeof(Control), alignof(Bitmap))
+                       : 0;
+
+  static constexpr uint64_t kBitmapEnd =
+      kOccupancyBitmap ? kBitmapOffset + sizeof(Bitmap) : sizeof(Control);
+
+  static constexpr uint64_t kGenerationsOffset =
+      kGenerations ? detail::round_up(kBitmapEnd, alignof(Generations)) : 0;
+
+  static constexpr uint64_t kGenerationsEnd =
+      kGenerations ? kGenerationsOffset + sizeof(Generations) : kBitmapEnd;
+
+  static constexpr uint64_t kStatsOffset =
+      kStats ? detail::round_up(kGenerationsEnd, alignof(Stats)) : 0;
+
+  static constexpr uint64_t kStatsEnd =
+      kStats ? kStatsOffset + sizeof(Stats) : kGenerationsEnd;
+
+  static constexpr uint64_t kEliminationOffset =
+      kEliminationSlots ? detail::round_up(kStatsEnd, alignof(Elimination))
+                        : 0;
+
+  static constexpr uint64_t kEliminationEnd =
+      kEliminationSlots ? kEliminationOffset + sizeof(Elimination) : kStatsEnd;
+
+  using AllocatorStateType = detail::AllocatorState<Size, Options>;
+
+  // State shared by all allocators from allocator(), created on first use.
+  // The pointer is stored unaligned behind a flag, so that it adds no
+  // alignment requirement to the FreeList.
+  struct AllocatorSlot {
+    // kNoAllocatorState, kCreatingAllocatorState or kAllocatorStateReady
+    detail::atomic_t<uint8_t, Options::kThreadSafe> flag;
+    unsigned char state[sizeof(AllocatorStateType*)];
+  };
+
+  static constexpr uint8_t kNoAllocatorState = 0;
+  static constexpr uint8_t kCreatingAllocatorState = 1;
+  static constexpr uint8_t kAllocatorStateReady = 2;
+
+  static_assert(alignof(AllocatorSlot) == 1,
+                "AllocatorSlot must not require alignment");
+
+  // In the padding of the control words if it fits, else after the header
+  static constexpr bool kAllocatorInControl =
+      Control::kUsedBytes + sizeof(AllocatorSlot) <= sizeof(Control);
+
+  static constexpr uint64_t kAllocatorOffset =
+      kAllocatorInControl ? Control::kUsedBytes : kEliminationEnd;
+
+  // Only FreeLists of at least 256 bytes with room for an element after it
+  // keep the allocator state, smaller ones give each allocator its own
+  static constexpr bool kAllocatorSlot =
+      Size >= 256 &&
+      (kAllocatorOffset + sizeof(AllocatorSlot) + kElementSize - 1) /
+              kElementSize <
+          kIndexCount;
+
+  static constexpr uint64_t kHeaderSize =
+      kAllocatorSlot && !kAllocatorInControl
+          ? kAllocatorOffset + sizeof(AllocatorSlot)
+          : kEliminationEnd;
+
+  // Layout of a Handle: the index in the low bits, the generation above
+  static constexpr uint32_t kHandleIndexBits =
+      detail::bit_width(kIndexCount - 1);
+  static constexpr uint64_t kHandleIndexMask =
+      (uint64_t(1) << kHandleIndexBits) - 1;
+  static constexpr uint64_t kHandleGenerationMask =
+      kHandleIndexBits <= 32 ? 0xFFFFFFFFu : ~uint64_t(0) >> kHandleIndexBits;
+
+  union alignas(Control) alignas(Element) alignas(Bitmap)
+      alignas(Generations) alignas(Stats) alignas(Elimination) _data {
+    // Define empty constructor and destructor - defaults are ill-formed
+    _data() {}
+    ~_data() {}
+
+    Control control;
+    Element elements[kIndexCount];
+    // Pad to Size, in case it is not a multiple of kElementSize
+    uint8_t bytes[Size];
+  } data;
+
+  static constexpr index_type kElementOverheadCount =
+      (kHeaderSize + kElementSize - 1) / kElementSize;
+
+  static_assert(!kOccupancyBitmap || Size % alignof(Bitmap) == 0,
+                "Size must be a multiple of 8 (for kOccupancyBitmap)");
+
+  static_assert(!kGenerations || Size % alignof(Generations) == 0,
+                "Size must be a multiple of 4 (for kGenerations)");
+
+  static_assert(!kStats || Size % alignof(Stats) == 0,
+                "Size must be a multiple of kCacheLineSize (for kStats)");
+
+  static_assert(!kEliminationSlots || Size % alignof(Elimination) == 0,
+                "Size must be a multiple of kCacheLineSize (for "
+                "kEliminationSlots)");
+
+  static_assert(!Options::kCacheLineAligned ||
+                    Size % Options::kCacheLineSize == 0,
+                "Size must be a multiple of kCacheLineSize (for "
+                "kCacheLineAligned)");
+
+  static_assert(alignof(data.control) < sizeof(T) ||
+                    Size % alignof(data.control) == 0 ||
+                    sizeof(index_type) != 1,
+                "Size must be a multiple of 2 (for Size <= 256)");
+  static_assert(alignof(data.control) < sizeof(T) ||
+                    Size % alignof(data.control) == 0 ||
+                    sizeof(index_type) != 2,
+                "Size must be a multiple of 4 (for Size <= 131072)");
+  static_assert(alignof(data.control) < sizeof(T) ||
+                    Size % alignof(data.control) == 0 ||
+                    sizeof(index_type) != 4,
+                "Size must be a multiple of 8 (for Size <= 17179869184)");
+  static_assert(alignof(data.control) < sizeof(T) ||
+                    Size % alignof(data.control) == 0 ||
+                    sizeof(index_type) != 8,
+                "Size must be a multiple of 8 (for Size > 17179869184)");
+
+  static_assert(alignof(data.control) >= sizeof(T) || Size % alignof(T) == 0,
+                "Size must be a multiple of alignof(T)");
+
+  static_assert(kIndexCount > kElementOverheadCount,
+                "FreeList is too small to contain an element");
+
+  // Returns a chain of n items, linked from head to tail via Element::index,
+  // to the free list with a single atomic update
+  inline void pop_chain(index_type head, index_type tail,
+                        size_type n) noexcept;
+
+  // The statistics counters; if disabled, a stand-in with no state
+  Stats& stats() noexcept {
+    return *reinterpret_cast<Stats*>(data.bytes + kStatsOffset);
+  }
+  Stats const& stats() const noexcept {
+    return *reinterpret_cast<Stats const*>(data.bytes + kStatsOffset);
+  }
+
+  // The elimination slots; if disabled, a stand-in with no state
+  Elimination& elimination() noexcept {
+    return *reinterpret_cast<Elimination*>(data.bytes + kEliminationOffset);
+  }
+
+  AllocatorSlot& allocator_slot() noexcept {
+    return *reinterpret_cast<AllocatorSlot*>(data.bytes + kAllocatorOffset);
+  }
+
+  // The state shared by all allocators, created on first use, or a new state
+  // owned by the result if the FreeList has no room for it
+  inline std::shared_ptr<AllocatorStateType> allocator_state();
+
+  // make_shared() with control blocks from a sibling FreeList of the
+  // allocator state, or from std::allocator if there is no allocator slot
+  template <typename... Args>
+  inline std::shared_ptr<T> make_shared_default(std::true_type,
+                                                Args&&... args);
+  template <typename... Args>
+  inline std::shared_ptr<T> make_shared_default(std::false_type,
+                                                Args&&... args);
+
+  // Contention handling for the control words, nullptr if not needed
+  static Contention* contention_ptr(Contention& contention) noexcept {
+    return kStats || kEliminationSlots ? &contention : nullptr;
+  }
+
+  // Records the allocation of n items, or a failure if n is 0
+  inline void record_alloc(size_type n, uint32_t retries) noexcept {
+    if (!kStats) return;
+    if (n) {
+      stats().record_alloc(n, retries);
+      const size_type s = size();
+      stats().update_peak_size(s < max_size() ? s : max_size());
+    } else {
+      stats().record_failure(retries);
+    }
+  }
+
+  // The occupancy bitmap; if disabled, a stand-in with no state
+  Bitmap& bitmap() noexcept {
+    return *reinterpret_cast<Bitmap*>(data.bytes + kBitmapOffset);
+  }
+  Bitmap const& bitmap() const noexcept {
+    return *reinterpret_cast<Bitmap const*>(data.bytes + kBitmapOffset);
+  }
+
+  // The generation counters; if disabled, a stand-in with no state
+  Generations& generations() noexcept {
+    return *reinterpret_cast<Generations*>(data.bytes + kGenerationsOffset);
+  }
+  Generations const& generations() const noexcept {
+    return *reinterpret_cast<Generations const*>(data.bytes +
+                                                 kGenerationsOffset);
+  }
+
+  // Calls f(index) for each active element, in address order
+  template <typename F>
+  inline void for_each_index(F&& f) {
+    for_each_index(std::forward<F>(f),
+                   std::integral_constant<bool, kOccupancyBitmap>());
+  }
+  template <typename F>
+  inline void for_each_index(F&& f, std::false_type);
+  template <typename F>
+  inline void for_each_index(F&& f, std::true_type);
+
+  // Take and return elements via the free list, or via the bitmap if Ordered
+  inline index_type take_index(index_type hint, std::false_type) noexcept;
+  inline index_type take_index(index_type hint, std::true_type) noexcept;
+  inline void return_index(index_type index, std::false_type) noexcept;
+  inline void return_index(index_type index, std::true_type) noexcept;
+  inline index_type take_fresh(size_type n, std::false_type) noexcept;
+  inline index_type take_fresh(size_type n, std::true_type) noexcept;
+
+  // Sorts the free list, or if Ordered builds it from the bitmap, for live()
+  inline index_type free_chain(std::false_type) noexcept {
+    return data.control.sort_free_list(data.elements);
+  }
+  inline index_type free_chain(std::true_type) noexcept;
+};
+
+template <typename T, uint64_t Size, typename Options>
+FreeList<T, Size, Options>::FreeList() {
+  if (kOccupancyBitmap) {
+    new (data.bytes + kBitmapOffset) Bitmap();
+  }
+  if (kGenerations) {
+    new (data.bytes + kGenerationsOffset) Generations();
+  }
+  if (kStats) {
+    new (data.bytes + kStatsOffset) Stats();
+  }
+  if (kEliminationSlots) {
+    new (data.bytes + kEliminationOffset) Elimination();
+  }
+  if (kAllocatorSlot) {
+    new (data.bytes + kAllocatorOffset) AllocatorSlot();
+    allocator_slot().flag.store(kNoAllocatorState, std::memory_order_relaxed);
+  }
+  bitmap().clear();
+  generations().clear();
+  stats().clear();
+  elimination().clear();
+  data.control.reset(kElementOverheadCount);
+}
+
+template <typename T, uint64_t Size, typename Options>
+FreeList<T, Size, Options>::~FreeList() noexcept {
+  clear();
+  if (!kAllocatorSlot) return;
+  AllocatorSlot& slot = allocator_slot();
+  if (slot.flag.load(std::memory_order_acquire) == kAllocatorStateReady) {
+    AllocatorStateType* state;
+    std::memcpy(&state, slot.state, sizeof(state));
+    delete state;
+  }
+}
+
+template <typename T, uint64_t Size, typename Options>
+std::shared_ptr<typename FreeList<T, Size, Options>::AllocatorStateType>
+FreeList<T, Size, Options>::allocator_state() {
+  if (!kAllocatorSlot) {
+    return std::make_shared<AllocatorStateType>(*this);
+  }
+
+  AllocatorSlot& slot = allocator_slot();
+  for (;;) {
+    // Acquire, so that the pointer and the state are visible once ready
+    uint8_t flag = slot.flag.load(std::memory_order_acquire);
+    if (flag == kAllocatorStateReady) break;
+    if (flag == kNoAllocatorState &&
+        slot.flag.compare_exchange_strong(flag, kCreatingAllocatorState,
+                                          std::memory_order_acquire)) {
+      AllocatorStateType* state;
+      try {
+        state = new AllocatorStateType(*this);
+      } catch (...) {
+        slot.flag.store(kNoAllocatorState, std::memory_order_release);
+        throw;
+      }
+      std::memcpy(slot.state, &state, sizeof(state));
+      slot.flag.store(kAllocatorStateReady, std::memory_order_release);
+      break;
+    }
+    // Another thread is creating the state
+    std::this_thread::yield();
+  }
+  AllocatorStateType* state;
+  std::memcpy(&state, slot.state, sizeof(state));
+  // Owned by the FreeList: alias an empty pointer, so copies count nothing
+  return std::shared_ptr<AllocatorStateType>(
+      std::shared_ptr<AllocatorStateType>(), state);
+}
+
+template <typename T, uint64_t Size, typename Options>
+bool FreeList<T, Size, Options>::empty() const noexcept {
+  return data.control.size() == 0;
+}
+
+template <typename T, uint64_t Size, typename Options>
+bool FreeList<T, Size, Options>::full() const noexcept {
+  return data.control.size() >= max_size();
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::index_type
+FreeList<T, Size, Options>::size() const noexcept {
+  return data.control.size();
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::index_type
+FreeList<T, Size, Options>::max_size() noexcept {
+  return kIndexCount - kElementOverheadCount;
+}
+
+template <typename T, uint64_t Size, typename Options>
+void FreeList<T, Size, Options>::clear() noexcept {
+  // Items without destructors need not be found
+  if (!std::is_trivially_destructible<T>::value && !empty()) {
+    Element* elements = data.elements;
+    for_each_index([elements](index_type i) noexcept {
+      // Call destructor
+      elements[i].data.~T();
+    });
+  }
+
+  // Invalidate the handles of all items; the counters are kept
+  const index_type used = data.control.next_index(kIndexCount);
+  generations().bump_range(kElementOverheadCount, used);
+  if (kStats) {
+    stats().record_free(size(), 0);
+    stats().update_peak_used(used - kElementOverheadCount);
+  }
+  bitmap().clear();
+  data.control.reset(kElementOverheadCount);
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::Handle
+FreeList<T, Size, Options>::handle(T const* item) const noexcept {
+  static_assert(kGenerations, "handle requires kGenerations");
+  const index_type i = index(item);
+  const uint64_t generation = generations().load(i) & kHandleGenerationMask;
+  return Handle((generation << kHandleIndexBits) | i);
+}
+
+template <typename T, uint64_t Size, typename Options>
+T* FreeList<T, Size, Options>::try_get(const Handle handle) noexcept {
+  return const_cast<T*>(static_cast<this_type const*>(this)->try_get(handle));
+}
+
+template <typename T, uint64_t Size, typename Options>
+T const* FreeList<T, Size, Options>::try_get(const Handle handle) const
+    noexcept {
+  static_assert(kGenerations, "try_get requires kGenerations");
+  const uint64_t i = handle.value() & kHandleIndexMask;
+  if (i < kElementOverheadCount || i >= kIndexCount) {
+    return nullptr;
+  }
+  const uint64_t generation = generations().load(i) & kHandleGenerationMask;
+  if (generation != handle.value() >> kHandleIndexBits) {
+    return nullptr;
+  }
+  return get(static_cast<index_type>(i));
+}
+
+template <typename T, uint64_t Size, typename Options>
+FreeListStats FreeList<T, Size, Options>::snapshot() const noexcept {
+  static_assert(kStats, "snapshot requires kStats");
+  FreeListStats result = FreeListStats();
+  stats().snapshot(result);
+  result.size = size();
+  result.capacity = capacity();
+  const uint64_t used =
+      data.control.next_index(kIndexCount) - kElementOverheadCount;
+  if (used > result.peak_used) result.peak_used = used;
+  return result;
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::LiveRange
+FreeList<T, Size, Options>::live() noexcept {
+  using iterator = typename LiveRange::iterator;
+  const index_type free = free_chain(Ordered());
+  const index_type used = data.control.next_index(kIndexCount);
+  // Indexes held by a ThreadCache are active but not live
+  assert(!kOccupancyBitmap ||
+         bitmap().count(kElementOverheadCount, used) == size());
+  return LiveRange(iterator(data.elements, kElementOverheadCount, free, used),
+                   iterator(data.elements, used, 0, used));
+}
+
+template <typename T, uint64_t Size, typename Options>
+template <typename F>
+void FreeList<T, Size, Options>::for_each_live(F&& f) {
+  Element* elements = data.elements;
+  for_each_index([elements, &f](index_type i) { f(elements[i].data); });
+}
+
+template <typename T, uint64_t Size, typename Options>
+bool FreeList<T, Size, Options>::is_live(const index_type index) const
+    noexcept {
+  static_assert(kOccupancyBitmap, "is_live requires kOccupancyBitmap");
+  assert(index < kIndexCount);
+  return bitmap().test(index);
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::size_type
+FreeList<T, Size, Options>::count_live(const index_type first,
+                                       const index_type last) const noexcept {
+  static_assert(kOccupancyBitmap, "count_live requires kOccupancyBitmap");
+  return bitmap().count(first, last < kIndexCount ? last : kIndexCount);
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::index_type
+FreeList<T, Size, Options>::find_live(const index_type first) const noexcept {
+  static_assert(kOccupancyBitmap, "find_live requires kOccupancyBitmap");
+  const uint64_t found = bitmap().find(first, kIndexCount);
+  return found < kIndexCount ? static_cast<index_type>(found) : 0;
+}
+
+template <typename T, uint64_t Size, typename Options>
+template <typename F>
+void FreeList<T, Size, Options>::for_each_index(F&& f, std::false_type) {
+  data.control.for_each_active(data.elements, kElementOverheadCount,
+                               kIndexCount, std::forward<F>(f));
+}
+
+template <typename T, uint64_t Size, typename Options>
+template <typename F>
+void FreeList<T, Size, Options>::for_each_index(F&& f, std::true_type) {
+  // Bits are only set below the never-used elements
+  bitmap().for_each(kElementOverheadCount, data.control.next_index(kIndexCount),
+                    [&f](uint64_t i) { f(static_cast<index_type>(i)); });
+}
+
+template <typename T, uint64_t Size, typename Options>
+template <typename... Args>
+T* FreeList<T, Size, Options>::alloc(Args&&... args) {
+  index_type index = push_index();
+  if (!index) {
+    throw std::bad_alloc();
+  }
+
+  // placement-new the item
+  return detail::construct<T>(
+      get(index), [this, index]() { pop_index(index); },
+      std::forward<Args>(args)...);
+}
+
+template <typename T, uint64_t Size, typename Options>
+template <typename... Args>
+T* FreeList<T, Size, Options>::alloc_near(T const* hint, Args&&... args) {
+  const index_type near = hint ? this->index(hint) : 0;
+  index_type index = push_index_near(near);
+  if (!index) {
+    throw std::bad_alloc();
+  }
+
+  // placement-new the item
+  return detail::construct<T>(
+      get(index), [this, index]() { pop_index(index); },
+      std::forward<Args>(args)...);
+}
+
+template <typename T, uint64_t Size, typename Options>
+template <typename... Args>
+T* FreeList<T, Size, Options>::alloc_prefetched(Args&&... args) {
+  index_type index = push_index();
+  if (!index) {
+    throw std::bad_alloc();
+  }
+
+  // Warm the following element while this item is constructed
+  if (index_type following = data.control.next_hint(kIndexCount)) {
+    detail::prefetch_for_write<Options::kCacheLineSize>(
+        &data.elements[following], kElementSize);
+  }
+
+  // placement-new the item
+  return detail::construct<T>(
+      get(index), [this, index]() { pop_index(index); },
+      std::forward<Args>(args)...);
+}
+
+template <typename T, uint64_t Size, typename Options>
+template <typename... Args>
+typename FreeList<T, Size, Options>::index_type
+FreeList<T, Size, Options>::emplace(Args&&... args) noexcept(
+    std::is_nothrow_constructible<T, Args&&...>::value) {
+  index_type index = push_index();
+  if (index) {
+    // placement-new the item
+    detail::construct<T>(
+        get(index), [this, index]() { pop_index(index); },
+        std::forward<Args>(args)...);
+  }
+  return index;
+}
+
+template <typename T, uint64_t Size, typename Options>
+template <typename... Args>
+typename FreeList<T, Size, Options>::UniquePtr
+FreeList<T, Size, Options>::make_unique(Args&&... args) {
+  T* ptr = alloc(std::forward<Args>(args)...);
+  return UniquePtr(ptr, deleter());
+}
+
+template <typename T, uint64_t Size, typename Options>
+template <typename... Args>
+std::shared_ptr<T> FreeList<T, Size, Options>::make_shared(Args&&... args) {
+  return make_shared_default(std::integral_constant<bool, kAllocatorSlot>(),
+                             std::forward<Args>(args)...);
+}
+
+template <typename T, uint64_t Size, typename Options>
+template <typename... Args>
+std::shared_ptr<T> FreeList<T, Size, Options>::make_shared_default(
+    std::true_type, Args&&... args) {
+  using ControlBlockAllocator =
+      detail::ControlBlockAllocator<T, Size, Options,
+                                    kIndexCount - kElementOverheadCount>;
+  // The state is owned by this FreeList, the pointer stays valid
+  return make_shared(std::allocator_arg,
+                     ControlBlockAllocator(*allocator_state()),
+                     std::forward<Args>(args)...);
+}
+
+template <typename T, uint64_t Size, typename Options>
+template <typename... Args>
+std::shared_ptr<T> FreeList<T, Size, Options>::make_shared_default(
+    std::false_type, Args&&... args) {
+  return make_shared(std::allocator_arg, std::allocator<T>(),
+                     std::forward<Args>(args)...);
+}
+
+template <typename T, uint64_t Size, typename Options>
+template <typename Alloc, typename... Args>
+std::shared_ptr<T> FreeList<T, Size, Options>::make_shared(
+    std::allocator_arg_t, Alloc allocator, Args&&... args) {
+  // If allocating the control block throws, the deleter frees the item
+  return std::shared_ptr<T>(alloc(std::forward<Args>(args)...), deleter(),
+                            allocator);
+}
+
+template <typename T, uint64_t Size, typename Options>
+template <typename... Args>
+typename FreeList<T, Size, Options>::SharedHandle
+FreeList<T, Size, Options>::make_handle(Args&&... args) {
+  return SharedHandle(alloc(std::forward<Args>(args)...), deleter());
+}
+
+template <typename T, uint64_t Size, typename Options>
+template <typename... Args>
+void FreeList<T, Size, Options>::alloc_n(T** out, size_type n,
+                                         Args&&... args) {
+  size_type done = 0;
+  try {
+    while (done < n) {
+      index_type indices[kBatchSize];
+      const size_type wanted =
+          (n - done) < kBatchSize ? (n - done) : kBatchSize;
+      const size_type got = push_indices(indices, wanted);
+
+      size_type constructed = 0;
+      try {
+        for (; constructed < got; ++constructed) {
+          // placement-new the item
+          out[done + constructed] = new (get(indices[constructed])) T(args...);
+        }
+      } catch (...) {
+        pop_indices(indices + constructed, got - constructed);
+        done += constructed;
+        throw;
+      }
+      done += got;
+
+      if (got < wanted) {
+        throw std::bad_alloc();
+      }
+    }
+  } catch (...) {
+    free_n(out, done);
+    throw;
+  }
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::index_type
+FreeList<T, Size, Options>::push_index() noexcept {
+  return take_index(0, Ordered());
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::index_type
+FreeList<T, Size, Options>::push_index_near(const index_type hint) noexcept {
+  static_assert(kAddressOrdered, "push_index_near requires kAddressOrdered");
+  return take_index(hint, Ordered());
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::index_type
+FreeList<T, Size, Options>::take_index(index_type, std::false_type) noexcept {
+  Contention contention(elimination());
+  const index_type index = data.control.push_index(
+      data.elements, kIndexCount, contention_ptr(contention));
+  if (index) bitmap().set(index);
+  record_alloc(index ? 1 : 0, contention.retry_count());
+  return index;
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::index_type
+FreeList<T, Size, Options>::take_index(const index_type hint,
+                                       std::true_type) noexcept {
+  const index_type index = data.control.push_ordered(
+      bitmap(), kElementOverheadCount, kIndexCount, hint);
+  record_alloc(index ? 1 : 0, 0);
+  return index;
+}
+
+template <typename T, uint64_t Size, typename Options>
+void FreeList<T, Size, Options>::return_index(const index_type index,
+                                              std::false_type) noexcept {
+  // Clear the bit first, the element may be reused once it is returned
+  bitmap().reset(index);
+  generations().bump(index);
+  pop_chain(index, index, 1);
+}
+
+template <typename T, uint64_t Size, typename Options>
+void FreeList<T, Size, Options>::return_index(const index_type index,
+                                              std::true_type) noexcept {
+  assert(index >= kElementOverheadCount);
+  assert(index < kIndexCount);
+  generations().bump(index);
+  data.control.pop_ordered(bitmap(), index);
+  stats().record_free(1, 0);
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::index_type
+FreeList<T, Size, Options>::take_fresh(const size_type n,
+                                       std::false_type) noexcept {
+  const index_type first = data.control.reserve_fresh(kIndexCount, n);
+  if (first) bitmap().set_range(first, n);
+  if (n) record_alloc(first ? n : 0, 0);
+  return first;
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::index_type
+FreeList<T, Size, Options>::take_fresh(const size_type n,
+                                       std::true_type) noexcept {
+  const index_type first =
+      data.control.reserve_ordered(bitmap(), kIndexCount, n);
+  if (n) record_alloc(first ? n : 0, 0);
+  return first;
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::index_type
+FreeList<T, Size, Options>::free_chain(std::true_type) noexcept {
+  // Link the free elements in address order; their index is otherwise unused
+  index_type list = 0;
+  const index_type used = data.control.next_index(kIndexCount);
+  for (index_type i = used; i-- > kElementOverheadCount;) {
+    if (!bitmap().test(i)) {
+      data.elements[i].index = list;
+      list = i;
+    }
+  }
+  return list;
+}
+
+template <typename T, uint64_t Size, typename Options>
+void FreeList<T, Size, Options>::free(T* item) noexcept {
+  assert(item);
 
   // placement-delete the item
   item->~T();
   pop_index(index(item));
 };
 
-template <typename T, uint64_t Size>
-void FreeList<T, Size>::pop_index(const index_type index) noexcept {
+template <typename T, uint64_t Size, typename Options>
+void FreeList<T, Size, Options>::pop_index(const index_type index) noexcept {
+  return_index(index, Ordered());
+}
+
+template <typename T, uint64_t Size, typename Options>
+void FreeList<T, Size, Options>::free_n(T* const* items,
+                                        const size_type n) noexcept {
+  if (!n) return;
+
+  if (kAddressOrdered) {
+    // There is no free list to link the items into
+    for (size_type i = 0; i < n; ++i) {
+      free(items[i]);
+    }
+    return;
+  }
+
+  // Destruct the items and link them together into a chain
+  for (size_type i = 0; i < n; ++i) {
+    assert(items[i]);
+    items[i]->~T();
+    bitmap().reset(index(items[i]));
+    generations().bump(index(items[i]));
+    if (i) {
+      data.elements[index(items[i - 1])].index = index(items[i]);
+    }
+  }
+  pop_chain(index(items[0]), index(items[n - 1]), n);
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::size_type
+FreeList<T, Size, Options>::push_indices(index_type* out,
+                                         const size_type n) noexcept {
+  if (kAddressOrdered) {
+    for (size_type got = 0; got < n; ++got) {
+      const index_type index = push_index();
+      if (!index) return got;
+      out[got] = index;
+    }
+    return n;
+  }
+
+  Contention contention(elimination());
+  const size_type got = data.control.push_indices(
+      data.elements, kElementOverheadCount, kIndexCount, out, n,
+      contention_ptr(contention));
+  for (size_type i = 0; i < got; ++i) {
+    bitmap().set(out[i]);
+  }
+  if (n) record_alloc(got, contention.retry_count());
+  return got;
+}
+
+template <typename T, uint64_t Size, typename Options>
+void FreeList<T, Size, Options>::pop_indices(index_type const* in,
+                                             const size_type n) noexcept {
+  if (!n) return;
+
+  if (kAddressOrdered) {
+    for (size_type i = 0; i < n; ++i) {
+      pop_index(in[i]);
+    }
+    return;
+  }
+
+  // Link the items together into a chain before publishing it
+  for (size_type i = 0; i < n; ++i) {
+    assert(in[i] >= kElementOverheadCount);
+    assert(in[i] < kIndexCount);
+    bitmap().reset(in[i]);
+    generations().bump(in[i]);
+    if (i + 1 < n) data.elements[in[i]].index = in[i + 1];
+  }
+  pop_chain(in[0], in[n - 1], n);
+}
+
+template <typename T, uint64_t Size, typename Options>
+void FreeList<T, Size, Options>::retire_index(const index_type index) noexcept {
+  static_assert(!kAddressOrdered,
+                "retire_index cannot be used with kAddressOrdered");
   assert(index >= kElementOverheadCount);
   assert(index < kIndexCount);
+  bitmap().reset(index);
+  generations().bump(index);
+}
 
-  // We need to atomically:
-  // - read the current value of the free index
-  // - set the newly-freed-element to contain that free index
-  // - change the free index to point to the newly-freed-element
-  // - include a tag increment to avoid ABA problem
-  index_type& freedElement = data.elements[index].index;
+template <typename T, uint64_t Size, typename Options>
+void FreeList<T, Size, Options>::revive_index(const index_type index) noexcept {
+  static_assert(!kAddressOrdered,
+                "revive_index cannot be used with kAddressOrdered");
+  assert(index >= kElementOverheadCount);
+  assert(index < kIndexCount);
+  bitmap().set(index);
+}
 
-  ControlFlags currFlags = data.control.load();
-  ControlFlags newFlags;
-  do {
-    newFlags = currFlags;
-    freedElement = currFlags.free;
-    newFlags.free = index;
-    ++newFlags.tag;
-    --newFlags.count;
-  } while (!data.control.compare_exchange_strong(currFlags, newFlags));
+template <typename T, uint64_t Size, typename Options>
+void FreeList<T, Size, Options>::pop_chain(const index_type head,
+                                           const index_type tail,
+                                           const size_type n) noexcept {
+  assert(head >= kElementOverheadCount);
+  assert(head < kIndexCount);
+  assert(tail >= kElementOverheadCount);
+  assert(tail < kIndexCount);
+  Contention contention(elimination());
+  data.control.pop_chain(data.elements, head, tail, n,
+                         contention_ptr(contention));
+  stats().record_free(n, contention.retry_count());
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::index_type
+FreeList<T, Size, Options>::reserve_fresh(const size_type n) noexcept {
+  return take_fresh(n, Ordered());
 }
 
-template <typename T, uint64_t Size>
-T const* FreeList<T, Size>::get(index_type index) const {
+template <typename T, uint64_t Size, typename Options>
+T const* FreeList<T, Size, Options>::get(index_type index) const {
   assert(index >= kElementOverheadCount);
   assert(index < kIndexCount);
   return &data.elements[index].data;
 }
 
-template <typename T, uint64_t Size>
-T* FreeList<T, Size>::get(index_type index) {
+template <typename T, uint64_t Size, typename Options>
+T* FreeList<T, Size, Options>::get(index_type index) {
   assert(index >= kElementOverheadCount);
   assert(index < kIndexCount);
   return &data.elements[index].data;
 }
 
-template <typename T, uint64_t Size>
-typename FreeList<T, Size>::index_type FreeList<T, Size>::index(T* item) {
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::index_type
+FreeList<T, Size, Options>::index(T* item) {
   assert(item);
   assert(reinterpret_cast<void*>(item) >= reinterpret_cast<void*>(this));
   assert((reinterpret_cast<uint8_t*>(item) - reinterpret_cast<uint8_t*>(this)) %
@@ -499,51 +3349,579 @@ typename FreeList<T, Size>::index_type FreeList<T, Size>::index(T* item) {
   return index;
 }
 
-template <typename T, uint64_t Size>
-typename FreeList<T, Size>::index_type FreeList<T, Size>::index(
-    T const* item) const {
+template <typename T, uint64_t Size, typename Options>
+typename FreeList<T, Size, Options>::index_type
+FreeList<T, Size, Options>::index(T const* item) const {
   return const_cast<this_type*>(this)->index(const_cast<T*>(item));
 }
 
-template <typename T, uint64_t Size>
+/**
+ * Function object that frees items from a FreeList, for use with
+ * std::unique_ptr. Holds only a pointer to the FreeList.
+ */
+template <typename T, uint64_t Size, typename Options>
+class FreeListDeleter {
+ public:
+  using FreeListType = FreeList<T, Size, Options>;
+
+  /**
+   * Construct a deleter without a FreeList, which must not be called.
+   */
+  FreeListDeleter() noexcept : parent(nullptr) {}
+
+  explicit FreeListDeleter(FreeListType& parent) noexcept : parent(&parent) {}
+
+  void operator()(T* item) const noexcept {
+    assert(parent);
+    parent->free(item);
+  }
+
+ private:
+  FreeListType* parent;
+};
+
+/**
+ * Empty function object that frees items from a FreeList, for use with
+ * std::unique_ptr. The FreeList is found by rounding the address of the item
+ * down to a multiple of Size, so this may only be used with FreeLists placed at
+ * an address aligned to Size, such as the slabs of a GrowableFreeList.
+ */
+template <typename T, uint64_t Size, typename Options>
+class AlignedFreeListDeleter {
+  static_assert((Size & (Size - 1)) == 0,
+                "AlignedFreeListDeleter requires Size to be a power of two");
+
+ public:
+  using FreeListType = FreeList<T, Size, Options>;
+
+  /**
+   * Get the FreeList containing an item.
+   * @param item Pointer to an item in a FreeList aligned to Size.
+   * @return The FreeList.
+   */
+  static FreeListType* parent(T const* item) noexcept {
+    return reinterpret_cast<FreeListType*>(reinterpret_cast<uintptr_t>(item) &
+                                           ~static_cast<uintptr_t>(Size - 1));
+  }
+
+  void operator()(T* item) const noexcept { parent(item)->free(item); }
+};
+
+/**
+ * Base class for items managed by SharedHandle, holding the reference count
+ * within the item. Copying an item does not copy its reference count.
+ */
+class RefCounted {
+ public:
+  /**
+   * Get the number of SharedHandles referring to this item.
+   * @return Reference count.
+   */
+  uint32_t use_count() const noexcept {
+    return refCount.load(std::memory_order_relaxed);
+  }
+
+ protected:
+  RefCounted() noexcept : refCount(0) {}
+  RefCounted(RefCounted const&) noexcept : refCount(0) {}
+  RefCounted& operator=(RefCounted const&) noexcept { return *this; }
+  ~RefCounted() = default;
+
+ private:
+  template <typename, typename>
+  friend class SharedHandle;
+
+  mutable std::atomic<uint32_t> refCount;
+};
+
+/**
+ * Shared pointer to an item derived from RefCounted. The reference count is
+ * stored in the item, so no control block is allocated, and the handle holds
+ * only the item pointer and the deleter. The deleter is called when the last
+ * handle is destroyed.
+ * @tparam T Type of item, derived from RefCounted.
+ * @tparam Deleter Function object to free the item, such as FreeListDeleter.
+ */
+template <typename T, typename Deleter>
+class SharedHandle : private Deleter {
+ public:
+  using element_type = T;
+  using deleter_type = Deleter;
+
+  SharedHandle() noexcept : item(nullptr) {}
+
+  /**
+   * Take shared ownership of an item.
+   * @param item Item to own, or nullptr.
+   * @param deleter Function object to free the item.
+   */
+  SharedHandle(T* item, Deleter deleter) noexcept
+      : Deleter(std::move(deleter)), item(item) {
+    static_assert(std::is_base_of<RefCounted, T>::value,
+                  "SharedHandle requires T to derive from RefCounted");
+    acquire();
+  }
+
+  SharedHandle(SharedHandle const& other) noexcept
+      : Deleter(other), item(other.item) {
+    acquire();
+  }
+
+  SharedHandle(SharedHandle&& other) noexcept
+      : Deleter(std::move(other)), item(other.item) {
+    other.item = nullptr;
+  }
+
+  SharedHandle& operator=(SharedHandle other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~SharedHandle() { release(); }
+
+  /**
+   * Release ownership of the item, freeing it if this was the last handle.
+   */
+  void reset() noexcept { SharedHandle().swap(*this); }
+
+  void swap(SharedHandle& other) noexcept {
+    using std::swap;
+    swap(static_cast<Deleter&>(*this), static_cast<Deleter&>(other));
+    swap(item, other.item);
+  }
+
+  T* get() const noexcept { return item; }
+  T& operator*() const noexcept { return *item; }
+  T* operator->() const noexcept { return item; }
+  explicit operator bool() const noexcept { return item != nullptr; }
+
+  /**
+   * Get the number of SharedHandles referring to the item.
+   * @return Reference count, or 0 if this handle is empty.
+   */
+  uint32_t use_count() const noexcept { return item ? item->use_count() : 0; }
+
+  friend bool operator==(SharedHandle const& a, SharedHandle const& b) {
+    return a.item == b.item;
+  }
+
+  friend bool operator!=(SharedHandle const& a, SharedHandle const& b) {
+    return a.item != b.item;
+  }
+
+ private:
+  void acquire() noexcept {
+    if (item) item->refCount.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void release() noexcept {
+    // Acquire-release, so that all uses of the item happen before its deletion
+    if (item && item->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      static_cast<Deleter&>(*this)(item);
+    }
+  }
+
+  T* item;
+};
+
+namespace detail {
+
+/**
+ * Storage for an object of the given size and alignment.
+ */
+template <std::size_t Bytes, std::size_t Align>
+struct alignas(Align) RawBlock {
+  unsigned char bytes[Bytes];
+};
+
+/**
+ * Options of the sibling FreeLists holding std::shared_ptr control blocks,
+ * see ControlBlockAllocator.
+ */
+template <bool ThreadSafe>
+struct ControlBlockOptions : FreeListOptions {
+  static constexpr bool kThreadSafe = ThreadSafe;
+};
+
+}  // namespace detail
+
+namespace detail {
+
+/**
+ * Source of fixed-size slots for FreeListAllocator: either the FreeList the
+ * allocator was created from, or a sibling FreeList created for one node size.
+ */
+struct AllocatorSlots {
+  // Size and alignment of each slot
+  std::size_t bytes;
+  std::size_t align;
+  // Size of the FreeList in bytes
+  uint64_t size;
+  void* freeList;
+  // Take a slot, or return nullptr if the FreeList is full
+  void* (*take)(void* freeList) noexcept;
+  // Return a slot
+  void (*give)(void* freeList, void* slot) noexcept;
+  // Destroy and deallocate freeList, or nullptr if not owned
+  void (*destroy)(void* freeList) noexcept;
+  AllocatorSlots* next;
+
+  template <typename FreeListType>
+  static void* take_slot(void* freeList) noexcept {
+    FreeListType* fl = static_cast<FreeListType*>(freeList);
+    typename FreeListType::index_type index = fl->push_index();
+    return index ? fl->get(index) : nullptr;
+  }
+
+  template <typename FreeListType>
+  static void give_slot(void* freeList, void* slot) noexcept {
+    FreeListType* fl = static_cast<FreeListType*>(freeList);
+    fl->pop_index(fl->index(
+        static_cast<typename FreeListType::value_type*>(slot)));
+  }
+
+  template <typename FreeListType>
+  static void destroy_freelist(void* freeList) noexcept {
+    static_cast<FreeListType*>(freeList)->~FreeListType();
+    aligned_deallocate(freeList);
+  }
+};
+
+/**
+ * State shared by all FreeListAllocators of a FreeList, owned by the FreeList.
+ * Holds the FreeList, sibling FreeLists of Size bytes for each other node
+ * size, and the sibling FreeList of std::shared_ptr control blocks used by
+ * FreeList::make_shared(), all created on first use. Siblings are keyed by
+ * slot size, slot alignment and FreeList size, and are only ever added, so
+ * they can be found without taking the lock.
+ */
+template <uint64_t Size, typename Options>
+class AllocatorState {
+ public:
+  template <typename T>
+  explicit AllocatorState(FreeList<T, Size, Options>& parent) noexcept
+      : slots(nullptr) {
+    using FreeListType = FreeList<T, Size, Options>;
+    parentSlots.bytes = sizeof(T);
+    parentSlots.align = alignof(T);
+    parentSlots.size = Size;
+    parentSlots.freeList = &parent;
+    parentSlots.take = &AllocatorSlots::take_slot<FreeListType>;
+    parentSlots.give = &AllocatorSlots::give_slot<FreeListType>;
+    parentSlots.destroy = nullptr;
+    parentSlots.next = nullptr;
+  }
+
+  AllocatorState(AllocatorState const&) = delete;
+  AllocatorState& operator=(AllocatorState const&) = delete;
+
+  /**
+   * Destroys sibling FreeLists, all of their slots must have been returned.
+   */
+  ~AllocatorState() {
+    AllocatorSlots* s = slots.load(std::memory_order_relaxed);
+    while (s) {
+      AllocatorSlots* next = s->next;
+      s->destroy(s->freeList);
+      delete s;
+      s = next;
+    }
+  }
+
+  /**
+   * Find the slots for objects of type U, without locking or allocating.
+   * @return Slots for U, or nullptr if the sibling FreeList for U has not been
+   * created yet.
+   */
+  template <typename U>
+  AllocatorSlots* find_slots() const noexcept {
+    if (sizeof(U) <= parentSlots.bytes && alignof(U) <= parentSlots.align) {
+      return const_cast<AllocatorSlots*>(&parentSlots);
+    }
+    return find_sibling<U, Size>();
+  }
+
+  /**
+   * Get the slots for objects of type U: the parent FreeList if U fits in its
+   * slots, otherwise a sibling FreeList for the size and alignment of U.
+   * @return Slots for U.
+   * @exception std::bad_alloc If a sibling FreeList cannot be allocated.
+   */
+  template <typename U>
+  AllocatorSlots* slots_for() {
+    AllocatorSlots* found = find_slots<U>();
+    if (found) return found;
+    return sibling_for<U, Size, Options>();
+  }
+
+  /**
+   * Find the sibling FreeList of SiblingSize bytes for objects of type U,
+   * without locking or allocating.
+   * @return Slots for U, or nullptr if the sibling has not been created yet.
+   */
+  template <typename U, uint64_t SiblingSize>
+  AllocatorSlots* find_sibling() const noexcept {
+    using Block = RawBlock<sizeof(U), alignof(U)>;
+    for (AllocatorSlots* s = slots.load(std::memory_order_acquire); s;
+         s = s->next) {
+      if (s->bytes == sizeof(Block) && s->align == alignof(Block) &&
+          s->size == SiblingSize) {
+        return s;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * Get the sibling FreeList of SiblingSize bytes for objects of type U,
+   * creating it on first use. Never the parent FreeList.
+   * @return Slots for U.
+   * @exception std::bad_alloc If the sibling FreeList cannot be allocated.
+   */
+  template <typename U, uint64_t SiblingSize, typename SiblingOptions>
+  AllocatorSlots* sibling_for() {
+    AllocatorSlots* found = find_sibling<U, SiblingSize>();
+    if (found) return found;
+
+    using Block = RawBlock<sizeof(U), alignof(U)>;
+    using FreeListType = FreeList<Block, SiblingSize, SiblingOptions>;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    found = find_sibling<U, SiblingSize>();
+    if (found) return found;
+
+    void* memory =
+        aligned_allocate(sizeof(FreeListType), alignof(FreeListType));
+    if (!memory) throw std::bad_alloc();
+    AllocatorSlots* s;
+    try {
+      s = new AllocatorSlots{sizeof(Block),
+                             alignof(Block),
+                             SiblingSize,
+                             new (memory) FreeListType(),
+                             &AllocatorSlots::take_slot<FreeListType>,
+                             &AllocatorSlots::give_slot<FreeListType>,
+                             &AllocatorSlots::destroy_freelist<FreeListType>,
+                             slots.load(std::memory_order_relaxed)};
+    } catch (...) {
+      AllocatorSlots::destroy_freelist<FreeListType>(memory);
+      throw;
+    }
+    slots.store(s, std::memory_order_release);
+    return s;
+  }
+
+ private:
+  AllocatorSlots parentSlots;
+  // Sibling FreeLists, only added to, with mutex held
+  std::atomic<AllocatorSlots*> slots;
+  std::mutex mutex;
+};
+
+/**
+ * Allocator of the std::shared_ptr control blocks of FreeList::make_shared(),
+ * taking them from a sibling FreeList with room for one control block per
+ * item of a FreeList with Capacity items. The sibling is created on the first
+ * allocate() and destroyed with the FreeList's AllocatorState, so no control
+ * block may outlive the FreeList, just as no item may.
+ *
+ * Only single objects are supported.
+ *
+ * @exception std::bad_alloc From allocate(), for any n other than 1, if the
+ * sibling FreeList is full or if it cannot be allocated.
+ */
+template <typename T, uint64_t Size, typename Options, uint64_t Capacity>
+class ControlBlockAllocator {
+  using State = AllocatorState<Size, Options>;
+  using Block = RawBlock<sizeof(T), alignof(T)>;
+
+  // Capacity blocks, plus enough for the sibling's own header
+  static constexpr uint64_t kSiblingSize =
+      (Capacity + (64 + sizeof(Block) - 1) / sizeof(Block)) * sizeof(Block);
+
+  using SiblingOptions = ControlBlockOptions<Options::kThreadSafe>;
+
+ public:
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = ControlBlockAllocator<U, Size, Options, Capacity>;
+  };
+
+  explicit ControlBlockAllocator(State& state) noexcept : state(&state) {}
+
+  template <typename U>
+  ControlBlockAllocator(
+      ControlBlockAllocator<U, Size, Options, Capacity> const& other) noexcept
+      : state(other.state) {}
+
+  T* allocate(std::size_t n) {
+    if (n != 1) throw std::bad_alloc();
+    AllocatorSlots* slots =
+        state->template sibling_for<T, kSiblingSize, SiblingOptions>();
+    void* slot = slots->take(slots->freeList);
+    if (!slot) throw std::bad_alloc();
+    return static_cast<T*>(slot);
+  }
+
+  void deallocate(T* p, std::size_t) noexcept {
+    // Found without locking, allocate() created it
+    AllocatorSlots* slots = state->template find_sibling<T, kSiblingSize>();
+    slots->give(slots->freeList, p);
+  }
+
+  template <typename U>
+  bool operator==(
+      ControlBlockAllocator<U, Size, Options, Capacity> const& other)
+      const noexcept {
+    return state == other.state;
+  }
+
+  template <typename U>
+  bool operator!=(
+      ControlBlockAllocator<U, Size, Options, Capacity> const& other)
+      const noexcept {
+    return state != other.state;
+  }
+
+ private:
+  template <typename, uint64_t, typename, uint64_t>
+  friend class ControlBlockAllocator;
+
+  State* state;
+};
+
+}  // namespace detail
+
+/**
+ * Allocator using a FreeList, for use with standard containers.
+ *
+ * Single objects of T, or of any type that fits in a slot of the FreeList, are
+ * taken from the FreeList. Node-based containers such as std::list, std::map
+ * and std::unordered_map rebind the allocator to their internal node types;
+ * single nodes of other sizes are taken from sibling FreeLists of Size bytes,
+ * created on first use and shared by all allocators from the same FreeList.
+ * Rebinding finds or creates the sibling FreeList, so deallocate() never locks
+ * or allocates.
+ *
+ * allocate(n) for any n other than 1 silently falls back to ::operator new,
+ * and deallocate() to ::operator delete: arrays, such as the storage of
+ * std::vector or the buckets of std::unordered_map, never come from a
+ * FreeList and are not limited by its Size. A std::vector with a capacity of
+ * exactly one does take a slot.
+ *
+ * The sibling FreeLists are held by a state owned by the FreeList, allocated
+ * by the first allocator created from it and destroyed with it, so no
+ * allocator or container using one may outlive the FreeList. Allocators
+ * compare equal if they share that state, which all allocators from the same
+ * FreeList do, so nodes can be spliced or swapped between containers using
+ * them. FreeLists too small to keep the state give each allocator() its own,
+ * released with the last allocator sharing it; see FreeList::allocator().
+ *
+ * @exception std::bad_alloc From allocate(1), if the FreeList is full, and from
+ * the first constructor call for a FreeList, if the shared state cannot be
+ * allocated.
+ */
+template <typename T, uint64_t Size, typename Options>
 class FreeListAllocator {
  public:
-  using FreeListType = FreeList<T, Size>;
+  using FreeListType = FreeList<T, Size, Options>;
   using value_type = T;
   using pointer = T*;
   using const_pointer = const T*;
   using void_pointer = void*;
-  using size_type = typename FreeListType::size_type;
+  using const_void_pointer = const void*;
+  using size_type = std::size_t;
   using difference_type = std::ptrdiff_t;
 
+  // Containers keep the allocator of the container they were copied, moved or
+  // swapped from, so nodes are always freed to the FreeLists that hold them
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
   template <typename U>
   struct rebind {
-    using other = FreeListAllocator<U, Size>;
+    using other = FreeListAllocator<U, Size, Options>;
   };
 
-  explicit FreeListAllocator(FreeListType& parent) : parent(parent) {}
+  /**
+   * Create an allocator, sharing the sibling FreeLists of parent.
+   * @param parent FreeList to allocate single objects of T from.
+   * @exception std::bad_alloc If the shared state cannot be allocated.
+   */
+  explicit FreeListAllocator(FreeListType& parent)
+      : state(parent.allocator_state()),
+        slots(state->template find_slots<T>()) {}
+
+  /**
+   * Rebind an allocator, sharing its FreeLists, and create the sibling FreeList
+   * for T if needed. If that fails, allocate(1) tries again and throws.
+   */
+  template <typename U>
+  FreeListAllocator(FreeListAllocator<U, Size, Options> const& other) noexcept
+      : state(other.state), slots(nullptr) {
+    try {
+      slots = state->template slots_for<T>();
+    } catch (std::bad_alloc const&) {
+    }
+  }
 
   FreeListAllocator(FreeListAllocator const&) = default;
+  FreeListAllocator& operator=(FreeListAllocator const&) = default;
   ~FreeListAllocator() = default;
 
   T* allocate(std::size_t n) {
     if (n != 1) {
-      throw std::bad_alloc();
+      return static_cast<T*>(::operator new(n * sizeof(T)));
     }
-    typename FreeListType::index_type index = parent.push_index();
-    if (index) {
-      return parent.get(index);
-    } else {
+    if (!slots) {
+      slots = state->template slots_for<T>();
+    }
+    void* slot = slots->take(slots->freeList);
+    if (!slot) {
       throw std::bad_alloc();
     }
+    return static_cast<T*>(slot);
   }
 
-  void deallocate(T* p, std::size_t) noexcept {
-    parent.pop_index(parent.index(p));
+  void deallocate(T* p, std::size_t n) noexcept {
+    if (n != 1) {
+      ::operator delete(p);
+      return;
+    }
+    // The slots exist, as p was taken from them by allocate(1) of an allocator
+    // sharing this state, so they are found without locking
+    if (!slots) {
+      slots = state->template find_slots<T>();
+    }
+    slots->give(slots->freeList, p);
+  }
+
+  template <typename U>
+  bool operator==(FreeListAllocator<U, Size, Options> const& other) const
+      noexcept {
+    return state == other.state;
+  }
+
+  template <typename U>
+  bool operator!=(FreeListAllocator<U, Size, Options> const& other) const
+      noexcept {
+    return !(*this == other);
   }
 
  private:
-  FreeListType& parent;
+  template <typename, uint64_t, typename>
+  friend class FreeListAllocator;
+
+  using State = detail::AllocatorState<Size, Options>;
+
+  // Owned by the parent FreeList, see FreeList::allocator()
+  std::shared_ptr<State> state;
+  // Slots for single objects, found on construction or first allocate(1)
+  detail::AllocatorSlots* slots;
 };
 
 }  // namespace freelist
@@ -0,0 +1,561 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INCLUDE_FREELIST_FREELIST_VIEW_H_
+#define INCLUDE_FREELIST_FREELIST_VIEW_H_
+
+#include <freelist/freelist.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace freelist {
+
+/**
+ * FreeListView runs the FreeList algorithm over memory provided by the caller,
+ * for example memory from mmap, huge pages or NUMA-local allocations. The
+ * capacity is decided at runtime from the size of the buffer.
+ *
+ * The control words are stored at the start of the buffer, followed by the
+ * elements. The FreeListView owns neither the buffer nor the items: the
+ * destructor does not destroy items, call clear() first if required. Copies
+ * of a FreeListView refer to the same buffer.
+ *
+ * The buffer contains no pointers, so it may be shared between processes and
+ * mapped at different addresses in each, see attach() and
+ * SharedMemoryFreeList. Indexes are then valid in all processes, while
+ * pointers from get() and alloc() are only valid in the calling process.
+ *
+ * @tparam T Data type to store.
+ * @tparam Options Compile-time options, see FreeListOptions. Only
+ * kThreadSafe, kCacheLineAligned, kCacheLineSize and kPrefetch are used, with
+ * HeadType and CountType; kOccupancyBitmap, kGenerations, kStats,
+ * kAddressOrdered and kEliminationSlots are ignored, and indexes are always
+ * uint32_t whatever IndexType is.
+ */
+template <typename T, typename Options = FreeListOptions>
+class FreeListView {
+ public:
+  static_assert(!std::is_abstract<T>::value,
+                "Stored data type must not be abstract");
+
+  /**
+   * Type that is stored in each active element.
+   */
+  using value_type = T;
+
+  using this_type = FreeListView<T, Options>;
+
+  using options_type = Options;
+
+  /**
+   * Type used for storing indexes. Up to 2^32 - 1 elements are supported.
+   */
+  using index_type = uint32_t;
+
+  using size_type = uint64_t;
+
+  class Deleter;
+
+  /**
+   * Type of std::unique_ptr returned by make_unique.
+   */
+  using UniquePtr = std::unique_ptr<T, Deleter>;
+
+ private:
+  using Element = detail::FreeListElement<T, index_type>;
+
+  using Control = detail::FreeListControl<index_type, 32, Options>;
+
+  // Stored at the start of the buffer. The control words come last, so that
+  // the other fields are at the same offsets whatever the Options.
+  struct Header {
+    // Set to kMagic once the header is initialised
+    std::atomic<uint64_t> magic;
+    // kLayout of the FreeListView that initialised the buffer
+    uint64_t layout;
+    // sizeof(Element) of the FreeListView that initialised the buffer
+    uint64_t elementSize;
+    // One past the last usable index
+    uint64_t end;
+    Control control;
+  };
+
+  static constexpr uint64_t kMagic = 0x465245454c495354;  // "FREELIST"
+
+  // Fingerprint of the options that change the control words: whether they
+  // are atomic, their size, and their alignment, which is kCacheLineSize with
+  // kCacheLineAligned
+  static constexpr uint64_t kLayout =
+      uint64_t{Options::kThreadSafe} |
+      uint64_t{Options::kCacheLineAligned} << 1 |
+      uint64_t{sizeof(Control)} << 16 | uint64_t{alignof(Control)} << 40;
+
+  struct AttachTag {};
+
+  inline FreeListView(void* buffer, size_type bytes, AttachTag);
+
+ public:
+  /**
+   * Required alignment of the buffer.
+   */
+  static constexpr std::size_t kAlignment =
+      alignof(Header) > alignof(Element) ? alignof(Header) : alignof(Element);
+
+  /**
+   * Construct an empty FreeList in the provided buffer.
+   * @param buffer Memory to store the FreeList in, aligned to kAlignment.
+   * @param bytes Size of buffer in bytes.
+   * @exception std::invalid_argument If buffer is not aligned to kAlignment, or
+   * is too small to contain an element.
+   */
+  inline FreeListView(void* buffer, size_type bytes);
+
+  /**
+   * Attach to a FreeList previously constructed in the buffer, possibly by
+   * another process with the buffer mapped at a different address. The
+   * FreeList is not modified.
+   * @param buffer Memory holding the FreeList, aligned to kAlignment.
+   * @param bytes Size of buffer in bytes.
+   * @return View of the existing FreeList.
+   * @exception std::invalid_argument If buffer does not contain an initialised
+   * FreeList of the same element type and control word layout, or is smaller
+   * than when constructed.
+   */
+  inline static FreeListView attach(void* buffer, size_type bytes) {
+    return FreeListView(buffer, bytes, AttachTag());
+  }
+
+  /**
+   * Get the number of items that a buffer of the given size can store.
+   * @param bytes Size of buffer in bytes.
+   * @return Maximum number of stored items, 0 if the buffer is too small.
+   */
+  inline static size_type capacity_for(size_type bytes) noexcept;
+
+  /**
+   * Check if the FreeList is empty.
+   * @return True if the FreeList contains no items.
+   */
+  inline bool empty() const noexcept { return control().size() == 0; }
+
+  /**
+   * Check if the FreeList is full.
+   * @return True if the FreeList is full.
+   */
+  inline bool full() const noexcept { return control().size() >= max_size(); }
+
+  /**
+   * Check the number of active items in the FreeList.
+   * @return Number of active items in the FreeList.
+   */
+  inline index_type size() const noexcept { return control().size(); }
+
+  /**
+   * Get the maximum number of items that can be stored.
+   * @return Maximum number of stored items.
+   */
+  inline index_type max_size() const noexcept { return end - kOverheadCount; }
+
+  /**
+   * Synonym for max_size()
+   */
+  inline index_type capacity() const noexcept { return max_size(); }
+
+  /**
+   * Get the buffer holding the FreeList.
+   * @return Pointer to the start of the buffer.
+   */
+  inline void* buffer() const noexcept { return elements; }
+
+  /**
+   * Removes all items from the list, calling destructor for each.
+   */
+  inline void clear() noexcept;
+
+  /**
+   * Allocates a new item in the FreeList, and calls constructor.
+   * @see FreeList::alloc
+   */
+  template <typename... Args>
+  inline T* alloc(Args&&... args);
+
+  /**
+   * Synonym for alloc().
+   */
+  template <typename... Args>
+  inline T* push(Args&&... args) {
+    return alloc(std::forward<Args>(args)...);
+  }
+
+  /**
+   * Constructs a new item in the FreeList, without throwing if the freelist is
+   * full.
+   * @see FreeList::emplace
+   */
+  template <typename... Args>
+  inline index_type emplace(Args&&... args) noexcept(
+      std::is_nothrow_constructible<T, Args&&...>::value);
+
+  /**
+   * Constructs item in the Freelist with arguments, and returns unique_ptr.
+   * @see FreeList::make_unique
+   */
+  template <typename... Args>
+  inline UniquePtr make_unique(Args&&... args) {
+    return UniquePtr(alloc(std::forward<Args>(args)...), deleter());
+  }
+
+  /**
+   * Constructs item in the Freelist with arguments, and returns shared_ptr.
+   * @see FreeList::make_shared
+   */
+  template <typename... Args>
+  inline std::shared_ptr<T> make_shared(Args&&... args) {
+    return make_unique(std::forward<Args>(args)...);
+  }
+
+  /**
+   * Deletes an item from the FreeList, and calls destructor.
+   * @param item Pointer to item to delete.
+   */
+  inline void free(T* item) noexcept;
+
+  /**
+   * Synonym for free().
+   */
+  inline void pop(T* item) noexcept { free(item); }
+
+  /**
+   * Creates new item in the FreeList, does not call constructor.
+   * @return Index of new item, or 0 if full.
+   */
+  inline index_type push_index() noexcept {
+    return control().push_index(elements, end);
+  }
+
+  /**
+   * Removes item at specified index, does not call destructor.
+   * @param index Index of item to remove.
+   */
+  inline void pop_index(index_type index) noexcept;
+
+  /**
+   * Creates up to n new items with a single atomic update.
+   * @see FreeList::push_indices
+   */
+  inline size_type push_indices(index_type* out, size_type n) noexcept {
+    return control().push_indices(elements, kOverheadCount, end, out, n);
+  }
+
+  /**
+   * Removes n items with a single atomic update.
+   * @see FreeList::pop_indices
+   */
+  inline void pop_indices(index_type const* in, size_type n) noexcept;
+
+  /**
+   * Creates n new items at contiguous never-used indexes.
+   * @see FreeList::reserve_fresh
+   */
+  inline index_type reserve_fresh(size_type n) noexcept {
+    return control().reserve_fresh(end, n);
+  }
+
+  /**
+   * Returns the free elements directly below the never-used elements to them,
+   * so that no element from the returned index onwards is in use or on the
+   * free list. Must not be called concurrently with other modifications.
+   * @return One past the highest index that may be in use.
+   */
+  inline index_type trim_fresh() noexcept {
+    return control().trim_fresh(elements, end);
+  }
+
+  /**
+   * Get the index of the specified item.
+   * @param item Pointer of item to find.
+   * @return Index of the specified item.
+   */
+  inline index_type index(T const* item) const;
+
+  /**
+   * Convert an index into a pointer to the corresponding item.
+   * @param index Index of item to retrieve.
+   * @return Pointer to item.
+   */
+  inline T* get(index_type index) const;
+
+  /**
+   * Type of range returned by live().
+   */
+  using LiveRange = detail::LiveRange<T, index_type>;
+
+  /**
+   * Get a range of the active items, in address order.
+   * @see FreeList::live
+   */
+  inline LiveRange live() const noexcept;
+
+  /**
+   * Call f(item) for each active item, in address order.
+   * @see FreeList::live
+   */
+  template <typename F>
+  inline void for_each_live(F&& f) const {
+    Element* e = elements;
+    control().for_each_active(e, kOverheadCount, end,
+                              [e, &f](index_type i) { f(e[i].data); });
+  }
+
+  /**
+   * Returns a function object to delete items from this freelist.
+   * @return Deleter function object.
+   */
+  inline Deleter deleter() const noexcept { return Deleter(*this); }
+
+ private:
+  // View without a buffer, only used by a default-constructed Deleter
+  FreeListView() noexcept : elements(nullptr), end(0) {}
+
+  static constexpr index_type kOverheadCount =
+      (sizeof(Header) + sizeof(Element) - 1) / sizeof(Element);
+
+  Header& header() const noexcept {
+    return *reinterpret_cast<Header*>(elements);
+  }
+
+  Control& control() const noexcept { return header().control; }
+
+  // Throws if the buffer is null or misaligned
+  inline static void check_alignment(void* buffer);
+
+  // The buffer, as an array of elements; the first kOverheadCount elements are
+  // overlaid by the header
+  Element* elements;
+  // One past the last usable index
+  index_type end;
+};
+
+/**
+ * Function object that frees items from a FreeListView, for use with
+ * std::unique_ptr. Holds a copy of the view, which is two words.
+ */
+template <typename T, typename Options>
+class FreeListView<T, Options>::Deleter {
+ public:
+  /**
+   * Construct a deleter without a buffer, which must not be called.
+   */
+  Deleter() noexcept {}
+
+  explicit Deleter(this_type const& view) noexcept : view(view) {}
+
+  void operator()(T* item) const noexcept {
+    assert(view.elements);
+    this_type v = view;
+    v.free(item);
+  }
+
+ private:
+  this_type view;
+};
+
+template <typename T, typename Options>
+constexpr std::size_t FreeListView<T, Options>::kAlignment;
+
+template <typename T, typename Options>
+constexpr uint64_t FreeListView<T, Options>::kMagic;
+
+template <typename T, typename Options>
+constexpr uint64_t FreeListView<T, Options>::kLayout;
+
+template <typename T, typename Options>
+FreeListView<T, Options>::FreeListView(void* buffer, const size_type bytes)
+    : elements(static_cast<Element*>(buffer)),
+      end(static_cast<index_type>(capacity_for(bytes) + kOverheadCount)) {
+  check_alignment(buffer);
+  if (!capacity_for(bytes)) {
+    throw std::invalid_argument("FreeListView buffer is too small");
+  }
+
+  Header* h = new (buffer) Header();
+  h->control.reset(kOverheadCount);
+  h->layout = kLayout;
+  h->elementSize = sizeof(Element);
+  h->end = end;
+  // Release, so that attaching processes see an initialised header
+  h->magic.store(kMagic, std::memory_order_release);
+}
+
+template <typename T, typename Options>
+FreeListView<T, Options>::FreeListView(void* buffer, const size_type bytes,
+                                       AttachTag)
+    : elements(static_cast<Element*>(buffer)), end(0) {
+  check_alignment(buffer);
+  if (bytes < sizeof(Header)) {
+    throw std::invalid_argument("FreeListView buffer is too small");
+  }
+
+  Header const& h = header();
+  if (h.magic.load(std::memory_order_acquire) != kMagic) {
+    throw std::invalid_argument("FreeListView buffer is not initialised");
+  }
+  if (h.layout != kLayout) {
+    throw std::invalid_argument("FreeListView options do not match");
+  }
+  if (h.elementSize != sizeof(Element)) {
+    throw std::invalid_argument("FreeListView element size does not match");
+  }
+  if (h.end > capacity_for(bytes) + kOverheadCount) {
+    throw std::invalid_argument("FreeListView buffer is too small");
+  }
+  end = static_cast<index_type>(h.end);
+}
+
+template <typename T, typename Options>
+void FreeListView<T, Options>::check_alignment(void* buffer) {
+  if (!buffer || reinterpret_cast<uintptr_t>(buffer) % kAlignment != 0) {
+    throw std::invalid_argument("FreeListView buffer is not aligned");
+  }
+}
+
+template <typename T, typename Options>
+typename FreeListView<T, Options>::size_type
+FreeListView<T, Options>::capacity_for(const size_type bytes) noexcept {
+  size_type count = bytes / sizeof(Element);
+  if (count > std::numeric_limits<index_type>::max()) {
+    count = std::numeric_limits<index_type>::max();
+  }
+  return count > kOverheadCount ? count - kOverheadCount : 0;
+}
+
+template <typename T, typename Options>
+void FreeListView<T, Options>::clear() noexcept {
+  // Items without destructors need not be found
+  if (!std::is_trivially_destructible<T>::value && !empty()) {
+    Element* e = elements;
+    control().for_each_active(e, kOverheadCount, end,
+                              [e](index_type i) noexcept {
+                                // Call destructor
+                                e[i].data.~T();
+                              });
+  }
+
+  control().reset(kOverheadCount);
+}
+
+template <typename T, typename Options>
+typename FreeListView<T, Options>::LiveRange FreeListView<T, Options>::live()
+    const noexcept {
+  using iterator = typename LiveRange::iterator;
+  const index_type free = control().sort_free_list(elements);
+  const index_type used = control().next_index(end);
+  return LiveRange(iterator(elements, kOverheadCount, free, used),
+                   iterator(elements, used, 0, used));
+}
+
+template <typename T, typename Options>
+template <typename... Args>
+T* FreeListView<T, Options>::alloc(Args&&... args) {
+  index_type index = push_index();
+  if (!index) {
+    throw std::bad_alloc();
+  }
+
+  // placement-new the item
+  return detail::construct<T>(
+      get(index), [this, index]() { pop_index(index); },
+      std::forward<Args>(args)...);
+}
+
+template <typename T, typename Options>
+template <typename... Args>
+typename FreeListView<T, Options>::index_type
+FreeListView<T, Options>::emplace(Args&&... args) noexcept(
+    std::is_nothrow_constructible<T, Args&&...>::value) {
+  index_type index = push_index();
+  if (index) {
+    // placement-new the item
+    detail::construct<T>(
+        get(index), [this, index]() { pop_index(index); },
+        std::forward<Args>(args)...);
+  }
+  return index;
+}
+
+template <typename T, typename Options>
+void FreeListView<T, Options>::free(T* item) noexcept {
+  assert(item);
+
+  // placement-delete the item
+  item->~T();
+  pop_index(index(item));
+}
+
+template <typename T, typename Options>
+void FreeListView<T, Options>::pop_index(const index_type index) noexcept {
+  assert(index >= kOverheadCount);
+  assert(index < end);
+  control().pop_chain(elements, index, index, 1);
+}
+
+template <typename T, typename Options>
+void FreeListView<T, Options>::pop_indices(index_type const* in,
+                                           const size_type n) noexcept {
+  if (!n) return;
+
+  // Link the items together into a chain before publishing it
+  for (size_type i = 0; i + 1 < n; ++i) {
+    assert(in[i] >= kOverheadCount);
+    assert(in[i] < end);
+    elements[in[i]].index = in[i + 1];
+  }
+  control().pop_chain(elements, in[0], in[n - 1], n);
+}
+
+template <typename T, typename Options>
+typename FreeListView<T, Options>::index_type FreeListView<T, Options>::index(
+    T const* item) const {
+  assert(item);
+  Element const* element = reinterpret_cast<Element const*>(item);
+  assert(element >= elements + kOverheadCount);
+  assert(element < elements + end);
+  return static_cast<index_type>(element - elements);
+}
+
+template <typename T, typename Options>
+T* FreeListView<T, Options>::get(const index_type index) const {
+  assert(index >= kOverheadCount);
+  assert(index < end);
+  return &elements[index].data;
+}
+
+}  // namespace freelist
+
+#endif  // INCLUDE_FREELIST_FREELIST_VIEW_H_
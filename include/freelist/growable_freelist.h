@@ -0,0 +1,487 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INCLUDE_FREELIST_GROWABLE_FREELIST_H_
+#define INCLUDE_FREELIST_GROWABLE_FREELIST_H_
+
+#include <freelist/freelist.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+
+namespace freelist {
+
+/**
+ * GrowableFreeList is a FreeList without a fixed capacity. Items are stored in
+ * slabs, each of which is a FreeList occupying SlabBytes bytes. A new slab is
+ * allocated from the heap when all existing slabs are full.
+ *
+ * Slabs are aligned to SlabBytes, so the slab containing an item is found by
+ * masking the address of the item, and free() does not search. Slabs with
+ * space are kept on a lock-free list: free() adds a slab that was found full
+ * back to it, and alloc() takes slabs from it, so alloc() does not search all
+ * slabs either. Only one thread at a time adds a slab; other threads that
+ * find all slabs full wait for it and retry, so a burst of allocations adds
+ * one slab rather than one per thread.
+ *
+ * alloc() and free() may be called concurrently. All other functions,
+ * including release_empty_slabs(), for_each_live() and the destructor,
+ * require exclusive access: no other thread may be inside any function of
+ * the GrowableFreeList, nor free an item through a Deleter.
+ *
+ * @tparam T Data type to store.
+ * @tparam SlabBytes Number of bytes of each slab, must be a power of two.
+ * @tparam Options Compile-time options for each slab, see FreeListOptions.
+ */
+template <typename T, uint64_t SlabBytes,
+          typename Options = FreeListOptions>
+class GrowableFreeList {
+ public:
+  static_assert(SlabBytes >= sizeof(void*) &&
+                    (SlabBytes & (SlabBytes - 1)) == 0,
+                "SlabBytes must be a power of two");
+
+  /**
+   * Type that is stored in each active element.
+   */
+  using value_type = T;
+
+  /**
+   * Type of each slab.
+   */
+  using Slab = FreeList<T, SlabBytes, Options>;
+
+  using size_type = uint64_t;
+
+  /**
+   * Type of function object used to free items. It is empty, as the slab is
+   * found from the address of the item. Items freed by it do not put their
+   * slab back on the list of slabs with space: such a slab is found again
+   * only when alloc() would otherwise add a slab. Otherwise equivalent to
+   * free().
+   */
+  using Deleter = AlignedFreeListDeleter<T, SlabBytes, Options>;
+
+  /**
+   * Type of std::unique_ptr returned by make_unique, the size of a pointer.
+   */
+  using UniquePtr = std::unique_ptr<T, Deleter>;
+
+  /**
+   * Type of intrusive shared pointer returned by make_handle, the size of a
+   * pointer.
+   */
+  using SharedHandle = freelist::SharedHandle<T, Deleter>;
+
+  /**
+   * Construct an empty GrowableFreeList, no slabs are allocated.
+   * @param maxSlabs Maximum number of slabs to allocate, or 0 for no limit.
+   */
+  explicit GrowableFreeList(size_type maxSlabs = 0) : maxSlabs(maxSlabs) {}
+
+  GrowableFreeList(GrowableFreeList const&) = delete;
+  GrowableFreeList& operator=(GrowableFreeList const&) = delete;
+
+  /**
+   * Destructor, calls delete on all existing items and releases all slabs.
+   */
+  inline ~GrowableFreeList() noexcept;
+
+  /**
+   * Check if the GrowableFreeList is empty.
+   * @return True if no slab contains items.
+   */
+  inline bool empty() const noexcept;
+
+  /**
+   * Check the number of active items in all slabs.
+   * @return Number of active items.
+   */
+  inline size_type size() const noexcept;
+
+  /**
+   * Get the number of items that can be stored without allocating a slab.
+   * @return Capacity of all allocated slabs.
+   */
+  inline size_type capacity() const noexcept {
+    return slab_count() * Slab::capacity();
+  }
+
+  /**
+   * Get the number of allocated slabs.
+   * @return Number of slabs.
+   */
+  inline size_type slab_count() const noexcept {
+    return slabCount.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Allocates a new item, and calls constructor. Allocates a new slab if all
+   * slabs are full.
+   * @tparam Args Type of arguments for item constructor.
+   * @param args Arguments to provide to item constructor.
+   * @return Pointer to new item.
+   * @exception std::bad_alloc If all slabs are full and no slab can be
+   * allocated.
+   * @exception any Exceptions thrown by the constructor are forwarded.
+   * If any exception is thrown, the freelist state will be unchanged, apart
+   * from possibly having allocated an additional slab.
+   */
+  template <typename... Args>
+  inline T* alloc(Args&&... args);
+
+  /**
+   * Constructs item with arguments, and returns unique_ptr.
+   * @see alloc
+   */
+  template <typename... Args>
+  inline UniquePtr make_unique(Args&&... args) {
+    return UniquePtr(alloc(std::forward<Args>(args)...));
+  }
+
+  /**
+   * Constructs item with arguments, and returns a SharedHandle to it. T must
+   * derive from RefCounted.
+   * @see alloc
+   */
+  template <typename... Args>
+  inline SharedHandle make_handle(Args&&... args) {
+    return SharedHandle(alloc(std::forward<Args>(args)...), Deleter());
+  }
+
+  /**
+   * Deletes an item, and calls destructor.
+   * @param item Pointer to item to delete.
+   */
+  inline void free(T* item) noexcept;
+
+  /**
+   * Call f(item) for each active item, slab by slab, in address order within
+   * each slab. Requires exclusive access.
+   * @see FreeList::live
+   * @param f Function object taking T&.
+   */
+  template <typename F>
+  inline void for_each_live(F&& f) {
+    for (SlabNode* n = slabs.load(std::memory_order_acquire); n;
+         n = n->next) {
+      slab_of(n)->for_each_live(f);
+    }
+  }
+
+  /**
+   * Get the slab containing the specified item.
+   * @param item Pointer to item.
+   * @return Slab containing the item.
+   */
+  static Slab* slab(T const* item) noexcept { return Deleter::parent(item); }
+
+  /**
+   * Returns empty slabs to the heap. Requires exclusive access: must not be
+   * called concurrently with any other function, including alloc() and
+   * free().
+   * @return Number of slabs released.
+   */
+  inline size_type release_empty_slabs() noexcept;
+
+ private:
+  // Bookkeeping for a slab, stored just after the slab in the same
+  // allocation, so that it is found from the slab without a search
+  struct SlabNode {
+    // Next slab in the list of all slabs
+    SlabNode* next{nullptr};
+    // Next slab in the list of slabs with space
+    SlabNode* nextSpace{nullptr};
+    // Whether the slab is on the list of slabs with space, or held by an
+    // alloc() that is taking slabs from the list
+    std::atomic<bool> listed{false};
+  };
+
+  static SlabNode* node_of(Slab* s) noexcept {
+    return reinterpret_cast<SlabNode*>(reinterpret_cast<char*>(s) +
+                                       SlabBytes);
+  }
+
+  static Slab* slab_of(SlabNode* n) noexcept {
+    return reinterpret_cast<Slab*>(reinterpret_cast<char*>(n) - SlabBytes);
+  }
+
+  // Takes an index when the preferred slab is full, adding a slab if all
+  // are full. Sets s to the slab, returns 0 if no slab can be added.
+  inline typename Slab::index_type acquire_index(Slab*& s) noexcept;
+
+  // Takes an index from a slab on the list of slabs with space, dropping
+  // full slabs from the list. Sets s to the slab, returns 0 if none.
+  inline typename Slab::index_type take_listed(Slab*& s) noexcept;
+
+  // Called by the one thread allowed to add a slab: searches all slabs once
+  // more, then adds a slab. Sets s to the slab, returns 0 on failure.
+  inline typename Slab::index_type grow(Slab*& s) noexcept;
+
+  // Puts a slab on the list of slabs with space, unless it already is
+  inline void list(SlabNode* n) noexcept;
+
+  // Puts a chain of listed slabs back on the list of slabs with space
+  inline void restore(SlabNode* chain) noexcept;
+
+  const size_type maxSlabs;
+  // List of all slabs, new slabs are pushed to the front
+  std::atomic<SlabNode*> slabs{nullptr};
+  // Lock-free stack of slabs that may have space. Slabs are only removed by
+  // taking the whole stack, so the stack has no ABA problem.
+  std::atomic<SlabNode*> withSpace{nullptr};
+  // Slab that most recently had space
+  std::atomic<Slab*> available{nullptr};
+  // Set while one thread is adding a slab
+  std::atomic<bool> growing{false};
+  std::atomic<size_type> slabCount{0};
+};
+
+template <typename T, uint64_t SlabBytes, typename Options>
+GrowableFreeList<T, SlabBytes, Options>::~GrowableFreeList() noexcept {
+  SlabNode* n = slabs.load(std::memory_order_acquire);
+  while (n) {
+    SlabNode* next = n->next;
+    Slab* s = slab_of(n);
+    n->~SlabNode();
+    s->~Slab();
+    detail::aligned_deallocate(s);
+    n = next;
+  }
+}
+
+template <typename T, uint64_t SlabBytes, typename Options>
+bool GrowableFreeList<T, SlabBytes, Options>::empty() const noexcept {
+  for (SlabNode* n = slabs.load(std::memory_order_acquire); n; n = n->next) {
+    if (!slab_of(n)->empty()) return false;
+  }
+  return true;
+}
+
+template <typename T, uint64_t SlabBytes, typename Options>
+typename GrowableFreeList<T, SlabBytes, Options>::size_type
+GrowableFreeList<T, SlabBytes, Options>::size() const noexcept {
+  size_type result = 0;
+  for (SlabNode* n = slabs.load(std::memory_order_acquire); n; n = n->next) {
+    result += slab_of(n)->size();
+  }
+  return result;
+}
+
+template <typename T, uint64_t SlabBytes, typename Options>
+template <typename... Args>
+T* GrowableFreeList<T, SlabBytes, Options>::alloc(Args&&... args) {
+  // Try the slab that most recently had space
+  Slab* s = available.load(std::memory_order_acquire);
+  typename Slab::index_type index = s ? s->push_index() : 0;
+
+  if (!index && !(index = acquire_index(s))) {
+    throw std::bad_alloc();
+  }
+
+  // placement-new the item
+  return detail::construct<T>(
+      s->get(index), [s, index]() { s->pop_index(index); },
+      std::forward<Args>(args)...);
+}
+
+template <typename T, uint64_t SlabBytes, typename Options>
+void GrowableFreeList<T, SlabBytes, Options>::free(T* item) noexcept {
+  assert(item);
+  Slab* s = slab(item);
+  s->free(item);
+
+  // A slab dropped from the list as full has space again. A stale read only
+  // delays this until the next grow(), which searches all slabs.
+  SlabNode* n = node_of(s);
+  if (!n->listed.load(std::memory_order_relaxed)) {
+    list(n);
+  }
+}
+
+template <typename T, uint64_t SlabBytes, typename Options>
+typename GrowableFreeList<T, SlabBytes, Options>::size_type
+GrowableFreeList<T, SlabBytes, Options>::release_empty_slabs() noexcept {
+  size_type released = 0;
+  SlabNode* kept = nullptr;
+  SlabNode* keptSpace = nullptr;
+  SlabNode* n = slabs.load(std::memory_order_relaxed);
+  while (n) {
+    SlabNode* next = n->next;
+    Slab* s = slab_of(n);
+    if (s->empty()) {
+      n->~SlabNode();
+      s->~Slab();
+      detail::aligned_deallocate(s);
+      ++released;
+    } else {
+      n->next = kept;
+      kept = n;
+      // Rebuild the list of slabs with space from the kept slabs
+      const bool space = !s->full();
+      n->listed.store(space, std::memory_order_relaxed);
+      if (space) {
+        n->nextSpace = keptSpace;
+        keptSpace = n;
+      }
+    }
+    n = next;
+  }
+
+  slabs.store(kept, std::memory_order_relaxed);
+  withSpace.store(keptSpace, std::memory_order_relaxed);
+  available.store(keptSpace ? slab_of(keptSpace) : nullptr,
+                  std::memory_order_relaxed);
+  slabCount.fetch_sub(released, std::memory_order_relaxed);
+  return released;
+}
+
+template <typename T, uint64_t SlabBytes, typename Options>
+typename GrowableFreeList<T, SlabBytes, Options>::Slab::index_type
+GrowableFreeList<T, SlabBytes, Options>::acquire_index(Slab*& s) noexcept {
+  for (;;) {
+    if (typename Slab::index_type index = take_listed(s)) {
+      return index;
+    }
+
+    bool expected = false;
+    if (growing.compare_exchange_strong(expected, true,
+                                        std::memory_order_acquire,
+                                        std::memory_order_relaxed)) {
+      typename Slab::index_type index = grow(s);
+      growing.store(false, std::memory_order_release);
+      return index;
+    }
+
+    // Another thread is adding a slab, wait for it and retry
+    while (growing.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+template <typename T, uint64_t SlabBytes, typename Options>
+typename GrowableFreeList<T, SlabBytes, Options>::Slab::index_type
+GrowableFreeList<T, SlabBytes, Options>::take_listed(Slab*& s) noexcept {
+  SlabNode* n = withSpace.exchange(nullptr, std::memory_order_acquire);
+  typename Slab::index_type index = 0;
+  while (n) {
+    s = slab_of(n);
+    if ((index = s->push_index())) break;
+
+    // Full: drop it from the list. Retry once, as a free() that saw it still
+    // listed does not list it again.
+    SlabNode* next = n->nextSpace;
+    n->listed.exchange(false, std::memory_order_acq_rel);
+    if ((index = s->push_index())) {
+      // Keep it, unless a free() has listed it again meanwhile
+      if (n->listed.exchange(true, std::memory_order_acq_rel)) n = next;
+      break;
+    }
+    n = next;
+  }
+  if (index) {
+    available.store(s, std::memory_order_release);
+  }
+  restore(n);
+  return index;
+}
+
+template <typename T, uint64_t SlabBytes, typename Options>
+typename GrowableFreeList<T, SlabBytes, Options>::Slab::index_type
+GrowableFreeList<T, SlabBytes, Options>::grow(Slab*& s) noexcept {
+  // Slabs with space may have been held by another alloc(), or missed by a
+  // free(), so search all slabs before adding one
+  typename Slab::index_type index = take_listed(s);
+  for (SlabNode* n = slabs.load(std::memory_order_acquire); n && !index;
+       n = n->next) {
+    s = slab_of(n);
+    if (!s->full() && (index = s->push_index())) {
+      available.store(s, std::memory_order_release);
+      list(n);
+    }
+  }
+  if (index) {
+    return index;
+  }
+
+  if (maxSlabs && slabCount.load(std::memory_order_relaxed) >= maxSlabs) {
+    return 0;
+  }
+  void* memory =
+      detail::aligned_allocate(SlabBytes + sizeof(SlabNode), SlabBytes);
+  if (!memory) {
+    return 0;
+  }
+  s = new (memory) Slab();
+  SlabNode* n = new (node_of(s)) SlabNode();
+  index = s->push_index();
+
+  // Only the growing thread adds slabs
+  n->next = slabs.load(std::memory_order_relaxed);
+  slabs.store(n, std::memory_order_release);
+  slabCount.fetch_add(1, std::memory_order_relaxed);
+  available.store(s, std::memory_order_release);
+  list(n);
+  return index;
+}
+
+template <typename T, uint64_t SlabBytes, typename Options>
+void GrowableFreeList<T, SlabBytes, Options>::list(SlabNode* n) noexcept {
+  if (!n->listed.exchange(true, std::memory_order_acq_rel)) {
+    n->nextSpace = withSpace.load(std::memory_order_relaxed);
+    while (!withSpace.compare_exchange_weak(n->nextSpace, n,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+    }
+  }
+}
+
+template <typename T, uint64_t SlabBytes, typename Options>
+void GrowableFreeList<T, SlabBytes, Options>::restore(
+    SlabNode* chain) noexcept {
+  while (chain) {
+    SlabNode* expected = nullptr;
+    if (withSpace.compare_exchange_strong(expected, chain,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+      return;
+    }
+    // Slabs were listed meanwhile: take them, and append the chain to them
+    SlabNode* listed = withSpace.exchange(nullptr, std::memory_order_acquire);
+    if (listed) {
+      SlabNode* tail = listed;
+      while (tail->nextSpace) tail = tail->nextSpace;
+      tail->nextSpace = chain;
+      chain = listed;
+    }
+  }
+}
+
+}  // namespace freelist
+
+#endif  // INCLUDE_FREELIST_GROWABLE_FREELIST_H_
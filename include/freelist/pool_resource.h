@@ -0,0 +1,235 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INCLUDE_FREELIST_POOL_RESOURCE_H_
+#define INCLUDE_FREELIST_POOL_RESOURCE_H_
+
+#include <freelist/growable_freelist.h>
+#include <freelist/size_class_pool.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace freelist {
+
+namespace detail {
+
+/**
+ * GrowableFreeLists of blocks of 2^Shift bytes, for Shift in [Shift, MaxShift].
+ * Blocks are aligned to their size.
+ */
+template <std::size_t Shift, std::size_t MaxShift, uint64_t SlabBytes,
+          typename Options>
+class PoolSizeClasses {
+ public:
+  void* allocate(std::size_t shift) {
+    return shift == Shift ? pool.alloc() : rest.allocate(shift);
+  }
+
+  void deallocate(void* p, std::size_t shift) noexcept {
+    if (shift == Shift) {
+      pool.free(static_cast<Block*>(p));
+    } else {
+      rest.deallocate(p, shift);
+    }
+  }
+
+ private:
+  using Block = RawBlock<std::size_t(1) << Shift, std::size_t(1) << Shift>;
+
+  GrowableFreeList<Block, SlabBytes, Options> pool;
+  PoolSizeClasses<Shift + 1, MaxShift, SlabBytes, Options> rest;
+};
+
+template <std::size_t MaxShift, uint64_t SlabBytes, typename Options>
+class PoolSizeClasses<MaxShift + 1, MaxShift, SlabBytes, Options> {
+ public:
+  void* allocate(std::size_t) { return nullptr; }
+  void deallocate(void*, std::size_t) noexcept {}
+};
+
+}  // namespace detail
+
+/**
+ * std::pmr::memory_resource that allocates from FreeLists, one for each power
+ * of two size class from 8 bytes to kMaxBlockBytes. Each size class is a
+ * GrowableFreeList, which allocates slabs of SlabBytes from the heap as needed.
+ * Larger or more strictly aligned requests are passed to the upstream
+ * resource.
+ *
+ * Memory is returned to the size class FreeLists, and slabs are released when
+ * the resource is destroyed. Use pool_resource or unsynchronized_pool_resource.
+ * Requires C++17.
+ *
+ * @tparam Options Compile-time options for the FreeLists, see FreeListOptions.
+ * If Options::kThreadSafe, the resource may be used concurrently.
+ * @tparam SlabBytes Size of each slab, a power of two.
+ */
+template <typename Options, uint64_t SlabBytes = 65536>
+class basic_pool_resource : public std::pmr::memory_resource {
+ public:
+  /**
+   * Largest size class, larger requests are passed upstream.
+   */
+  static constexpr std::size_t kMaxBlockBytes = SlabBytes / 16;
+
+  /**
+   * Construct a resource with no slabs.
+   * @param upstream Resource for requests larger than kMaxBlockBytes.
+   */
+  explicit basic_pool_resource(
+      std::pmr::memory_resource* upstream =
+          std::pmr::get_default_resource()) noexcept
+      : upstream(upstream) {}
+
+  basic_pool_resource(basic_pool_resource const&) = delete;
+  basic_pool_resource& operator=(basic_pool_resource const&) = delete;
+
+  /**
+   * @return Resource for requests larger than kMaxBlockBytes.
+   */
+  std::pmr::memory_resource* upstream_resource() const noexcept {
+    return upstream;
+  }
+
+ protected:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    const std::size_t shift = size_class(bytes, alignment);
+    if (shift > kMaxShift) {
+      return upstream->allocate(bytes, alignment);
+    }
+    return classes.allocate(shift);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override {
+    const std::size_t shift = size_class(bytes, alignment);
+    if (shift > kMaxShift) {
+      upstream->deallocate(p, bytes, alignment);
+    } else {
+      classes.deallocate(p, shift);
+    }
+  }
+
+  bool do_is_equal(
+      std::pmr::memory_resource const& other) const noexcept override {
+    return this == &other;
+  }
+
+ private:
+  static constexpr std::size_t kMinShift = 3;
+  static constexpr std::size_t kMaxShift =
+      detail::bit_width(kMaxBlockBytes) - 1;
+
+  static_assert((SlabBytes & (SlabBytes - 1)) == 0 && SlabBytes >= 256,
+                "SlabBytes must be a power of two, at least 256");
+
+  // Log2 of the smallest size class holding bytes with the given alignment
+  static std::size_t size_class(std::size_t bytes,
+                                std::size_t alignment) noexcept {
+    std::size_t size = bytes > alignment ? bytes : alignment;
+    if (size <= (std::size_t(1) << kMinShift)) return kMinShift;
+    return detail::bit_width(size - 1);
+  }
+
+  std::pmr::memory_resource* upstream;
+  detail::PoolSizeClasses<kMinShift, kMaxShift, SlabBytes, Options> classes;
+};
+
+/**
+ * Pool resource that may be used concurrently by multiple threads. Allocation
+ * and deallocation are lock-free, apart from allocating new slabs.
+ */
+using pool_resource = basic_pool_resource<FreeListOptions>;
+
+/**
+ * Pool resource that must only be used by one thread at a time.
+ */
+using unsynchronized_pool_resource = basic_pool_resource<SingleThreaded>;
+
+/**
+ * std::pmr::memory_resource that allocates from a SizeClassPool held by the
+ * resource, such as a PowerOfTwoSizeClassPool. Unlike basic_pool_resource,
+ * it never allocates slabs: requests that no size class of the pool can
+ * serve, including requests to full classes, are passed to the upstream
+ * resource. Requires C++17.
+ *
+ * @tparam Pool Type of BasicSizeClassPool. If its options are thread-safe,
+ * the resource may be used concurrently.
+ */
+template <typename Pool>
+class size_class_pool_resource : public std::pmr::memory_resource {
+ public:
+  /**
+   * Construct a resource with an empty pool.
+   * @param upstream Resource for requests the pool cannot serve.
+   */
+  explicit size_class_pool_resource(
+      std::pmr::memory_resource* upstream =
+          std::pmr::get_default_resource()) noexcept
+      : upstream(upstream) {}
+
+  size_class_pool_resource(size_class_pool_resource const&) = delete;
+  size_class_pool_resource& operator=(size_class_pool_resource const&) =
+      delete;
+
+  /**
+   * @return Resource for requests the pool cannot serve.
+   */
+  std::pmr::memory_resource* upstream_resource() const noexcept {
+    return upstream;
+  }
+
+  /**
+   * @return The pool serving requests.
+   */
+  Pool const& pool() const noexcept { return classes; }
+
+ protected:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    if (void* p = classes.try_allocate(bytes, alignment)) return p;
+    return upstream->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override {
+    if (classes.owns(p)) {
+      classes.deallocate(p, bytes, alignment);
+    } else {
+      upstream->deallocate(p, bytes, alignment);
+    }
+  }
+
+  bool do_is_equal(
+      std::pmr::memory_resource const& other) const noexcept override {
+    return this == &other;
+  }
+
+ private:
+  std::pmr::memory_resource* upstream;
+  Pool classes;
+};
+
+}  // namespace freelist
+
+#endif  // INCLUDE_FREELIST_POOL_RESOURCE_H_
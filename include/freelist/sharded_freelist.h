@@ -0,0 +1,434 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INCLUDE_FREELIST_SHARDED_FREELIST_H_
+#define INCLUDE_FREELIST_SHARDED_FREELIST_H_
+
+#include <freelist/freelist.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace freelist {
+
+/**
+ * NUMA node of the calling thread, determined when the thread first calls it.
+ * Threads should be pinned to a node for the result to stay accurate. On
+ * platforms other than Linux, returns 0.
+ */
+inline uint32_t thread_numa_node() noexcept {
+#if defined(__linux__) && defined(SYS_getcpu)
+  static thread_local const uint32_t node = []() -> uint32_t {
+    unsigned cpuNumber = 0, nodeNumber = 0;
+    return syscall(SYS_getcpu, &cpuNumber, &nodeNumber, nullptr) == 0
+               ? nodeNumber
+               : 0;
+  }();
+  return node;
+#else
+  return 0;
+#endif
+}
+
+/**
+ * CPU of the calling thread, determined when the thread first calls it.
+ * Threads should be pinned to a CPU for the result to stay accurate. On
+ * platforms other than Linux, returns a small number unique to the thread.
+ */
+inline uint32_t thread_cpu() noexcept {
+#if defined(__linux__) && defined(SYS_getcpu)
+  static thread_local const uint32_t cpu = []() -> uint32_t {
+    unsigned cpuNumber = 0, nodeNumber = 0;
+    return syscall(SYS_getcpu, &cpuNumber, &nodeNumber, nullptr) == 0
+               ? cpuNumber
+               : detail::thread_shard();
+  }();
+  return cpu;
+#else
+  return detail::thread_shard();
+#endif
+}
+
+/**
+ * ShardedFreeList keeps one FreeList (shard) per NUMA node or group of cores,
+ * so that threads allocate from memory local to them, and do not share the
+ * control words of a single FreeList with threads on other nodes.
+ *
+ * The shard of the calling thread is chosen by a selector function, by
+ * default thread_numa_node(), modulo Shards. Each shard is allocated by the
+ * first thread that selects it, which touches all of its memory, so that with
+ * the usual first-touch policy its pages are placed on that thread's node.
+ *
+ * Allocations take from the local shard first, and steal from the other
+ * existing shards if it is full. An item freed by a thread of its own shard
+ * is returned to that FreeList directly. An item freed by any other thread is
+ * destroyed and pushed onto a lock-free return queue of its shard, so the
+ * remote thread does not touch the shard's free list; the queue is drained
+ * in batches when the shard is found full, as mimalloc does with its
+ * thread-free lists.
+ *
+ * Shards are aligned to ShardBytes, so the shard containing an item is found
+ * by masking the address of the item.
+ *
+ * alloc() and free() may be called concurrently, other functions may not be
+ * called concurrently with alloc() or free() unless noted.
+ *
+ * @tparam T Data type to store.
+ * @tparam ShardBytes Number of bytes of each shard, must be a power of two.
+ * @tparam Shards Maximum number of shards.
+ * @tparam Options Compile-time options for each shard, see FreeListOptions.
+ */
+template <typename T, uint64_t ShardBytes, uint32_t Shards,
+          typename Options = FreeListOptions>
+class ShardedFreeList {
+ public:
+  static_assert(ShardBytes >= sizeof(void*) &&
+                    (ShardBytes & (ShardBytes - 1)) == 0,
+                "ShardBytes must be a power of two");
+  static_assert(Shards > 0, "Shards must be at least 1");
+  static_assert(Options::kThreadSafe, "ShardedFreeList requires kThreadSafe");
+
+  /**
+   * Type that is stored in each active element.
+   */
+  using value_type = T;
+
+  /**
+   * Type of each shard.
+   */
+  using Shard = FreeList<T, ShardBytes, Options>;
+
+  using index_type = typename Shard::index_type;
+  using size_type = uint64_t;
+
+  /**
+   * Function returning a number identifying the calling thread's shard, taken
+   * modulo Shards.
+   */
+  using Selector = uint32_t (*)();
+
+  /**
+   * Construct an empty ShardedFreeList, no shards are allocated.
+   * @param selector Function choosing the shard of the calling thread.
+   */
+  explicit ShardedFreeList(Selector selector = &thread_numa_node) noexcept
+      : selector(selector) {}
+
+  ShardedFreeList(ShardedFreeList const&) = delete;
+  ShardedFreeList& operator=(ShardedFreeList const&) = delete;
+
+  /**
+   * Destructor, calls delete on all existing items and releases all shards.
+   */
+  inline ~ShardedFreeList() noexcept;
+
+  /**
+   * Check if the ShardedFreeList is empty.
+   * @return True if no shard contains items.
+   */
+  inline bool empty() const noexcept { return size() == 0; }
+
+  /**
+   * Check the number of active items in all shards. Items in return queues
+   * are not counted.
+   * @return Number of active items.
+   */
+  inline size_type size() const noexcept;
+
+  /**
+   * Get the number of items that can be stored without allocating a shard.
+   * @return Capacity of all allocated shards.
+   */
+  inline size_type capacity() const noexcept {
+    return shard_count() * Shard::capacity();
+  }
+
+  /**
+   * Get the number of allocated shards.
+   * @return Number of shards.
+   */
+  inline size_type shard_count() const noexcept;
+
+  /**
+   * Get the maximum number of shards.
+   * @return Shards.
+   */
+  static constexpr size_type max_shards() noexcept { return Shards; }
+
+  /**
+   * Get the number of the calling thread's shard.
+   * @return Number in [0, Shards).
+   */
+  inline uint32_t local_shard() const noexcept { return selector() % Shards; }
+
+  /**
+   * Allocates a new item, and calls constructor. Allocates the local shard if
+   * it does not exist yet; steals from other shards if it is full.
+   * @tparam Args Type of arguments for item constructor.
+   * @param args Arguments to provide to item constructor.
+   * @return Pointer to new item.
+   * @exception std::bad_alloc If all shards are full and the local shard
+   * cannot be allocated.
+   * @exception any Exceptions thrown by the constructor are forwarded.
+   * If any exception is thrown, the freelist state will be unchanged, apart
+   * from possibly having allocated the local shard.
+   */
+  template <typename... Args>
+  inline T* alloc(Args&&... args);
+
+  /**
+   * Deletes an item, and calls destructor. If the item belongs to a shard
+   * other than the local one, it is queued for that shard.
+   * @param item Pointer to item to delete.
+   */
+  inline void free(T* item) noexcept;
+
+  /**
+   * Returns all queued items to their shards. May be called concurrently
+   * with alloc() and free().
+   * @return Number of items returned.
+   */
+  inline size_type collect() noexcept;
+
+  /**
+   * Get the shard containing the specified item.
+   * @param item Pointer to item.
+   * @return Shard containing the item.
+   */
+  static Shard* shard(T const* item) noexcept {
+    return AlignedFreeListDeleter<T, ShardBytes, Options>::parent(item);
+  }
+
+ private:
+  // State of one shard, on its own cache line as it is written by remote
+  // threads
+  struct alignas(Options::kCacheLineSize) ShardState {
+    std::atomic<Shard*> shard{nullptr};
+    // Head of the return queue, linked through the elements; 0 if empty
+    std::atomic<index_type> queue{0};
+    std::atomic<size_type> queued{0};
+  };
+
+  static constexpr std::size_t kBatchSize = 64;
+
+  // Number of the shard s, which must exist
+  inline uint32_t shard_number(Shard const* s) const noexcept;
+
+  // Takes an index from shard i, draining its queue if it is full
+  inline index_type take(uint32_t i) noexcept;
+
+  // Returns the queued items of shard i, returns number returned
+  inline size_type drain(uint32_t i) noexcept;
+
+  // Allocates shard i, or returns the existing one; nullptr on failure
+  inline Shard* add_shard(uint32_t i) noexcept;
+
+  const Selector selector;
+  ShardState shards[Shards];
+};
+
+template <typename T, uint64_t ShardBytes, uint32_t Shards, typename Options>
+ShardedFreeList<T, ShardBytes, Shards, Options>::~ShardedFreeList() noexcept {
+  // Queued items are already destroyed, return them before the shard
+  // destroys its remaining items
+  collect();
+  for (ShardState& state : shards) {
+    if (Shard* s = state.shard.load(std::memory_order_acquire)) {
+      s->~Shard();
+      detail::aligned_deallocate(s);
+    }
+  }
+}
+
+template <typename T, uint64_t ShardBytes, uint32_t Shards, typename Options>
+typename ShardedFreeList<T, ShardBytes, Shards, Options>::size_type
+ShardedFreeList<T, ShardBytes, Shards, Options>::size() const noexcept {
+  size_type result = 0;
+  for (ShardState const& state : shards) {
+    if (Shard const* s = state.shard.load(std::memory_order_acquire)) {
+      result += s->size() - state.queued.load(std::memory_order_relaxed);
+    }
+  }
+  return result;
+}
+
+template <typename T, uint64_t ShardBytes, uint32_t Shards, typename Options>
+typename ShardedFreeList<T, ShardBytes, Shards, Options>::size_type
+ShardedFreeList<T, ShardBytes, Shards, Options>::shard_count() const noexcept {
+  size_type result = 0;
+  for (ShardState const& state : shards) {
+    if (state.shard.load(std::memory_order_relaxed)) ++result;
+  }
+  return result;
+}
+
+template <typename T, uint64_t ShardBytes, uint32_t Shards, typename Options>
+template <typename... Args>
+T* ShardedFreeList<T, ShardBytes, Shards, Options>::alloc(Args&&... args) {
+  const uint32_t local = local_shard();
+  uint32_t i = local;
+  index_type index = 0;
+
+  // Take from the local shard, allocating it on first use
+  if (shards[local].shard.load(std::memory_order_acquire) ||
+      add_shard(local)) {
+    index = take(local);
+  }
+
+  // Steal from the other shards
+  for (uint32_t n = 1; !index && n < Shards; ++n) {
+    i = (local + n) % Shards;
+    if (shards[i].shard.load(std::memory_order_acquire)) {
+      index = take(i);
+    }
+  }
+
+  if (!index) {
+    throw std::bad_alloc();
+  }
+
+  // placement-new the item
+  Shard* s = shards[i].shard.load(std::memory_order_relaxed);
+  return detail::construct<T>(
+      s->get(index), [s, index]() { s->pop_index(index); },
+      std::forward<Args>(args)...);
+}
+
+template <typename T, uint64_t ShardBytes, uint32_t Shards, typename Options>
+void ShardedFreeList<T, ShardBytes, Shards, Options>::free(T* item) noexcept {
+  assert(item);
+  Shard* s = shard(item);
+  const uint32_t i = shard_number(s);
+  if (i == local_shard()) {
+    s->free(item);
+    return;
+  }
+
+  // placement-delete the item, and push it onto the return queue. Only the
+  // head is compared, so a push is not affected by the ABA problem.
+  const index_type index = s->index(item);
+  item->~T();
+  ShardState& state = shards[i];
+  state.queued.fetch_add(1, std::memory_order_relaxed);
+  index_type next = state.queue.load(std::memory_order_relaxed);
+  do {
+    std::memcpy(static_cast<void*>(item), &next, sizeof(next));
+    // Release, to publish the link stored in the element
+  } while (!state.queue.compare_exchange_weak(next, index,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+}
+
+template <typename T, uint64_t ShardBytes, uint32_t Shards, typename Options>
+typename ShardedFreeList<T, ShardBytes, Shards, Options>::size_type
+ShardedFreeList<T, ShardBytes, Shards, Options>::collect() noexcept {
+  size_type result = 0;
+  for (uint32_t i = 0; i < Shards; ++i) {
+    result += drain(i);
+  }
+  return result;
+}
+
+template <typename T, uint64_t ShardBytes, uint32_t Shards, typename Options>
+uint32_t ShardedFreeList<T, ShardBytes, Shards, Options>::shard_number(
+    Shard const* s) const noexcept {
+  uint32_t i = 0;
+  while (shards[i].shard.load(std::memory_order_relaxed) != s) {
+    ++i;
+    assert(i < Shards);
+  }
+  return i;
+}
+
+template <typename T, uint64_t ShardBytes, uint32_t Shards, typename Options>
+typename ShardedFreeList<T, ShardBytes, Shards, Options>::index_type
+ShardedFreeList<T, ShardBytes, Shards, Options>::take(uint32_t i) noexcept {
+  Shard* s = shards[i].shard.load(std::memory_order_relaxed);
+  index_type index = s->push_index();
+  if (!index && drain(i)) {
+    index = s->push_index();
+  }
+  return index;
+}
+
+template <typename T, uint64_t ShardBytes, uint32_t Shards, typename Options>
+typename ShardedFreeList<T, ShardBytes, Shards, Options>::size_type
+ShardedFreeList<T, ShardBytes, Shards, Options>::drain(uint32_t i) noexcept {
+  ShardState& state = shards[i];
+  if (!state.queue.load(std::memory_order_relaxed)) return 0;
+
+  // Take the whole queue at once. Acquire, to see the links stored in the
+  // elements.
+  index_type index = state.queue.exchange(0, std::memory_order_acquire);
+  Shard* s = state.shard.load(std::memory_order_relaxed);
+  index_type batch[kBatchSize];
+  size_type n = 0, result = 0;
+  while (index) {
+    batch[n++] = index;
+    std::memcpy(&index, static_cast<void const*>(s->get(index)),
+                sizeof(index));
+    if (n == kBatchSize || !index) {
+      // Uncount before returning, so that size() never underflows
+      state.queued.fetch_sub(n, std::memory_order_relaxed);
+      s->pop_indices(batch, n);
+      result += n;
+      n = 0;
+    }
+  }
+  return result;
+}
+
+template <typename T, uint64_t ShardBytes, uint32_t Shards, typename Options>
+typename ShardedFreeList<T, ShardBytes, Shards, Options>::Shard*
+ShardedFreeList<T, ShardBytes, Shards, Options>::add_shard(
+    uint32_t i) noexcept {
+  void* memory = detail::aligned_allocate(ShardBytes, ShardBytes);
+  if (!memory) return nullptr;
+
+  // Touch every page from this thread, to place them on its NUMA node
+  std::memset(memory, 0, ShardBytes);
+  Shard* s = new (memory) Shard();
+
+  // Another thread of this shard may have allocated it in the meantime
+  Shard* expected = nullptr;
+  if (!shards[i].shard.compare_exchange_strong(expected, s,
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+    s->~Shard();
+    detail::aligned_deallocate(memory);
+    return expected;
+  }
+  return s;
+}
+
+}  // namespace freelist
+
+#endif  // INCLUDE_FREELIST_SHARDED_FREELIST_H_
@@ -0,0 +1,210 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INCLUDE_FREELIST_SHARED_FREELIST_H_
+#define INCLUDE_FREELIST_SHARED_FREELIST_H_
+
+#include <freelist/freelist_view.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <string>
+#include <system_error>
+
+namespace freelist {
+
+/**
+ * FreeList stored in a named POSIX shared memory segment, so that it may be
+ * used by several processes at once.
+ *
+ * One process creates the segment with create(), others map it with open().
+ * Each process maps the segment at its own address, so items should be passed
+ * between processes by index: index() and get() of the view translate between
+ * indexes and pointers in the calling process. The ABA tag and counters are
+ * stored in the segment, so concurrent alloc and free are safe across
+ * processes as well as threads.
+ *
+ * T should not contain pointers, as these are not valid in other processes.
+ * Items are not destroyed when the segment is unmapped or unlinked.
+ *
+ * @tparam T Data type to store.
+ * @tparam Options Compile-time options, see FreeListOptions.
+ */
+template <typename T, typename Options = FreeListOptions>
+class SharedMemoryFreeList {
+  static_assert(Options::kThreadSafe,
+                "SharedMemoryFreeList requires thread-safe options");
+
+ public:
+  using view_type = FreeListView<T, Options>;
+  using size_type = typename view_type::size_type;
+
+  /**
+   * Create a new shared memory segment, and construct an empty FreeList in it.
+   * @param name Name of the segment, see shm_open().
+   * @param bytes Size of the segment in bytes.
+   * @return Mapping of the segment in this process.
+   * @exception std::system_error If the segment already exists or cannot be
+   * created or mapped.
+   * @exception std::invalid_argument If bytes is too small for one item.
+   */
+  inline static SharedMemoryFreeList create(std::string const& name,
+                                            size_type bytes);
+
+  /**
+   * Map an existing shared memory segment, containing a FreeList constructed by
+   * create(). The FreeList is not modified.
+   * @param name Name of the segment, see shm_open().
+   * @return Mapping of the segment in this process.
+   * @exception std::system_error If the segment cannot be opened or mapped.
+   * @exception std::invalid_argument If the segment does not contain an
+   * initialised FreeList of the same element type.
+   */
+  inline static SharedMemoryFreeList open(std::string const& name);
+
+  /**
+   * Remove the name of a shared memory segment. Existing mappings remain valid.
+   * @param name Name of the segment, see shm_open().
+   * @return True if the segment was removed.
+   */
+  inline static bool unlink(std::string const& name) noexcept {
+    return shm_unlink(name.c_str()) == 0;
+  }
+
+  inline SharedMemoryFreeList(SharedMemoryFreeList&& other) noexcept
+      : mapping(other.mapping), bytes(other.bytes), freeList(other.freeList) {
+    other.mapping = nullptr;
+  }
+
+  SharedMemoryFreeList(SharedMemoryFreeList const&) = delete;
+  SharedMemoryFreeList& operator=(SharedMemoryFreeList const&) = delete;
+
+  /**
+   * Unmap the segment from this process. The segment and its items persist.
+   */
+  inline ~SharedMemoryFreeList() {
+    if (mapping) munmap(mapping, bytes);
+  }
+
+  /**
+   * @return The FreeList in the segment.
+   */
+  inline view_type& view() noexcept { return freeList; }
+  inline view_type const& view() const noexcept { return freeList; }
+
+  /**
+   * @return Address of the segment in this process.
+   */
+  inline void* data() const noexcept { return mapping; }
+
+ private:
+  inline SharedMemoryFreeList(void* mapping, size_type bytes,
+                              view_type freeList) noexcept
+      : mapping(mapping), bytes(bytes), freeList(freeList) {}
+
+  // Map the whole of the open file descriptor, closing it afterwards
+  inline static void* map(int fd, size_type bytes);
+
+  inline static std::system_error error(char const* what) {
+    return std::system_error(errno, std::generic_category(), what);
+  }
+
+  void* mapping;
+  size_type bytes;
+  view_type freeList;
+};
+
+template <typename T, typename Options>
+SharedMemoryFreeList<T, Options> SharedMemoryFreeList<T, Options>::create(
+    std::string const& name, const size_type bytes) {
+  if (!view_type::capacity_for(bytes)) {
+    throw std::invalid_argument("SharedMemoryFreeList size is too small");
+  }
+
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0) throw error("shm_open");
+  if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+    std::system_error e = error("ftruncate");
+    close(fd);
+    shm_unlink(name.c_str());
+    throw e;
+  }
+
+  void* mapping;
+  try {
+    mapping = map(fd, bytes);
+  } catch (...) {
+    shm_unlink(name.c_str());
+    throw;
+  }
+  return SharedMemoryFreeList(mapping, bytes, view_type(mapping, bytes));
+}
+
+template <typename T, typename Options>
+SharedMemoryFreeList<T, Options> SharedMemoryFreeList<T, Options>::open(
+    std::string const& name) {
+  int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd < 0) throw error("shm_open");
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    std::system_error e = error("fstat");
+    close(fd);
+    throw e;
+  }
+  const size_type bytes = static_cast<size_type>(st.st_size);
+  if (bytes == 0) {
+    close(fd);
+    throw std::invalid_argument("SharedMemoryFreeList is not initialised");
+  }
+
+  void* mapping = map(fd, bytes);
+  try {
+    return SharedMemoryFreeList(mapping, bytes,
+                                view_type::attach(mapping, bytes));
+  } catch (...) {
+    munmap(mapping, bytes);
+    throw;
+  }
+}
+
+template <typename T, typename Options>
+void* SharedMemoryFreeList<T, Options>::map(const int fd,
+                                            const size_type bytes) {
+  void* mapping =
+      mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    std::system_error e = error("mmap");
+    close(fd);
+    throw e;
+  }
+  close(fd);
+  return mapping;
+}
+
+}  // namespace freelist
+
+#endif  // INCLUDE_FREELIST_SHARED_FREELIST_H_
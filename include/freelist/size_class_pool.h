@@ -0,0 +1,415 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INCLUDE_FREELIST_SIZE_CLASS_POOL_H_
+#define INCLUDE_FREELIST_SIZE_CLASS_POOL_H_
+
+#include <freelist/freelist.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <tuple>
+
+namespace freelist {
+
+namespace detail {
+
+/**
+ * Index of the first of sizes that is at least bytes, counting from i, or i
+ * plus the number of sizes if there is none.
+ */
+constexpr std::size_t find_size_class(std::size_t, std::size_t i) {
+  return i;
+}
+
+template <typename... Rest>
+constexpr std::size_t find_size_class(std::size_t bytes, std::size_t i,
+                                      std::size_t first, Rest... rest) {
+  return first >= bytes ? i : find_size_class(bytes, i + 1, rest...);
+}
+
+/**
+ * Greatest common divisor of a and b.
+ */
+constexpr std::size_t gcd(std::size_t a, std::size_t b) {
+  return b ? gcd(b, a % b) : a;
+}
+
+constexpr std::size_t gcd_of(std::size_t a) { return a; }
+
+template <typename... Rest>
+constexpr std::size_t gcd_of(std::size_t a, std::size_t b, Rest... rest) {
+  return gcd_of(gcd(a, b), rest...);
+}
+
+/**
+ * Last of sizes.
+ */
+constexpr std::size_t last_of(std::size_t a) { return a; }
+
+template <typename... Rest>
+constexpr std::size_t last_of(std::size_t, std::size_t b, Rest... rest) {
+  return last_of(b, rest...);
+}
+
+/**
+ * Largest power of two dividing bytes, at most limit.
+ */
+constexpr std::size_t natural_alignment(std::size_t bytes, std::size_t limit) {
+  return (bytes & (~bytes + 1)) < limit ? (bytes & (~bytes + 1)) : limit;
+}
+
+/**
+ * True if each of sizes is larger than the one before.
+ */
+constexpr bool strictly_increasing(std::size_t) { return true; }
+
+template <typename... Rest>
+constexpr bool strictly_increasing(std::size_t a, std::size_t b,
+                                   Rest... rest) {
+  return a < b && strictly_increasing(b, rest...);
+}
+
+/**
+ * Table of the size class of each multiple of Granule, indexed by the
+ * multiple: kClassOf[i] is the index of the first of Classes that holds
+ * i * Granule bytes.
+ */
+template <typename Indices, std::size_t Granule, std::size_t... Classes>
+struct SizeClassTable;
+
+template <std::size_t... I, std::size_t Granule, std::size_t... Classes>
+struct SizeClassTable<index_sequence<I...>, Granule, Classes...> {
+  static constexpr uint8_t kClassOf[] = {
+      static_cast<uint8_t>(find_size_class(I * Granule, 0, Classes...))...};
+};
+
+template <std::size_t... I, std::size_t Granule, std::size_t... Classes>
+constexpr uint8_t
+    SizeClassTable<index_sequence<I...>, Granule, Classes...>::kClassOf[];
+
+}  // namespace detail
+
+/**
+ * General-purpose allocator of blocks of varying size from a fixed set of
+ * size classes, without the heap. Each size class is a FreeList of
+ * ClassBytes bytes, holding blocks of one of Classes bytes, all stored in
+ * the BasicSizeClassPool itself.
+ *
+ * A request is served from the smallest class that holds it. The class is
+ * found in O(1) from a table computed at compile time, indexed by the size
+ * rounded up to the greatest common divisor of Classes. If that class is
+ * full, the next larger classes are tried. deallocate() must be passed the
+ * same size and alignment as allocate(); it finds the class in the same way,
+ * then checks which FreeList holds the block.
+ *
+ * Blocks of each class are aligned to the largest power of two dividing the
+ * class size, at most Options::kCacheLineSize. Requests with stricter
+ * alignment than their class use a larger class.
+ *
+ * allocate() and deallocate() may be called concurrently if
+ * Options::kThreadSafe.
+ *
+ * @tparam Options Compile-time options for each FreeList, see
+ * FreeListOptions.
+ * @tparam ClassBytes Number of bytes of each size class FreeList.
+ * @tparam Classes Block sizes of the size classes, in increasing order.
+ */
+template <typename Options, uint64_t ClassBytes, std::size_t... Classes>
+class BasicSizeClassPool {
+ public:
+  static_assert(sizeof...(Classes) > 0 && sizeof...(Classes) < 256,
+                "SizeClassPool requires 1 to 255 size classes");
+  static_assert(detail::strictly_increasing(Classes...),
+                "SizeClassPool classes must be in increasing order");
+
+  using size_type = uint64_t;
+
+  /**
+   * Number of size classes.
+   */
+  static constexpr std::size_t kClassCount = sizeof...(Classes);
+
+  /**
+   * Largest block size, larger requests fail.
+   */
+  static constexpr std::size_t kMaxBytes = detail::last_of(Classes...);
+
+  /**
+   * Construct a pool with all size classes empty.
+   */
+  BasicSizeClassPool() = default;
+
+  BasicSizeClassPool(BasicSizeClassPool const&) = delete;
+  BasicSizeClassPool& operator=(BasicSizeClassPool const&) = delete;
+
+  /**
+   * Allocate a block.
+   * @param bytes Size of the block in bytes.
+   * @param alignment Alignment of the block, a power of two, or 0 for the
+   * largest power of two dividing bytes, at most alignof(std::max_align_t),
+   * which suffices for any object of that size.
+   * @return Pointer to the block.
+   * @exception std::bad_alloc If bytes or alignment is too large, or all
+   * classes that could hold the block are full.
+   */
+  inline void* allocate(std::size_t bytes, std::size_t alignment = 0) {
+    void* p = try_allocate(bytes, alignment);
+    if (!p) throw std::bad_alloc();
+    return p;
+  }
+
+  /**
+   * Allocate a block, without throwing.
+   * @see allocate
+   * @return Pointer to the block, or nullptr on failure.
+   */
+  inline void* try_allocate(std::size_t bytes,
+                             std::size_t alignment = 0) noexcept;
+
+  /**
+   * Return a block to its size class.
+   * @param p Pointer to the block, from allocate() or try_allocate().
+   * @param bytes Size passed when allocating the block.
+   * @param alignment Alignment passed when allocating the block.
+   */
+  inline void deallocate(void* p, std::size_t bytes,
+                         std::size_t alignment = 0) noexcept;
+
+  /**
+   * Get the size class that serves a request, if it is not full.
+   * @param bytes Size of the block in bytes.
+   * @param alignment Alignment of the block, see allocate().
+   * @return Index of the size class in Classes, or kClassCount if no class
+   * holds the block.
+   */
+  inline static std::size_t size_class(std::size_t bytes,
+                                       std::size_t alignment = 0) noexcept;
+
+  /**
+   * Get the block size of a size class.
+   * @param c Index of the size class.
+   * @return Block size in bytes.
+   */
+  inline static std::size_t class_bytes(std::size_t c) noexcept {
+    assert(c < kClassCount);
+    static constexpr std::size_t kSizes[] = {Classes...};
+    return kSizes[c];
+  }
+
+  /**
+   * Check if a block was allocated from this pool.
+   * @param p Pointer to check.
+   * @return True if p is within one of the size class FreeLists.
+   */
+  inline bool owns(void const* p) const noexcept {
+    return p >= static_cast<void const*>(this) &&
+           p < static_cast<void const*>(this + 1);
+  }
+
+  /**
+   * Get the number of blocks allocated from a size class.
+   * @param c Index of the size class.
+   * @return Number of active blocks.
+   */
+  inline size_type size(std::size_t c) const noexcept {
+    return dispatch_size(c, Indices());
+  }
+
+ private:
+  using Indices = typename detail::make_index_sequence<kClassCount>::type;
+
+  template <std::size_t Bytes>
+  using Block = detail::RawBlock<
+      Bytes, detail::natural_alignment(Bytes, Options::kCacheLineSize)>;
+
+  // Alignment of the blocks of class c
+  static std::size_t class_alignment(std::size_t c) noexcept {
+    return detail::natural_alignment(class_bytes(c), Options::kCacheLineSize);
+  }
+
+  // Alignment needed for a request, see allocate()
+  static std::size_t required_alignment(std::size_t bytes,
+                                        std::size_t alignment) noexcept {
+    assert((alignment & (alignment - 1)) == 0);
+    if (alignment) return alignment;
+    return detail::natural_alignment(bytes ? bytes : 1,
+                                     alignof(std::max_align_t));
+  }
+
+  template <std::size_t I>
+  using List = typename std::tuple_element<
+      I, std::tuple<FreeList<Block<Classes>, ClassBytes, Options>...>>::type;
+
+  // Requests are rounded up to a multiple of kGranule to index the table
+  static constexpr std::size_t kGranule = detail::gcd_of(Classes...);
+
+  using Table = detail::SizeClassTable<
+      typename detail::make_index_sequence<kMaxBytes / kGranule + 1>::type,
+      kGranule, Classes...>;
+
+  // Takes a block from class I, or returns nullptr if full
+  template <std::size_t I>
+  static void* allocate_from(BasicSizeClassPool& pool) noexcept {
+    List<I>& list = std::get<I>(pool.lists);
+    const typename List<I>::index_type index = list.push_index();
+    return index ? list.get(index) : nullptr;
+  }
+
+  // Returns a block to class I, or returns false if it is not from class I
+  template <std::size_t I>
+  static bool deallocate_to(BasicSizeClassPool& pool, void* p) noexcept {
+    List<I>& list = std::get<I>(pool.lists);
+    if (p < static_cast<void*>(&list) || p >= static_cast<void*>(&list + 1)) {
+      return false;
+    }
+    list.pop_index(
+        list.index(static_cast<typename List<I>::value_type*>(p)));
+    return true;
+  }
+
+  template <std::size_t I>
+  static size_type size_of(BasicSizeClassPool const& pool) noexcept {
+    return std::get<I>(pool.lists).size();
+  }
+
+  template <std::size_t... I>
+  inline void* dispatch_allocate(std::size_t c,
+                                 detail::index_sequence<I...>) noexcept {
+    using Function = void* (*)(BasicSizeClassPool&);
+    static constexpr Function kFunctions[] = {&allocate_from<I>...};
+    return kFunctions[c](*this);
+  }
+
+  template <std::size_t... I>
+  inline bool dispatch_deallocate(std::size_t c, void* p,
+                                  detail::index_sequence<I...>) noexcept {
+    using Function = bool (*)(BasicSizeClassPool&, void*);
+    static constexpr Function kFunctions[] = {&deallocate_to<I>...};
+    return kFunctions[c](*this, p);
+  }
+
+  template <std::size_t... I>
+  inline size_type dispatch_size(std::size_t c, detail::index_sequence<I...>)
+      const noexcept {
+    using Function = size_type (*)(BasicSizeClassPool const&);
+    static constexpr Function kFunctions[] = {&size_of<I>...};
+    return kFunctions[c](*this);
+  }
+
+  std::tuple<FreeList<Block<Classes>, ClassBytes, Options>...> lists;
+};
+
+/**
+ * BasicSizeClassPool with default options.
+ */
+template <uint64_t ClassBytes, std::size_t... Classes>
+using SizeClassPool =
+    BasicSizeClassPool<FreeListOptions, ClassBytes, Classes...>;
+
+namespace detail {
+
+template <typename Options, uint64_t ClassBytes, std::size_t Bytes,
+          std::size_t MaxBytes, std::size_t... Classes>
+struct PowerOfTwoClasses
+    : PowerOfTwoClasses<Options, ClassBytes, Bytes * 2, MaxBytes, Classes...,
+                        Bytes> {};
+
+template <typename Options, uint64_t ClassBytes, std::size_t MaxBytes,
+          std::size_t... Classes>
+struct PowerOfTwoClasses<Options, ClassBytes, MaxBytes * 2, MaxBytes,
+                         Classes...> {
+  using type = BasicSizeClassPool<Options, ClassBytes, Classes...>;
+};
+
+template <typename Options, uint64_t ClassBytes, std::size_t MaxBytes>
+struct PowerOfTwoPool {
+  static constexpr bool kValid =
+      MaxBytes >= 8 && (MaxBytes & (MaxBytes - 1)) == 0;
+  static_assert(kValid, "MaxBytes must be a power of two of at least 8");
+
+  // If MaxBytes is invalid, stop at 8 bytes rather than recursing forever
+  using type = typename PowerOfTwoClasses<Options, ClassBytes, 8,
+                                          kValid ? MaxBytes : 8>::type;
+};
+
+}  // namespace detail
+
+/**
+ * BasicSizeClassPool with a size class for each power of two from 8 bytes to
+ * MaxBytes, which must be a power of two.
+ */
+template <uint64_t ClassBytes, std::size_t MaxBytes,
+          typename Options = FreeListOptions>
+using PowerOfTwoSizeClassPool =
+    typename detail::PowerOfTwoPool<Options, ClassBytes, MaxBytes>::type;
+
+template <typename Options, uint64_t ClassBytes, std::size_t... Classes>
+constexpr std::size_t
+    BasicSizeClassPool<Options, ClassBytes, Classes...>::kClassCount;
+
+template <typename Options, uint64_t ClassBytes, std::size_t... Classes>
+constexpr std::size_t
+    BasicSizeClassPool<Options, ClassBytes, Classes...>::kMaxBytes;
+
+template <typename Options, uint64_t ClassBytes, std::size_t... Classes>
+std::size_t BasicSizeClassPool<Options, ClassBytes, Classes...>::size_class(
+    const std::size_t bytes, const std::size_t alignment) noexcept {
+  const std::size_t align = required_alignment(bytes, alignment);
+  if (bytes > kMaxBytes || align > Options::kCacheLineSize) {
+    return kClassCount;
+  }
+
+  // Classes that are too loosely aligned are skipped, which only happens for
+  // alignments stricter than the natural alignment of the classes
+  std::size_t c = Table::kClassOf[(bytes + kGranule - 1) / kGranule];
+  while (c < kClassCount && class_alignment(c) < align) ++c;
+  return c;
+}
+
+template <typename Options, uint64_t ClassBytes, std::size_t... Classes>
+void* BasicSizeClassPool<Options, ClassBytes, Classes...>::try_allocate(
+    const std::size_t bytes, const std::size_t alignment) noexcept {
+  // Larger classes are only used when the smaller ones are full
+  const std::size_t align = required_alignment(bytes, alignment);
+  for (std::size_t c = size_class(bytes, alignment); c < kClassCount; ++c) {
+    if (class_alignment(c) < align) continue;
+    if (void* p = dispatch_allocate(c, Indices())) return p;
+  }
+  return nullptr;
+}
+
+template <typename Options, uint64_t ClassBytes, std::size_t... Classes>
+void BasicSizeClassPool<Options, ClassBytes, Classes...>::deallocate(
+    void* p, const std::size_t bytes, const std::size_t alignment) noexcept {
+  assert(p);
+  std::size_t c = size_class(bytes, alignment);
+  // The block is in the class for its size, unless that class was full
+  while (c < kClassCount && !dispatch_deallocate(c, p, Indices())) ++c;
+  assert(c < kClassCount);
+}
+
+}  // namespace freelist
+
+#endif  // INCLUDE_FREELIST_SIZE_CLASS_POOL_H_
@@ -0,0 +1,340 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INCLUDE_FREELIST_SOA_FREELIST_H_
+#define INCLUDE_FREELIST_SOA_FREELIST_H_
+
+#include <freelist/freelist.h>
+
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace freelist {
+
+namespace detail {
+
+/**
+ * True if every one of Bools is true.
+ */
+template <bool... Bools>
+struct all_of
+    : std::is_same<all_of<Bools...>, all_of<(Bools || true)...>> {};
+
+}  // namespace detail
+
+/**
+ * Structure-of-arrays FreeList: each item is a set of fields, and each field
+ * is stored in its own contiguous array, so that a sweep over one field of
+ * all items only reads that field. The free list is linked through a
+ * separate array of indexes, so free elements keep their field values and
+ * the arrays contain only field values.
+ *
+ * Items are identified by index, as returned by alloc() and push_index().
+ * column<I>() is the array of field I, indexed by item index; indexes of
+ * items are in [1, end_index()), so a sweep may run over that range of a
+ * column, or visit only the active items with for_each_live().
+ * Each column is aligned to Options::kCacheLineSize.
+ *
+ * Fields must be trivially copyable: items are not constructed or destroyed,
+ * only assigned. alloc() and free() may be called concurrently, as for
+ * FreeList; clear() and for_each_live() must not be called concurrently with
+ * anything else.
+ *
+ * @tparam Options Compile-time options, see FreeListOptions. Only
+ * kThreadSafe, kCacheLineAligned, kCacheLineSize and kPrefetch are used.
+ * @tparam Fields Types of the fields of each item.
+ */
+template <typename Options, typename... Fields>
+class BasicSoAFreeList {
+ public:
+  static_assert(sizeof...(Fields) > 0, "SoAFreeList requires a field");
+  static_assert(
+      detail::all_of<std::is_trivially_copyable<Fields>::value...>::value,
+      "SoAFreeList fields must be trivially copyable");
+
+  /**
+   * Type used for storing indexes. Up to 2^32 - 2 items are supported.
+   */
+  using index_type = uint32_t;
+
+  using size_type = uint64_t;
+
+  /**
+   * Type of field I.
+   */
+  template <std::size_t I>
+  using field_type =
+      typename std::tuple_element<I, std::tuple<Fields...>>::type;
+
+  /**
+   * References to the fields of one item, returned by get().
+   */
+  using reference = std::tuple<Fields&...>;
+
+  /**
+   * Construct an empty SoAFreeList, allocating all columns from the heap.
+   * @param capacity Maximum number of items.
+   * @exception std::bad_alloc If the columns cannot be allocated.
+   * @exception std::invalid_argument If capacity is 0 or too large for
+   * index_type.
+   */
+  inline explicit BasicSoAFreeList(size_type capacity);
+
+  BasicSoAFreeList(BasicSoAFreeList const&) = delete;
+  BasicSoAFreeList& operator=(BasicSoAFreeList const&) = delete;
+
+  /**
+   * Destructor, releases all columns.
+   */
+  inline ~BasicSoAFreeList() noexcept { detail::aligned_deallocate(memory); }
+
+  /**
+   * Check if the SoAFreeList is empty.
+   * @return True if no items are active.
+   */
+  inline bool empty() const noexcept { return size() == 0; }
+
+  /**
+   * Check if the SoAFreeList is full.
+   * @return True if the SoAFreeList is full.
+   */
+  inline bool full() const noexcept { return size() >= max_size(); }
+
+  /**
+   * Check the number of active items.
+   * @return Number of active items.
+   */
+  inline index_type size() const noexcept { return control.size(); }
+
+  /**
+   * Get the maximum number of items that can be stored.
+   * @return Capacity.
+   */
+  inline index_type max_size() const noexcept { return end - 1; }
+
+  /**
+   * Synonym for max_size()
+   */
+  inline index_type capacity() const noexcept { return max_size(); }
+
+  /**
+   * Get one past the highest index that has been used. Every active item
+   * has an index in [1, end_index()).
+   * @return One past the highest used index.
+   */
+  inline index_type end_index() const noexcept {
+    return control.next_index(end);
+  }
+
+  /**
+   * Removes all items. Field values are left as they were.
+   */
+  inline void clear() noexcept { control.reset(1); }
+
+  /**
+   * Allocates a new item, and assigns its fields.
+   * @param values Value of each field.
+   * @return Index of the new item.
+   * @exception std::bad_alloc If the SoAFreeList is full.
+   */
+  inline index_type alloc(Fields const&... values);
+
+  /**
+   * Allocates a new item, and assigns its fields, without throwing if the
+   * SoAFreeList is full.
+   * @param values Value of each field.
+   * @return Index of the new item, or 0 if full.
+   */
+  inline index_type emplace(Fields const&... values) noexcept;
+
+  /**
+   * Deletes an item. Synonym for pop_index().
+   * @param index Index of item to delete.
+   */
+  inline void free(index_type index) noexcept { pop_index(index); }
+
+  /**
+   * Creates new item, its fields keep the values they had.
+   * @return Index of new item, or 0 if full.
+   */
+  inline index_type push_index() noexcept {
+    return control.push_index(links, end);
+  }
+
+  /**
+   * Removes item at specified index.
+   * @param index Index of item to remove.
+   */
+  inline void pop_index(index_type index) noexcept {
+    assert(index >= 1);
+    assert(index < end);
+    control.pop_chain(links, index, index, 1);
+  }
+
+  /**
+   * Get the array of field I of all items, indexed by item index.
+   * @return Pointer to the first element of the column, at index 0, which
+   * is never used by an item.
+   */
+  template <std::size_t I>
+  inline field_type<I>* column() const noexcept {
+    return std::get<I>(columns);
+  }
+
+  /**
+   * Get field I of an item.
+   * @param index Index of item.
+   * @return Reference to the field.
+   */
+  template <std::size_t I>
+  inline field_type<I>& get(index_type index) const noexcept {
+    assert(index >= 1);
+    assert(index < end);
+    return std::get<I>(columns)[index];
+  }
+
+  /**
+   * Get all fields of an item.
+   * @param index Index of item.
+   * @return Tuple of references to the fields.
+   */
+  inline reference get(index_type index) const noexcept {
+    return get(index, Indices());
+  }
+
+  /**
+   * Call f(index) for each active item, in increasing order of index.
+   * @see FreeList::for_each_live
+   */
+  template <typename F>
+  inline void for_each_live(F&& f) {
+    control.for_each_active(links, 1, end, std::forward<F>(f));
+  }
+
+ private:
+  using Indices =
+      typename detail::make_index_sequence<sizeof...(Fields)>::type;
+
+  // Element of the array linking the free list, see FreeListElement
+  struct Link {
+    index_type index;
+  };
+
+  using Control = detail::FreeListControl<index_type, 32, Options>;
+
+  template <std::size_t... I>
+  inline reference get(index_type index,
+                       detail::index_sequence<I...>) const noexcept {
+    return reference(std::get<I>(columns)[index]...);
+  }
+
+  template <std::size_t... I>
+  inline void assign(index_type index, detail::index_sequence<I...>,
+                     Fields const&... values) noexcept {
+    int expand[] = {0, (std::get<I>(columns)[index] = values, 0)...};
+    (void)expand;
+  }
+
+  // Bytes of one column of n elements of size bytes, padded to a cache line
+  static size_type column_bytes(std::size_t bytes, size_type n) noexcept {
+    return detail::round_up(bytes * n, Options::kCacheLineSize);
+  }
+
+  // Sets each column, then links, to its place in memory, one after another
+  template <std::size_t... I>
+  inline void layout(detail::index_sequence<I...>) noexcept;
+
+  Control control;
+  // One past the last usable index
+  index_type end;
+  void* memory;
+  std::tuple<Fields*...> columns;
+  Link* links;
+};
+
+/**
+ * Structure-of-arrays FreeList with default options, see BasicSoAFreeList.
+ */
+template <typename... Fields>
+using SoAFreeList = BasicSoAFreeList<FreeListOptions, Fields...>;
+
+template <typename Options, typename... Fields>
+BasicSoAFreeList<Options, Fields...>::BasicSoAFreeList(
+    const size_type capacity)
+    : end(0), memory(nullptr), links(nullptr) {
+  if (!capacity || capacity >= std::numeric_limits<index_type>::max()) {
+    throw std::invalid_argument("SoAFreeList capacity is out of range");
+  }
+  end = static_cast<index_type>(capacity + 1);
+
+  size_type bytes = sizeof(Link) * end;
+  for (std::size_t size : {sizeof(Fields)...}) bytes += column_bytes(size, end);
+  memory = detail::aligned_allocate(bytes, Options::kCacheLineSize);
+  if (!memory) throw std::bad_alloc();
+  layout(Indices());
+
+  control.reset(1);
+}
+
+template <typename Options, typename... Fields>
+template <std::size_t... I>
+void BasicSoAFreeList<Options, Fields...>::layout(
+    detail::index_sequence<I...>) noexcept {
+  char* next = static_cast<char*>(memory);
+  int expand[] = {
+      0, (std::get<I>(columns) = reinterpret_cast<field_type<I>*>(next),
+          next += column_bytes(sizeof(field_type<I>), end), 0)...};
+  (void)expand;
+  links = reinterpret_cast<Link*>(next);
+}
+
+template <typename Options, typename... Fields>
+typename BasicSoAFreeList<Options, Fields...>::index_type
+BasicSoAFreeList<Options, Fields...>::alloc(Fields const&... values) {
+  const index_type index = emplace(values...);
+  if (!index) {
+    throw std::bad_alloc();
+  }
+  return index;
+}
+
+template <typename Options, typename... Fields>
+typename BasicSoAFreeList<Options, Fields...>::index_type
+BasicSoAFreeList<Options, Fields...>::emplace(
+    Fields const&... values) noexcept {
+  const index_type index = push_index();
+  if (index) {
+    assign(index, Indices(), values...);
+  }
+  return index;
+}
+
+}  // namespace freelist
+
+#endif  // INCLUDE_FREELIST_SOA_FREELIST_H_
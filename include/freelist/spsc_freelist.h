@@ -0,0 +1,370 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INCLUDE_FREELIST_SPSC_FREELIST_H_
+#define INCLUDE_FREELIST_SPSC_FREELIST_H_
+
+#include <freelist/freelist.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace freelist {
+
+/**
+ * SpscFreeList is a FreeList for one allocating thread and one freeing
+ * thread, such as two stages of a pipeline. Both alloc() and free() are
+ * wait-free: neither contains a compare-and-swap loop.
+ *
+ * The allocating thread owns the free list and the never-used elements, and
+ * updates them with plain loads and stores. The freeing thread links freed
+ * elements into a separate return chain, published in a single word. When
+ * its own free list is empty, the allocating thread takes the whole return
+ * chain with one exchange and it becomes its free list.
+ *
+ * To free an element, the freeing thread links it in front of the chain it
+ * last published, which only it writes to, and publishes the result with a
+ * single compare-exchange. If that fails, the allocating thread has taken the
+ * chain, and the element alone is published as a new chain. The return chain
+ * word always holds every freed element not yet taken, so an allocation only
+ * fails when all elements are in use.
+ *
+ * Only Options::kCacheLineAligned and Options::kCacheLineSize are used; the
+ * control words of the two threads are then on separate cache lines.
+ *
+ * @tparam T Data type to store.
+ * @tparam Size Total number of bytes: sizeof(*this) == Size.
+ * @tparam Options Compile-time options, see FreeListOptions.
+ */
+template <typename T, uint64_t Size, typename Options = FreeListOptions>
+class SpscFreeList {
+ public:
+  static_assert(!std::is_abstract<T>::value,
+                "Stored data type must not be abstract");
+
+  /**
+   * Type that is stored in each active element.
+   */
+  using value_type = T;
+
+  /**
+   * Type used for storing indexes, as in FreeList.
+   */
+  using index_type = typename FreeList<T, Size, Options>::index_type;
+
+  using size_type = uint64_t;
+
+  /**
+   * Construct an empty SpscFreeList.
+   */
+  inline SpscFreeList() noexcept;
+
+  SpscFreeList(SpscFreeList const&) = delete;
+  SpscFreeList& operator=(SpscFreeList const&) = delete;
+
+  /**
+   * Destructor, calls delete on all existing items.
+   */
+  inline ~SpscFreeList() noexcept { clear(); }
+
+  /**
+   * Check if the SpscFreeList is empty. Only for use by the allocating
+   * thread.
+   * @return True if no items are active.
+   */
+  inline bool empty() const noexcept { return size() == 0; }
+
+  /**
+   * Check the number of active items. Only for use by the allocating thread.
+   * Items freed by an unfinished free() may still be counted.
+   * @return Number of active items.
+   */
+  inline index_type size() const noexcept;
+
+  /**
+   * Get the maximum number of items that can be stored.
+   * @return Capacity.
+   */
+  inline static index_type max_size() noexcept {
+    return kIndexCount - kElementOverheadCount;
+  }
+
+  /**
+   * Deletes all items. Must not be called concurrently with alloc() or
+   * free().
+   */
+  inline void clear() noexcept;
+
+  /**
+   * Allocates a new item, and calls constructor. Only for use by the
+   * allocating thread.
+   * @tparam Args Type of arguments for item constructor.
+   * @param args Arguments to provide to item constructor.
+   * @return Pointer to new item.
+   * @exception std::bad_alloc If the SpscFreeList is full.
+   * @exception any Exceptions thrown by the constructor are forwarded.
+   * If any exception is thrown, the freelist state will be unchanged.
+   */
+  template <typename... Args>
+  inline T* alloc(Args&&... args);
+
+  /**
+   * Deletes an item, and calls destructor. Only for use by the freeing
+   * thread.
+   * @param item Pointer to item to delete.
+   */
+  inline void free(T* item) noexcept;
+
+  /**
+   * Creates new item, does not call constructor. Only for use by the
+   * allocating thread.
+   * @return Index of new item, or 0 if the SpscFreeList is full.
+   */
+  inline index_type push_index() noexcept;
+
+  /**
+   * Removes item at specified index, does not call destructor. Only for use
+   * by the freeing thread.
+   * @param index Index of item to remove.
+   */
+  inline void pop_index(index_type index) noexcept;
+
+  /**
+   * Get the index of the specified item.
+   * @param item Pointer of item to find.
+   * @return Index of the specified item.
+   */
+  inline index_type index(T const* item) const noexcept;
+
+  /**
+   * Get the item at the specified index.
+   * @param index Index of item.
+   * @return Pointer to item.
+   */
+  inline T* get(index_type index) noexcept;
+
+ private:
+  using Element = detail::FreeListElement<T, index_type>;
+
+  static constexpr uint64_t kElementSize = sizeof(Element);
+
+  static constexpr index_type kIndexCount = Size / kElementSize;
+
+  static constexpr uint32_t kIndexBits = detail::bit_width(kIndexCount - 1);
+
+  // The allocating thread's control words need no atomic operations
+  struct ConsumerOptions : Options {
+    static constexpr bool kThreadSafe = false;
+  };
+
+  using Control = detail::FreeListControl<index_type, kIndexBits,
+                                          ConsumerOptions>;
+
+  // Word holding the head of the return chain in the low kIndexBits, and
+  // its length above
+  using chain_type = detail::tagged_index_t<index_type>;
+
+  static_assert(2 * kIndexBits <= sizeof(chain_type) * 8,
+                "SpscFreeList is too large for its return chain word");
+
+  static_assert(detail::is_always_lock_free<sizeof(chain_type)>::value,
+                "SpscFreeList requires a lock-free return chain word");
+
+  static constexpr chain_type kIndexMask =
+      static_cast<chain_type>((uint64_t{1} << kIndexBits) - 1);
+
+  static constexpr std::size_t kChainAlignment =
+      Options::kCacheLineAligned ? Options::kCacheLineSize
+                                 : alignof(std::atomic<chain_type>);
+
+  struct Header {
+    Control control;
+    // Written by the freeing thread
+    alignas(kChainAlignment) std::atomic<chain_type> chain;
+  };
+
+  static constexpr index_type kElementOverheadCount =
+      (sizeof(Header) + kElementSize - 1) / kElementSize;
+
+  union alignas(Header) alignas(Element) _data {
+    // Define empty constructor and destructor - defaults are ill-formed
+    _data() {}
+    ~_data() {}
+
+    Header header;
+    Element elements[kIndexCount];
+    uint8_t bytes[Size];
+  } data;
+
+  static_assert(kIndexCount > kElementOverheadCount,
+                "SpscFreeList is too small to contain an element");
+  static_assert(Size % alignof(_data) == 0,
+                "Size must be a multiple of the alignment of SpscFreeList");
+
+  // Makes the return chain, if any, the allocating thread's free list
+  inline void take_chain() noexcept;
+};
+
+template <typename T, uint64_t Size, typename Options>
+SpscFreeList<T, Size, Options>::SpscFreeList() noexcept {
+  new (&data.header) Header();
+  data.header.control.reset(kElementOverheadCount);
+  data.header.chain.store(0, std::memory_order_relaxed);
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename SpscFreeList<T, Size, Options>::index_type
+SpscFreeList<T, Size, Options>::size() const noexcept {
+  const chain_type chain = data.header.chain.load(std::memory_order_relaxed);
+  return static_cast<index_type>(data.header.control.size() -
+                                 (chain >> kIndexBits));
+}
+
+template <typename T, uint64_t Size, typename Options>
+void SpscFreeList<T, Size, Options>::clear() noexcept {
+  Control& control = data.header.control;
+  Element* elements = data.elements;
+
+  // Join the return chain onto the free list
+  const chain_type chain =
+      data.header.chain.exchange(0, std::memory_order_acquire);
+  const index_type chainHead = static_cast<index_type>(chain & kIndexMask);
+  if (chainHead) {
+    index_type tail = chainHead;
+    while (elements[tail].index) tail = elements[tail].index;
+    control.pop_chain(elements, chainHead, tail, chain >> kIndexBits);
+  }
+
+  // Items without destructors need not be found
+  if (!std::is_trivially_destructible<T>::value && control.size()) {
+    control.for_each_active(elements, kElementOverheadCount, kIndexCount,
+                            [elements](index_type i) noexcept {
+                              // Call destructor
+                              elements[i].data.~T();
+                            });
+  }
+  control.reset(kElementOverheadCount);
+}
+
+template <typename T, uint64_t Size, typename Options>
+template <typename... Args>
+T* SpscFreeList<T, Size, Options>::alloc(Args&&... args) {
+  index_type index = push_index();
+  if (!index) {
+    throw std::bad_alloc();
+  }
+
+  // placement-new the item. If the constructor throws, the element is
+  // returned to the allocating thread's own free list.
+  Control& control = data.header.control;
+  Element* elements = data.elements;
+  return detail::construct<T>(
+      get(index),
+      [&control, elements, index]() {
+        control.pop_chain(elements, index, index, 1);
+      },
+      std::forward<Args>(args)...);
+}
+
+template <typename T, uint64_t Size, typename Options>
+void SpscFreeList<T, Size, Options>::free(T* item) noexcept {
+  assert(item);
+
+  // placement-delete the item
+  item->~T();
+  pop_index(index(item));
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename SpscFreeList<T, Size, Options>::index_type
+SpscFreeList<T, Size, Options>::push_index() noexcept {
+  Control& control = data.header.control;
+  if (!control.free_index()) take_chain();
+  return control.push_index(data.elements, kIndexCount);
+}
+
+template <typename T, uint64_t Size, typename Options>
+void SpscFreeList<T, Size, Options>::pop_index(
+    const index_type index) noexcept {
+  assert(index >= kElementOverheadCount);
+  assert(index < kIndexCount);
+  std::atomic<chain_type>& chain = data.header.chain;
+  index_type& link = data.elements[index].index;
+
+  // Only this thread stores non-zero chains, so the chain is still the one it
+  // last published, or 0 once the allocating thread has taken it. Release, to
+  // publish the link and the destruction of the item.
+  chain_type prev = chain.load(std::memory_order_relaxed);
+  link = static_cast<index_type>(prev & kIndexMask);
+  if (chain.compare_exchange_strong(
+          prev,
+          static_cast<chain_type>(
+              (((prev >> kIndexBits) + 1) << kIndexBits) | index),
+          std::memory_order_release, std::memory_order_relaxed)) {
+    return;
+  }
+
+  // Taken in the meantime: nothing else can store until this does
+  assert(prev == 0);
+  link = 0;
+  chain.store(static_cast<chain_type>((chain_type{1} << kIndexBits) | index),
+              std::memory_order_release);
+}
+
+template <typename T, uint64_t Size, typename Options>
+typename SpscFreeList<T, Size, Options>::index_type
+SpscFreeList<T, Size, Options>::index(T const* item) const noexcept {
+  assert(item);
+  const index_type index = static_cast<index_type>(
+      reinterpret_cast<Element const*>(item) - data.elements);
+  assert(index >= kElementOverheadCount);
+  assert(index < kIndexCount);
+  return index;
+}
+
+template <typename T, uint64_t Size, typename Options>
+T* SpscFreeList<T, Size, Options>::get(const index_type index) noexcept {
+  assert(index >= kElementOverheadCount);
+  assert(index < kIndexCount);
+  return &data.elements[index].data;
+}
+
+template <typename T, uint64_t Size, typename Options>
+void SpscFreeList<T, Size, Options>::take_chain() noexcept {
+  std::atomic<chain_type>& chain = data.header.chain;
+  if (!chain.load(std::memory_order_relaxed)) return;
+
+  // Acquire, to see the links stored by the freeing thread
+  const chain_type taken = chain.exchange(0, std::memory_order_acquire);
+  if (taken) {
+    data.header.control.adopt_chain(
+        static_cast<index_type>(taken & kIndexMask), taken >> kIndexBits);
+  }
+}
+
+}  // namespace freelist
+
+#endif  // INCLUDE_FREELIST_SPSC_FREELIST_H_
@@ -0,0 +1,218 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INCLUDE_FREELIST_THREAD_CACHE_H_
+#define INCLUDE_FREELIST_THREAD_CACHE_H_
+
+#include <freelist/freelist.h>
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace freelist {
+
+/**
+ * ThreadCache keeps a small private stack (magazine) of indexes in front of a
+ * shared FreeList, so that most allocations and deletions do not touch the
+ * shared FreeList at all.
+ *
+ * A ThreadCache must only be used by one thread at a time; typically each
+ * thread owns its own ThreadCache for a shared FreeList. When the magazine is
+ * empty, half a magazine of indexes is taken from the FreeList; when it is
+ * full, half a magazine is returned. Each transfer is a single batch update of
+ * the FreeList (see FreeList::push_indices and FreeList::pop_indices).
+ *
+ * Indexes held in the magazine count as active items in the size() of the
+ * parent FreeList, but are retired (see FreeList::retire_index): their handles
+ * are invalidated as soon as they are freed, and with kOccupancyBitmap they are
+ * not live, so for_each_live(), is_live(), count_live() and find_live() skip
+ * them. Without kOccupancyBitmap, for_each_live() and live() include them, so
+ * flush all ThreadCaches before a live scan. The parent FreeList must not use
+ * kAddressOrdered. All ThreadCaches must be destroyed (or flushed) before the parent FreeList
+ * is cleared or destroyed.
+ *
+ * @tparam FreeListType Type of the parent FreeList.
+ * @tparam MagazineSize Maximum number of indexes held by the cache.
+ */
+template <typename FreeListType, std::size_t MagazineSize = 32>
+class ThreadCache {
+ public:
+  static_assert(MagazineSize >= 2, "MagazineSize must be at least 2");
+
+  using value_type = typename FreeListType::value_type;
+  using index_type = typename FreeListType::index_type;
+  using size_type = typename FreeListType::size_type;
+
+  /**
+   * Construct an empty cache in front of the specified FreeList.
+   * @param parent FreeList to take indexes from and return indexes to.
+   */
+  explicit ThreadCache(FreeListType& parent) : parent(parent) {}
+
+  ThreadCache(ThreadCache const&) = delete;
+  ThreadCache& operator=(ThreadCache const&) = delete;
+
+  /**
+   * Destructor, returns all cached indexes to the parent FreeList.
+   */
+  ~ThreadCache() noexcept { flush(); }
+
+  /**
+   * Check the number of indexes currently held by the cache.
+   * @return Number of cached indexes.
+   */
+  size_type size() const noexcept { return count; }
+
+  /**
+   * Get the maximum number of indexes held by the cache.
+   * @return Magazine size.
+   */
+  static constexpr size_type max_size() noexcept { return MagazineSize; }
+
+  /**
+   * Allocates a new item, and calls constructor.
+   * @tparam Args Type of arguments for item constructor.
+   * @param args Arguments to provide to item constructor.
+   * @return Pointer to new item.
+   * @exception std::bad_alloc If the cache and the parent FreeList are empty.
+   * @exception any Exceptions thrown by the constructor are forwarded.
+   */
+  template <typename... Args>
+  inline value_type* alloc(Args&&... args);
+
+  /**
+   * Deletes an item, and calls destructor.
+   * @param item Pointer to item to delete.
+   */
+  inline void free(value_type* item) noexcept;
+
+  /**
+   * Creates new item, does not call constructor.
+   * @return Index of new item, or 0 if the parent FreeList is full.
+   */
+  inline index_type push_index() noexcept;
+
+  /**
+   * Removes item at specified index, does not call destructor.
+   * @param index Index of item to remove.
+   */
+  inline void pop_index(index_type index) noexcept;
+
+  /**
+   * Returns all cached indexes to the parent FreeList.
+   */
+  inline void flush() noexcept;
+
+ private:
+  // Takes up to half a magazine from the parent, returns number taken
+  inline size_type refill() noexcept;
+
+  // Returns the n least-recently cached indexes to the parent
+  inline void drain(size_type n) noexcept;
+
+  FreeListType& parent;
+  size_type count{0};
+  index_type magazine[MagazineSize];
+};
+
+template <typename FreeListType, std::size_t MagazineSize>
+template <typename... Args>
+typename ThreadCache<FreeListType, MagazineSize>::value_type*
+ThreadCache<FreeListType, MagazineSize>::alloc(Args&&... args) {
+  index_type index = push_index();
+  if (!index) {
+    throw std::bad_alloc();
+  }
+
+  // placement-new the item
+  return detail::construct<value_type>(
+      parent.get(index), [this, index]() { pop_index(index); },
+      std::forward<Args>(args)...);
+}
+
+template <typename FreeListType, std::size_t MagazineSize>
+void ThreadCache<FreeListType, MagazineSize>::free(value_type* item) noexcept {
+  assert(item);
+
+  // placement-delete the item
+  item->~value_type();
+  pop_index(parent.index(item));
+}
+
+template <typename FreeListType, std::size_t MagazineSize>
+typename ThreadCache<FreeListType, MagazineSize>::index_type
+ThreadCache<FreeListType, MagazineSize>::push_index() noexcept {
+  if (count == 0 && refill() == 0) {
+    return 0;
+  }
+  const index_type index = magazine[--count];
+  parent.revive_index(index);
+  return index;
+}
+
+template <typename FreeListType, std::size_t MagazineSize>
+void ThreadCache<FreeListType, MagazineSize>::pop_index(
+    const index_type index) noexcept {
+  // Invalidate handles now, the parent only sees the index once drained
+  parent.retire_index(index);
+  if (count == MagazineSize) {
+    drain(MagazineSize / 2);
+  }
+  magazine[count++] = index;
+}
+
+template <typename FreeListType, std::size_t MagazineSize>
+void ThreadCache<FreeListType, MagazineSize>::flush() noexcept {
+  drain(count);
+}
+
+template <typename FreeListType, std::size_t MagazineSize>
+typename ThreadCache<FreeListType, MagazineSize>::size_type
+ThreadCache<FreeListType, MagazineSize>::refill() noexcept {
+  if (count < MagazineSize / 2) {
+    const size_type got =
+        parent.push_indices(magazine + count, MagazineSize / 2 - count);
+    // Nothing is constructed in them until they are allocated
+    for (size_type i = count; i < count + got; ++i) {
+      parent.retire_index(magazine[i]);
+    }
+    count += got;
+  }
+  return count;
+}
+
+template <typename FreeListType, std::size_t MagazineSize>
+void ThreadCache<FreeListType, MagazineSize>::drain(size_type n) noexcept {
+  assert(n <= count);
+  parent.pop_indices(magazine, n);
+  // Keep the most recently freed (and most likely cached) indexes
+  for (size_type i = n; i < count; ++i) {
+    magazine[i - n] = magazine[i];
+  }
+  count -= n;
+}
+
+}  // namespace freelist
+
+#endif  // INCLUDE_FREELIST_THREAD_CACHE_H_
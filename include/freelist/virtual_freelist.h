@@ -0,0 +1,396 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INCLUDE_FREELIST_VIRTUAL_FREELIST_H_
+#define INCLUDE_FREELIST_VIRTUAL_FREELIST_H_
+
+#include <freelist/freelist_view.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace freelist {
+
+/**
+ * FreeList in a reserved range of virtual memory, which is only committed as
+ * elements are first used, and can be decommitted again once they are free.
+ *
+ * The constructor reserves the whole address range without committing it.
+ * Pages are committed in blocks of kCommitBytes as the never-used elements
+ * are taken, so a large, mostly unused VirtualMemoryFreeList costs little
+ * memory. trim() returns free elements at the end of the used range to the
+ * never-used elements, and decommits the pages they occupied with
+ * MADV_DONTNEED, so the resident size falls again after a burst. Free
+ * elements below the highest active item hold the free list, so their pages
+ * stay committed.
+ *
+ * alloc() and free() may be called concurrently, as for FreeList; clear()
+ * and trim() must not be called concurrently with anything else.
+ *
+ * @tparam T Data type to store.
+ * @tparam Options Compile-time options, see FreeListOptions.
+ */
+template <typename T, typename Options = FreeListOptions>
+class VirtualMemoryFreeList {
+ public:
+  using view_type = FreeListView<T, Options>;
+  using value_type = T;
+  using index_type = typename view_type::index_type;
+  using size_type = typename view_type::size_type;
+
+  /**
+   * Minimum number of bytes committed at a time, rounded up to the page size.
+   */
+  static constexpr size_type kCommitBytes = 1 << 16;
+
+  /**
+   * Reserve address space, and construct an empty FreeList in it.
+   * @param size Size of the reserved range in bytes, rounded up to the page
+   * size.
+   * @exception std::system_error If the range cannot be reserved or committed.
+   * @exception std::invalid_argument If size is too small for one item.
+   */
+  inline explicit VirtualMemoryFreeList(size_type size);
+
+  inline VirtualMemoryFreeList(VirtualMemoryFreeList&& other) noexcept
+      : bytes(other.bytes),
+        granularity(other.granularity),
+        mapping(other.mapping),
+        freeList(other.freeList) {
+    committed.store(other.committed.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+    other.mapping = nullptr;
+  }
+
+  VirtualMemoryFreeList(VirtualMemoryFreeList const&) = delete;
+  VirtualMemoryFreeList& operator=(VirtualMemoryFreeList const&) = delete;
+
+  /**
+   * Destructor, calls delete on all existing items and releases the range.
+   */
+  inline ~VirtualMemoryFreeList() {
+    if (mapping) {
+      freeList.clear();
+      munmap(mapping, bytes);
+    }
+  }
+
+  /**
+   * Check if the FreeList is empty.
+   * @return True if the FreeList contains no items.
+   */
+  inline bool empty() const noexcept { return freeList.empty(); }
+
+  /**
+   * Check if the FreeList is full.
+   * @return True if the FreeList is full.
+   */
+  inline bool full() const noexcept { return freeList.full(); }
+
+  /**
+   * Check the number of active items in the FreeList.
+   * @return Number of active items in the FreeList.
+   */
+  inline index_type size() const noexcept { return freeList.size(); }
+
+  /**
+   * Get the maximum number of items that can be stored.
+   * @return Maximum number of stored items.
+   */
+  inline index_type max_size() const noexcept { return freeList.max_size(); }
+
+  /**
+   * Synonym for max_size()
+   */
+  inline index_type capacity() const noexcept { return max_size(); }
+
+  /**
+   * Get the size of the reserved range.
+   * @return Reserved bytes.
+   */
+  inline size_type reserved_bytes() const noexcept { return bytes; }
+
+  /**
+   * Get the size of the committed start of the range, which includes the
+   * control words and every used element.
+   * @return Committed bytes.
+   */
+  inline size_type committed_bytes() const noexcept {
+    return committed.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Get the start of the reserved range.
+   * @return Address of the range.
+   */
+  inline void* data() const noexcept { return mapping; }
+
+  /**
+   * Removes all items from the list, calling destructor for each, and
+   * decommits all elements.
+   */
+  inline void clear() noexcept {
+    freeList.clear();
+    trim();
+  }
+
+  /**
+   * Returns the free elements above the highest active item to the
+   * never-used elements, and decommits the pages holding only those
+   * elements.
+   * @return Number of bytes decommitted.
+   */
+  inline size_type trim() noexcept;
+
+  /**
+   * Allocates a new item in the FreeList, and calls constructor.
+   * @see FreeList::alloc
+   * @exception std::bad_alloc If the FreeList is full, or memory for the item
+   * cannot be committed.
+   */
+  template <typename... Args>
+  inline T* alloc(Args&&... args);
+
+  /**
+   * Constructs a new item in the FreeList, without throwing if the freelist is
+   * full.
+   * @see FreeList::emplace
+   */
+  template <typename... Args>
+  inline index_type emplace(Args&&... args) noexcept(
+      std::is_nothrow_constructible<T, Args&&...>::value);
+
+  /**
+   * Deletes an item from the FreeList, and calls destructor.
+   * @param item Pointer to item to delete.
+   */
+  inline void free(T* item) noexcept { freeList.free(item); }
+
+  /**
+   * Creates new item in the FreeList, does not call constructor.
+   * @return Index of new item, or 0 if full or memory for the item cannot be
+   * committed.
+   */
+  inline index_type push_index() noexcept;
+
+  /**
+   * Removes item at specified index, does not call destructor.
+   * @param index Index of item to remove.
+   */
+  inline void pop_index(index_type index) noexcept {
+    freeList.pop_index(index);
+  }
+
+  /**
+   * Get the index of the specified item.
+   * @param item Pointer of item to find.
+   * @return Index of the specified item.
+   */
+  inline index_type index(T const* item) const { return freeList.index(item); }
+
+  /**
+   * Convert an index into a pointer to the corresponding item.
+   * @param index Index of item to retrieve.
+   * @return Pointer to item.
+   */
+  inline T* get(index_type index) const { return freeList.get(index); }
+
+  /**
+   * Get a range of the active items, in address order.
+   * @see FreeList::live
+   */
+  inline typename view_type::LiveRange live() const noexcept {
+    return freeList.live();
+  }
+
+  /**
+   * Call f(item) for each active item, in address order.
+   * @see FreeList::live
+   */
+  template <typename F>
+  inline void for_each_live(F&& f) const {
+    freeList.for_each_live(std::forward<F>(f));
+  }
+
+ private:
+  using Element = detail::FreeListElement<T, index_type>;
+
+  // Reserves the range, committing its first bytes, which hold the control
+  // words
+  inline static void* reserve(size_type bytes, size_type first);
+
+  inline static size_type round_to_pages(size_type n) noexcept {
+    const size_type page = static_cast<size_type>(sysconf(_SC_PAGESIZE));
+    return (n + page - 1) / page * page;
+  }
+
+  // Makes [from, to) of the range accessible
+  inline static bool commit_range(void* mapping, size_type from,
+                                  size_type to) noexcept {
+    return mprotect(static_cast<char*>(mapping) + from, to - from,
+                    PROT_READ | PROT_WRITE) == 0;
+  }
+
+  // Commits the pages holding element index, if they are not already
+  inline bool commit(index_type index) noexcept;
+
+  // Rounds n up to a multiple of granularity, at most bytes
+  inline size_type round_up(size_type n) const noexcept {
+    n = (n + granularity - 1) / granularity * granularity;
+    return n < bytes ? n : bytes;
+  }
+
+  inline static std::system_error error(char const* what) {
+    return std::system_error(errno, std::generic_category(), what);
+  }
+
+  // Size of the reserved range, a multiple of the page size
+  size_type bytes;
+  // kCommitBytes rounded up to the page size
+  size_type granularity;
+  void* mapping;
+  view_type freeList;
+  // Bytes committed at the start of the range; only raised after committing
+  detail::atomic_t<size_type, Options::kThreadSafe> committed;
+};
+
+template <typename T, typename Options>
+constexpr typename VirtualMemoryFreeList<T, Options>::size_type
+    VirtualMemoryFreeList<T, Options>::kCommitBytes;
+
+template <typename T, typename Options>
+VirtualMemoryFreeList<T, Options>::VirtualMemoryFreeList(const size_type size)
+    : bytes(round_to_pages(size)),
+      granularity(round_to_pages(kCommitBytes)),
+      mapping(reserve(bytes, round_up(granularity))),
+      // The range is page-aligned and large enough, so this cannot throw
+      freeList(mapping, bytes) {
+  committed.store(round_up(granularity), std::memory_order_relaxed);
+}
+
+template <typename T, typename Options>
+void* VirtualMemoryFreeList<T, Options>::reserve(const size_type bytes,
+                                                 const size_type first) {
+  if (!view_type::capacity_for(bytes)) {
+    throw std::invalid_argument("VirtualMemoryFreeList size is too small");
+  }
+
+  // Reserve the range without committing it
+  void* mapping = mmap(nullptr, bytes, PROT_NONE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (mapping == MAP_FAILED) throw error("mmap");
+
+  if (!commit_range(mapping, 0, first)) {
+    std::system_error e = error("mprotect");
+    munmap(mapping, bytes);
+    throw e;
+  }
+  return mapping;
+}
+
+template <typename T, typename Options>
+bool VirtualMemoryFreeList<T, Options>::commit(const index_type index) noexcept {
+  const size_type needed = (size_type(index) + 1) * sizeof(Element);
+  // Acquire, so that the pages are accessible once committed covers them
+  size_type curr = committed.load(std::memory_order_acquire);
+  if (needed <= curr) return true;
+
+  // Concurrent callers may commit overlapping ranges, which is harmless
+  const size_type target = round_up(needed);
+  if (!commit_range(mapping, curr, target)) return false;
+  while (curr < target &&
+         !committed.compare_exchange_weak(curr, target,
+                                          std::memory_order_release,
+                                          std::memory_order_acquire)) {
+  }
+  return true;
+}
+
+template <typename T, typename Options>
+typename VirtualMemoryFreeList<T, Options>::size_type
+VirtualMemoryFreeList<T, Options>::trim() noexcept {
+  const size_type used = freeList.trim_fresh();
+  const size_type keep = round_up(used * sizeof(Element));
+  const size_type curr = committed.load(std::memory_order_relaxed);
+  if (keep >= curr) return 0;
+
+  // Drop the pages, then make them inaccessible so they are no longer
+  // charged as committed memory
+  char* start = static_cast<char*>(mapping) + keep;
+  madvise(start, curr - keep, MADV_DONTNEED);
+  mprotect(start, curr - keep, PROT_NONE);
+  committed.store(keep, std::memory_order_relaxed);
+  return curr - keep;
+}
+
+template <typename T, typename Options>
+typename VirtualMemoryFreeList<T, Options>::index_type
+VirtualMemoryFreeList<T, Options>::push_index() noexcept {
+  const index_type index = freeList.push_index();
+  if (index && !commit(index)) {
+    freeList.pop_index(index);
+    return 0;
+  }
+  return index;
+}
+
+template <typename T, typename Options>
+template <typename... Args>
+T* VirtualMemoryFreeList<T, Options>::alloc(Args&&... args) {
+  index_type index = push_index();
+  if (!index) {
+    throw std::bad_alloc();
+  }
+
+  // placement-new the item
+  return detail::construct<T>(
+      get(index), [this, index]() { pop_index(index); },
+      std::forward<Args>(args)...);
+}
+
+template <typename T, typename Options>
+template <typename... Args>
+typename VirtualMemoryFreeList<T, Options>::index_type
+VirtualMemoryFreeList<T, Options>::emplace(Args&&... args) noexcept(
+    std::is_nothrow_constructible<T, Args&&...>::value) {
+  index_type index = push_index();
+  if (index) {
+    // placement-new the item
+    detail::construct<T>(
+        get(index), [this, index]() { pop_index(index); },
+        std::forward<Args>(args)...);
+  }
+  return index;
+}
+
+}  // namespace freelist
+
+#endif  // INCLUDE_FREELIST_VIRTUAL_FREELIST_H_
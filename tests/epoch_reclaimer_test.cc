@@ -0,0 +1,213 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <freelist/epoch_reclaimer.h>
+#include <freelist/freelist.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Node whose fields are consistent until it is destroyed
+struct Node {
+  explicit Node(uint64_t value) : value(value), check(~value) {
+    ++constructed;
+  }
+  ~Node() {
+    value = 0;
+    check = 0;
+    ++destroyed;
+  }
+  bool valid() const { return check == ~value; }
+
+  uint64_t value;
+  uint64_t check;
+
+  static std::atomic<int> constructed;
+  static std::atomic<int> destroyed;
+};
+
+std::atomic<int> Node::constructed{0};
+std::atomic<int> Node::destroyed{0};
+
+using FreeListType = freelist::FreeList<Node, 1 << 20>;
+using ReclaimerType = freelist::EpochReclaimer<FreeListType, 16, 8>;
+
+}  // namespace
+
+class EpochReclaimerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Node::constructed = 0;
+    Node::destroyed = 0;
+  }
+
+  FreeListType fl;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_F(EpochReclaimerTest, retire_waits_for_reader) {
+  ReclaimerType reclaimer(fl);
+  ReclaimerType::Participant writer(reclaimer);
+  ReclaimerType::Participant reader(reclaimer);
+
+  Node* node = fl.alloc(1);
+  {
+    ReclaimerType::Guard guard(reader);
+    EXPECT_TRUE(reader.active());
+    writer.retire(node);
+    EXPECT_EQ(1, writer.size());
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_EQ(0, writer.reclaim());
+    }
+    // The reader can still use the node
+    EXPECT_TRUE(node->valid());
+    EXPECT_EQ(1u, node->value);
+    EXPECT_EQ(0, Node::destroyed);
+    EXPECT_EQ(1, fl.size());
+  }
+  EXPECT_FALSE(reader.active());
+
+  size_t reclaimed = 0;
+  for (int i = 0; i < 3; ++i) {
+    reclaimed += writer.reclaim();
+  }
+  EXPECT_EQ(1u, reclaimed);
+  EXPECT_EQ(0, writer.size());
+  EXPECT_EQ(1, Node::destroyed);
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(EpochReclaimerTest, nested_guards) {
+  ReclaimerType reclaimer(fl);
+  ReclaimerType::Participant writer(reclaimer);
+  ReclaimerType::Participant reader(reclaimer);
+
+  writer.retire(fl.alloc(1));
+  {
+    ReclaimerType::Guard outer(reader);
+    {
+      ReclaimerType::Guard inner(reader);
+    }
+    EXPECT_TRUE(reader.active());
+    for (int i = 0; i < 10; ++i) {
+      writer.reclaim();
+    }
+    EXPECT_EQ(1, writer.size());
+  }
+  writer.flush();
+  EXPECT_EQ(0, writer.size());
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(EpochReclaimerTest, batches_reclaim_without_readers) {
+  ReclaimerType reclaimer(fl);
+  ReclaimerType::Participant writer(reclaimer);
+  const uint64_t epoch = reclaimer.epoch();
+  for (int i = 0; i < 1000; ++i) {
+    writer.retire(fl.alloc(i));
+  }
+  // Full batches advance the epoch and are reclaimed in bulk
+  EXPECT_LT(epoch, reclaimer.epoch());
+  EXPECT_GE(3 * 8, writer.size());
+  EXPECT_EQ(writer.size(), fl.size());
+}
+
+TEST_F(EpochReclaimerTest, destructor_flushes) {
+  ReclaimerType reclaimer(fl);
+  {
+    ReclaimerType::Participant writer(reclaimer);
+    for (int i = 0; i < 5; ++i) {
+      writer.retire(fl.alloc(i));
+    }
+    EXPECT_EQ(5, writer.size());
+  }
+  EXPECT_EQ(5, Node::destroyed);
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(EpochReclaimerTest, too_many_participants) {
+  using SmallType = freelist::EpochReclaimer<FreeListType, 2>;
+  SmallType reclaimer(fl);
+  SmallType::Participant a(reclaimer);
+  {
+    SmallType::Participant b(reclaimer);
+    EXPECT_THROW(SmallType::Participant c(reclaimer), std::bad_alloc);
+  }
+  // The slot of a destroyed Participant is reused
+  SmallType::Participant d(reclaimer);
+}
+
+TEST_F(EpochReclaimerTest, threads) {
+  ReclaimerType reclaimer(fl);
+  std::atomic<Node*> shared{fl.alloc(0)};
+  std::atomic<bool> done{false};
+  const int kWriters = 2;
+  const int kReaders = 4;
+  const int kUpdates = 50000;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kWriters; ++t) {
+    threads.emplace_back([&, t]() {
+      ReclaimerType::Participant participant(reclaimer);
+      for (int i = 0; i < kUpdates; ++i) {
+        // A descheduled reader can hold back reclamation until the FreeList
+        // is full, so reclaim until there is room
+        FreeListType::index_type index;
+        while (!(index = fl.emplace(t * kUpdates + i))) {
+          participant.reclaim();
+          std::this_thread::yield();
+        }
+        participant.retire(shared.exchange(fl.get(index)));
+      }
+    });
+  }
+  for (int t = 0; t < kReaders; ++t) {
+    threads.emplace_back([&]() {
+      ReclaimerType::Participant participant(reclaimer);
+      while (!done) {
+        ReclaimerType::Guard guard(participant);
+        Node const* node = shared.load(std::memory_order_acquire);
+        const uint64_t value = node->value;
+        std::this_thread::yield();
+        // Still not destroyed or reused
+        EXPECT_TRUE(node->valid());
+        EXPECT_EQ(value, node->value);
+      }
+    });
+  }
+  for (int t = 0; t < kWriters; ++t) threads[t].join();
+  done = true;
+  for (int t = kWriters; t < kWriters + kReaders; ++t) threads[t].join();
+
+  EXPECT_EQ(1, fl.size());
+  EXPECT_EQ(kWriters * kUpdates, Node::destroyed);
+  fl.free(shared.load());
+}
@@ -0,0 +1,209 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <freelist/freelist.h>
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using FreeListType = freelist::FreeList<uint64_t, 65536>;
+using Allocator = FreeListType::Allocator;
+
+class FreeListAllocatorTest : public ::testing::Test {
+ protected:
+  FreeListType fl;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_F(FreeListAllocatorTest, traits) {
+  using Traits = std::allocator_traits<Allocator>;
+  static_assert(Traits::propagate_on_container_copy_assignment::value, "");
+  static_assert(Traits::propagate_on_container_move_assignment::value, "");
+  static_assert(Traits::propagate_on_container_swap::value, "");
+  static_assert(
+      std::is_same<Traits::rebind_alloc<std::string>,
+                   freelist::FreeListAllocator<std::string, 65536>>::value,
+      "");
+}
+
+TEST_F(FreeListAllocatorTest, equality) {
+  Allocator a = fl.allocator();
+  Allocator b = a;
+  EXPECT_TRUE(a == b);
+  EXPECT_FALSE(a != b);
+
+  // All allocators from the same FreeList share its state
+  Allocator c = fl.allocator();
+  EXPECT_TRUE(a == c);
+  FreeListType other;
+  EXPECT_FALSE(a == other.allocator());
+
+  // FreeLists too small to keep the state give each allocator its own
+  freelist::FreeList<uint64_t, 64> small;
+  EXPECT_FALSE(small.allocator() == small.allocator());
+
+  // Rebinding and converting back compares equal
+  freelist::FreeListAllocator<std::string, 65536> rebound(a);
+  EXPECT_TRUE(rebound == a);
+  EXPECT_TRUE(Allocator(rebound) == a);
+}
+
+TEST_F(FreeListAllocatorTest, single_objects_from_parent) {
+  Allocator a = fl.allocator();
+  uint64_t* p = a.allocate(1);
+  EXPECT_EQ(1, fl.size());
+  EXPECT_EQ(p, fl.get(fl.index(p)));
+  a.deallocate(p, 1);
+  EXPECT_TRUE(fl.empty());
+
+  // Arrays are not taken from the FreeList
+  uint64_t* array = a.allocate(10);
+  EXPECT_TRUE(fl.empty());
+  a.deallocate(array, 10);
+}
+
+TEST_F(FreeListAllocatorTest, full) {
+  Allocator a = fl.allocator();
+  std::vector<uint64_t*> items;
+  for (size_t i = 0; i < fl.capacity(); ++i) {
+    items.push_back(a.allocate(1));
+  }
+  EXPECT_THROW(a.allocate(1), std::bad_alloc);
+  for (uint64_t* p : items) {
+    a.deallocate(p, 1);
+  }
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(FreeListAllocatorTest, vector_falls_back_to_operator_new) {
+  std::vector<uint64_t, Allocator> vector(fl.allocator());
+  for (uint64_t i = 0; i < 1000; ++i) {
+    vector.push_back(i);
+  }
+  // Storage for more than one element comes from operator new, outside the
+  // FreeList
+  EXPECT_TRUE(fl.empty());
+  uintptr_t data = reinterpret_cast<uintptr_t>(vector.data());
+  uintptr_t begin = reinterpret_cast<uintptr_t>(&fl);
+  EXPECT_TRUE(data < begin || data >= begin + sizeof(fl));
+  EXPECT_EQ(999, vector.back());
+}
+
+TEST_F(FreeListAllocatorTest, list) {
+  std::list<uint64_t, Allocator> list(fl.allocator());
+  for (uint64_t i = 0; i < 1000; ++i) {
+    list.push_back(i);
+  }
+  // Nodes are larger than uint64_t, so come from a sibling FreeList
+  EXPECT_TRUE(fl.empty());
+
+  uint64_t expected = 0;
+  for (uint64_t v : list) {
+    EXPECT_EQ(expected++, v);
+  }
+  list.remove_if([](uint64_t v) { return v % 2 == 0; });
+  EXPECT_EQ(500, list.size());
+}
+
+TEST_F(FreeListAllocatorTest, map) {
+  using MapAllocator =
+      freelist::FreeListAllocator<std::pair<const int, std::string>, 65536>;
+  std::map<int, std::string, std::less<int>, MapAllocator> map{
+      MapAllocator(fl.allocator())};
+  for (int i = 0; i < 500; ++i) {
+    map[i] = std::to_string(i);
+  }
+  for (int i = 0; i < 500; i += 3) {
+    map.erase(i);
+  }
+  EXPECT_EQ("499", map.at(499));
+  EXPECT_EQ(0, map.count(3));
+
+  // Copies share the allocator, and its sibling FreeLists
+  auto copy = map;
+  EXPECT_TRUE(copy.get_allocator() == map.get_allocator());
+  EXPECT_EQ(map, copy);
+  map.clear();
+  EXPECT_EQ("1", copy.at(1));
+}
+
+TEST_F(FreeListAllocatorTest, unordered_map) {
+  using MapAllocator =
+      freelist::FreeListAllocator<std::pair<const uint64_t, uint64_t>, 65536>;
+  std::unordered_map<uint64_t, uint64_t, std::hash<uint64_t>,
+                     std::equal_to<uint64_t>, MapAllocator>
+      map(16, std::hash<uint64_t>(), std::equal_to<uint64_t>(),
+          MapAllocator(fl.allocator()));
+  for (uint64_t i = 0; i < 1000; ++i) {
+    map.emplace(i, i * i);
+  }
+  for (uint64_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(i * i, map.at(i));
+  }
+
+  // Swapping propagates the allocator
+  std::unordered_map<uint64_t, uint64_t, std::hash<uint64_t>,
+                     std::equal_to<uint64_t>, MapAllocator>
+      other(16, std::hash<uint64_t>(), std::equal_to<uint64_t>(),
+            MapAllocator(fl.allocator()));
+  other.emplace(1, 2);
+  map.swap(other);
+  EXPECT_EQ(1, map.size());
+  EXPECT_EQ(1000, other.size());
+}
+
+TEST_F(FreeListAllocatorTest, splice_between_containers) {
+  std::list<uint64_t, Allocator> first(fl.allocator());
+  std::list<uint64_t, Allocator> second(fl.allocator());
+  for (uint64_t i = 0; i < 10; ++i) {
+    first.push_back(i);
+  }
+  // The nodes come from the same sibling FreeList, so they can move
+  second.splice(second.end(), first);
+  EXPECT_TRUE(first.empty());
+  EXPECT_EQ(10u, second.size());
+  first.swap(second);
+  EXPECT_EQ(10u, first.size());
+  first.clear();
+}
+
+TEST_F(FreeListAllocatorTest, siblings_outlive_original) {
+  std::list<uint64_t, Allocator> list(fl.allocator());
+  {
+    Allocator a = fl.allocator();
+    std::list<uint64_t, Allocator> temporary(a);
+    temporary.push_back(1);
+    list = std::move(temporary);
+  }
+  EXPECT_EQ(1, list.front());
+}
@@ -26,6 +26,9 @@
 #include <freelist/freelist.h>
 
 #include <map>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -112,6 +115,27 @@ TEST_F(FreeListDestructorTest, early_clear) {
   fl.clear();
 }
 
+TEST_F(FreeListDestructorTest, clear_scattered) {
+  using FreeListType = freelist::FreeList<InstanceCounter, 16384>;
+  std::unique_ptr<FreeListType> fl(new FreeListType());
+  std::vector<InstanceCounter*> items;
+  for (size_t i = 0; i < fl->capacity(); ++i) {
+    items.push_back(fl->push());
+  }
+
+  // Free about two thirds of the items, in a scattered order
+  for (size_t i = 0; i < items.size(); ++i) {
+    size_t j = (i * 7919) % items.size();
+    if (j % 3 != 0) fl->pop(items[j]);
+  }
+  fl->clear();
+  EXPECT_TRUE(fl->empty());
+
+  // The FreeList is usable after clear()
+  auto p = fl->push();
+  fl->pop(p);
+}
+
 TEST_F(FreeListDestructorTest, make_unique) {
   freelist::FreeList<InstanceCounter, 100> fl;
   {
@@ -137,3 +161,36 @@ TEST_F(FreeListDestructorTest, make_shared) {
     auto p6 = fl.make_shared();
   }
 }
+
+TEST_F(FreeListDestructorTest, alloc_n_and_free_n) {
+  freelist::FreeList<InstanceCounter, 1000> fl;
+  InstanceCounter* items[200];
+  fl.alloc_n(items, 200);
+  fl.free_n(items, 100);
+  fl.alloc_n(items, 50);
+  fl.free_n(items + 10, 20);
+}
+
+namespace {
+
+struct ThrowOnThird {
+  static int constructed;
+  static int destructed;
+  ThrowOnThird() {
+    if (++constructed == 3) throw std::runtime_error("third");
+  }
+  ~ThrowOnThird() { ++destructed; }
+};
+int ThrowOnThird::constructed = 0;
+int ThrowOnThird::destructed = 0;
+
+}  // namespace
+
+TEST_F(FreeListDestructorTest, alloc_n_throwing_constructor) {
+  freelist::FreeList<ThrowOnThird, 1000> fl;
+  ThrowOnThird* items[10];
+  EXPECT_THROW(fl.alloc_n(items, 10), std::runtime_error);
+  EXPECT_EQ(3, ThrowOnThird::constructed);
+  EXPECT_EQ(2, ThrowOnThird::destructed);
+  EXPECT_TRUE(fl.empty());
+}
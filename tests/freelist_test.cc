@@ -27,6 +27,8 @@
 
 #include <algorithm>
 #include <map>
+#include <memory>
+#include <utility>
 
 #include <gtest/gtest.h>
 
@@ -39,16 +41,81 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Set up test fixture for typed tests
 
-template <typename _T, uint64_t Size>
+template <typename _T, uint64_t Size,
+          typename _Options = freelist::FreeListOptions>
 struct FreeListType {
   using T = _T;
+  using Options = _Options;
   static constexpr uint64_t size = Size;
 };
 
+struct CacheLineAlignedOptions : freelist::FreeListOptions {
+  static constexpr bool kCacheLineAligned = true;
+};
+
+struct OccupancyBitmapOptions : freelist::FreeListOptions {
+  static constexpr bool kOccupancyBitmap = true;
+};
+
+struct SingleThreadedOccupancyBitmapOptions : freelist::SingleThreaded {
+  static constexpr bool kOccupancyBitmap = true;
+};
+
+struct AddressOrderedOptions : OccupancyBitmapOptions {
+  static constexpr bool kAddressOrdered = true;
+};
+
+struct SingleThreadedAddressOrderedOptions
+    : SingleThreadedOccupancyBitmapOptions {
+  static constexpr bool kAddressOrdered = true;
+};
+
+struct GenerationsOptions : freelist::FreeListOptions {
+  static constexpr bool kGenerations = true;
+};
+
+struct AddressOrderedGenerationsOptions : AddressOrderedOptions {
+  static constexpr bool kGenerations = true;
+};
+
+struct StatsOptions : freelist::FreeListOptions {
+  static constexpr bool kStats = true;
+};
+
+struct SingleThreadedStatsOptions : freelist::SingleThreaded {
+  static constexpr bool kStats = true;
+};
+
+struct EliminationOptions : freelist::FreeListOptions {
+  static constexpr std::size_t kEliminationSlots = 4;
+};
+
+struct EliminationStatsOptions : StatsOptions {
+  static constexpr std::size_t kEliminationSlots = 2;
+};
+
+struct CompactIndexOptions : freelist::FreeListOptions {
+  using IndexType = uint16_t;
+};
+
+struct WideCountOptions : CompactIndexOptions {
+  using CountType = uint32_t;
+};
+
+struct Head32Options : freelist::FreeListOptions {
+  using IndexType = uint32_t;
+  using HeadType = uint32_t;
+};
+
+struct PrefetchOptions : freelist::FreeListOptions {
+  static constexpr bool kPrefetch = true;
+};
+
 template <typename _T>
 class FreeListTest : public ::testing::Test {
  protected:
-  using this_FreeList = freelist::FreeList<typename _T::T, _T::size>;
+  using this_FreeList =
+      freelist::FreeList<typename _T::T, _T::size, typename _T::Options>;
   using T = typename _T::T;
   static constexpr uint64_t Size = _T::size;
 
@@ -99,7 +166,57 @@ using FreeListTestTypes = ::testing::Types<
     // Test complex data structures
     FreeListType<std::string, sizeof(std::string) * 100>,
     FreeListType<complex_data, sizeof(complex_data) * 100>,
-    FreeListType<std::vector<int>, sizeof(std::vector<int>) * 100>>;
+    FreeListType<std::vector<int>, sizeof(std::vector<int>) * 100>,
+
+    // Test control words on their own cache line
+    FreeListType<int8_t, 128, CacheLineAlignedOptions>,
+    FreeListType<double, 4096, CacheLineAlignedOptions>,
+    FreeListType<AbnormalSize<7>, 131072, CacheLineAlignedOptions>,
+
+    // Test without atomic operations
+    FreeListType<int8_t, 8, freelist::SingleThreaded>,
+    FreeListType<double, 131088, freelist::SingleThreaded>,
+    FreeListType<std::string, sizeof(std::string) * 100,
+                 freelist::SingleThreaded>,
+
+    // Test with an occupancy bitmap
+    FreeListType<int8_t, 64, OccupancyBitmapOptions>,
+    FreeListType<double, 131088, OccupancyBitmapOptions>,
+    FreeListType<AbnormalSize<7>, 16000, OccupancyBitmapOptions>,
+    FreeListType<std::string, sizeof(std::string) * 100,
+                 SingleThreadedOccupancyBitmapOptions>,
+    FreeListType<double, 131088, SingleThreadedOccupancyBitmapOptions>,
+
+    // Test address-ordered allocation
+    FreeListType<int8_t, 64, AddressOrderedOptions>,
+    FreeListType<double, 131088, AddressOrderedOptions>,
+    FreeListType<std::string, sizeof(std::string) * 100,
+                 SingleThreadedAddressOrderedOptions>,
+
+    // Test with generation counters
+    FreeListType<int64_t, 256, GenerationsOptions>,
+    FreeListType<double, 131088, GenerationsOptions>,
+    FreeListType<std::string, sizeof(std::string) * 100,
+                 AddressOrderedGenerationsOptions>,
+
+    // Test with statistics
+    FreeListType<double, 131072, StatsOptions>,
+    FreeListType<std::string, sizeof(std::string) * 100,
+                 SingleThreadedStatsOptions>,
+
+    // Test with elimination slots
+    FreeListType<int8_t, 512, EliminationOptions>,
+    FreeListType<double, 131072, EliminationStatsOptions>,
+
+    // Test with narrower control words
+    FreeListType<double, 131072, CompactIndexOptions>,
+    FreeListType<double, 131072, WideCountOptions>,
+    FreeListType<int32_t, 65536, Head32Options>,
+
+    // Test with prefetching
+    FreeListType<int8_t, 64, PrefetchOptions>,
+    FreeListType<AbnormalSize<7>, 16000, PrefetchOptions>,
+    FreeListType<std::string, sizeof(std::string) * 100, PrefetchOptions>>;
 
 TYPED_TEST_CASE(FreeListTest, FreeListTestTypes);
 
@@ -170,6 +287,30 @@ TYPED_TEST(FreeListTest, alloc) {
   TestFixture::checkPointer(indexList.back());
 }
 
+TYPED_TEST(FreeListTest, alloc_prefetched) {
+  std::vector<typename TestFixture::T*> indexList;
+  std::vector<typename TestFixture::T> valueList;
+
+  // Free every other item, so that allocations come from the free list too
+  for (int i = 0; i < this->fl.capacity(); ++i) {
+    indexList.push_back(this->fl.alloc_prefetched());
+    TestFixture::checkPointer(indexList.back());
+  }
+  EXPECT_THROW(this->fl.alloc_prefetched(), std::bad_alloc);
+  for (size_t i = 0; i < indexList.size(); i += 2) {
+    this->fl.free(indexList[i]);
+  }
+  for (size_t i = 0; i < indexList.size(); i += 2) {
+    valueList.push_back(this->value_store.next());
+    indexList[i] = this->fl.alloc_prefetched(valueList.back());
+    TestFixture::checkPointer(indexList[i]);
+  }
+  EXPECT_TRUE(this->fl.full());
+  for (size_t i = 0; i < indexList.size(); i += 2) {
+    EXPECT_EQ(valueList[i / 2], *indexList[i]);
+  }
+}
+
 TYPED_TEST(FreeListTest, data_integrity) {
   std::vector<typename TestFixture::T*> indexList;
   std::vector<typename TestFixture::T> valueList;
@@ -251,6 +392,19 @@ TYPED_TEST(FreeListTest, make_unique) {
   TestFixture::checkPointer(indexList.back().get());
 }
 
+TYPED_TEST(FreeListTest, deleter) {
+  using FreeList = typename TestFixture::this_FreeList;
+  static_assert(sizeof(typename FreeList::UniquePtr) == 2 * sizeof(void*),
+                "UniquePtr must hold only the item and FreeList pointers");
+
+  typename FreeList::UniquePtr empty;
+  EXPECT_FALSE(empty);
+
+  auto deleter = this->fl.deleter();
+  deleter(this->fl.alloc());
+  EXPECT_TRUE(this->fl.empty());
+}
+
 TYPED_TEST(FreeListTest, make_shared) {
   std::vector<std::shared_ptr<typename TestFixture::T>> indexList;
 
@@ -282,3 +436,552 @@ TYPED_TEST(FreeListTest, vector_allocator) {
   vec.shrink_to_fit();
   EXPECT_EQ(0, this->fl.size());
 }
+
+TYPED_TEST(FreeListTest, push_and_pop_indices) {
+  using index_type = typename TestFixture::this_FreeList::index_type;
+  std::vector<index_type> indices(this->fl.capacity() + 1);
+
+  // Request more than the capacity, only the capacity is returned
+  EXPECT_EQ(this->fl.capacity(),
+            this->fl.push_indices(indices.data(), indices.size()));
+  EXPECT_TRUE(this->fl.full());
+  EXPECT_EQ(0, this->fl.push_indices(indices.data(), 1));
+
+  std::sort(indices.begin(), indices.end() - 1);
+  EXPECT_TRUE(std::adjacent_find(indices.begin(), indices.end() - 1) ==
+              indices.end() - 1);
+  for (size_t i = 0; i < this->fl.capacity(); ++i) {
+    TestFixture::checkPointer(this->fl.get(indices[i]));
+  }
+
+  // Return half, then take them again from the free chain
+  const size_t half = this->fl.capacity() / 2;
+  this->fl.pop_indices(indices.data(), half);
+  EXPECT_EQ(this->fl.capacity() - half, this->fl.size());
+
+  std::vector<index_type> reused(half + 1);
+  EXPECT_EQ(half, this->fl.push_indices(reused.data(), reused.size()));
+  std::sort(reused.begin(), reused.end() - 1);
+  EXPECT_TRUE(std::equal(reused.begin(), reused.end() - 1, indices.begin()));
+
+  this->fl.pop_indices(indices.data(), this->fl.capacity());
+  EXPECT_TRUE(this->fl.empty());
+}
+
+TYPED_TEST(FreeListTest, alloc_n_and_free_n) {
+  const size_t numItems = this->fl.capacity();
+  std::vector<typename TestFixture::T*> items(numItems);
+  const typename TestFixture::T value = this->value_store.next();
+
+  this->fl.alloc_n(items.data(), numItems, value);
+  EXPECT_TRUE(this->fl.full());
+  for (auto item : items) {
+    TestFixture::checkPointer(item);
+    EXPECT_EQ(value, *item);
+  }
+
+  // A failed alloc_n leaves the freelist unchanged
+  this->fl.free_n(items.data(), numItems / 2);
+  EXPECT_THROW(this->fl.alloc_n(items.data(), numItems / 2 + 1),
+               std::bad_alloc);
+  EXPECT_EQ(numItems - numItems / 2, this->fl.size());
+
+  this->fl.alloc_n(items.data(), numItems / 2);
+  EXPECT_TRUE(this->fl.full());
+  this->fl.free_n(items.data(), numItems);
+  EXPECT_TRUE(this->fl.empty());
+}
+
+TYPED_TEST(FreeListTest, reserve_fresh) {
+  using index_type = typename TestFixture::this_FreeList::index_type;
+  const size_t half = this->fl.capacity() / 2;
+  if (!half) return;
+
+  EXPECT_EQ(0, this->fl.reserve_fresh(this->fl.capacity() + 1));
+  EXPECT_TRUE(this->fl.empty());
+
+  const index_type first = this->fl.reserve_fresh(half);
+  EXPECT_NE(0, first);
+  EXPECT_EQ(half, this->fl.size());
+  for (size_t i = 0; i < half; ++i) {
+    TestFixture::checkPointer(this->fl.get(first + i));
+  }
+
+  // Only never-used elements are reserved, freed elements are not re-used
+  this->fl.pop_index(first);
+  EXPECT_EQ(0, this->fl.reserve_fresh(this->fl.capacity() - half + 1));
+  const index_type second = this->fl.reserve_fresh(this->fl.capacity() - half);
+  EXPECT_EQ(first + half, second);
+  EXPECT_FALSE(this->fl.full());
+
+  EXPECT_EQ(first, this->fl.push_index());
+  EXPECT_TRUE(this->fl.full());
+  EXPECT_EQ(0, this->fl.push_index());
+
+  // Items were not constructed, so must be removed before destruction
+  for (size_t i = 0; i < this->fl.capacity(); ++i) {
+    this->fl.pop_index(first + i);
+  }
+  EXPECT_TRUE(this->fl.empty());
+}
+
+TYPED_TEST(FreeListTest, emplace) {
+  using index_type = typename TestFixture::this_FreeList::index_type;
+  std::vector<index_type> indexList;
+
+  for (int i = 0; i < this->fl.capacity(); ++i) {
+    indexList.push_back(this->fl.emplace());
+    EXPECT_NE(0, indexList.back());
+    TestFixture::checkPointer(this->fl.get(indexList.back()));
+  }
+  EXPECT_TRUE(this->fl.full());
+  EXPECT_EQ(0, this->fl.emplace());
+
+  for (index_type index : indexList) {
+    this->fl.free(this->fl.get(index));
+  }
+  EXPECT_TRUE(this->fl.empty());
+}
+
+TYPED_TEST(FreeListTest, live) {
+  using T = typename TestFixture::T;
+  std::vector<T*> items;
+  for (int i = 0; i < this->fl.capacity(); ++i) {
+    items.push_back(this->fl.alloc());
+  }
+  EXPECT_EQ(this->fl.capacity(), std::distance(this->fl.live().begin(),
+                                               this->fl.live().end()));
+
+  // Free every third item, not in address order
+  std::vector<T*> expected;
+  for (size_t i = items.size(); i > 0; --i) {
+    if (i % 3 == 0) {
+      this->fl.free(items[i - 1]);
+    } else {
+      expected.push_back(items[i - 1]);
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+
+  std::vector<T*> visited;
+  for (T& item : this->fl.live()) {
+    visited.push_back(&item);
+  }
+  EXPECT_EQ(expected, visited);
+
+  visited.clear();
+  this->fl.for_each_live([&visited](T& item) { visited.push_back(&item); });
+  EXPECT_EQ(expected, visited);
+
+  // The sorted free list is still valid
+  for (size_t i = expected.size(); i < this->fl.capacity(); ++i) {
+    this->fl.alloc();
+  }
+  EXPECT_TRUE(this->fl.full());
+}
+
+TYPED_TEST(FreeListTest, cache_line_aligned) {
+  if (!TestFixture::this_FreeList::options_type::kCacheLineAligned) return;
+  const size_t lineSize =
+      TestFixture::this_FreeList::options_type::kCacheLineSize;
+
+  // No item is within the first cache line, which holds the control words
+  auto item = this->fl.alloc();
+  EXPECT_LE(reinterpret_cast<uint8_t const*>(&this->fl) + lineSize,
+            reinterpret_cast<uint8_t const*>(item));
+  this->fl.free(item);
+}
+
+TEST(FreeListAlignmentTest, cache_line_aligned) {
+  // Note: over-aligned objects on the heap require C++17 aligned new
+  freelist::FreeList<double, 4096, CacheLineAlignedOptions> fl;
+  EXPECT_EQ(4096, sizeof(fl));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(&fl) %
+                   CacheLineAlignedOptions::kCacheLineSize);
+  EXPECT_EQ(4096 / sizeof(double) - 8, fl.capacity());
+}
+
+namespace {
+
+// Counts copies and moves of constructor arguments
+struct CopyCounter {
+  CopyCounter() = default;
+  CopyCounter(CopyCounter const& other) : copies(other.copies + 1) {}
+  CopyCounter(CopyCounter&& other) noexcept
+      : copies(other.copies), moves(other.moves + 1) {}
+
+  int copies = 0;
+  int moves = 0;
+};
+
+struct Constructed {
+  explicit Constructed(CopyCounter const& c) noexcept
+      : copies(c.copies), moves(c.moves) {}
+  explicit Constructed(CopyCounter&& c) noexcept
+      : copies(c.copies), moves(c.moves + 1) {}
+
+  int copies;
+  int moves;
+};
+
+struct ThrowingConstructor {
+  explicit ThrowingConstructor(int) {}
+};
+
+}  // namespace
+
+TEST(FreeListOccupancyBitmapTest, capacity) {
+  using Plain = freelist::FreeList<double, 4096>;
+  using WithBitmap = freelist::FreeList<double, 4096, OccupancyBitmapOptions>;
+  EXPECT_EQ(4096u, sizeof(WithBitmap));
+  // The bitmap of 512 bits takes 8 elements
+  EXPECT_EQ(Plain::capacity() - 8, WithBitmap::capacity());
+}
+
+TEST(FreeListOccupancyBitmapTest, queries) {
+  // Large enough for the bitmap to span many words
+  using FreeListType =
+      freelist::FreeList<double, 131072, OccupancyBitmapOptions>;
+  std::unique_ptr<FreeListType> fl(new FreeListType);
+  EXPECT_EQ(0, fl->find_live());
+  EXPECT_EQ(0u, fl->count_live(0, FreeListType::index_type(-1)));
+
+  std::vector<double*> items;
+  for (int i = 0; i < 2000; ++i) {
+    items.push_back(fl->alloc(i));
+  }
+  const auto first = fl->index(items.front());
+  EXPECT_EQ(first, fl->find_live());
+  EXPECT_EQ(2000u, fl->count_live(0, FreeListType::index_type(-1)));
+  EXPECT_EQ(1497u, fl->count_live(first + 3, first + 1500));
+
+  // Free all but a few items spread over the bitmap
+  std::vector<double*> expected;
+  for (int i = 0; i < 2000; ++i) {
+    if (i == 1 || i == 700 || i == 1999) {
+      expected.push_back(items[i]);
+    } else {
+      fl->free(items[i]);
+      EXPECT_FALSE(fl->is_live(fl->index(items[i])));
+    }
+  }
+  for (double* item : expected) {
+    EXPECT_TRUE(fl->is_live(fl->index(item)));
+  }
+  EXPECT_EQ(fl->index(expected[0]), fl->find_live());
+  EXPECT_EQ(fl->index(expected[1]), fl->find_live(fl->index(expected[0]) + 1));
+  EXPECT_EQ(0, fl->find_live(fl->index(expected[2]) + 1));
+  EXPECT_EQ(2u, fl->count_live(fl->index(expected[0]) + 1,
+                               fl->index(expected[2]) + 1));
+  EXPECT_EQ(0u, fl->count_live(fl->index(expected[0]) + 1,
+                               fl->index(expected[1])));
+
+  std::vector<double*> visited;
+  fl->for_each_live([&visited](double& item) { visited.push_back(&item); });
+  EXPECT_EQ(expected, visited);
+
+  // Batched and reserved elements are marked too
+  FreeListType::index_type indices[10];
+  EXPECT_EQ(10u, fl->push_indices(indices, 10));
+  const auto fresh = fl->reserve_fresh(100);
+  ASSERT_NE(0, fresh);
+  EXPECT_EQ(113u, fl->count_live(0, FreeListType::index_type(-1)));
+  EXPECT_EQ(100u, fl->count_live(fresh, fresh + 100));
+  fl->pop_indices(indices, 10);
+  EXPECT_EQ(103u, fl->count_live(0, FreeListType::index_type(-1)));
+
+  fl->clear();
+  EXPECT_EQ(0, fl->find_live());
+  EXPECT_EQ(0u, fl->count_live(0, FreeListType::index_type(-1)));
+}
+
+TEST(FreeListOccupancyBitmapTest, clear_destroys_items) {
+  using FreeListType = freelist::FreeList<std::shared_ptr<int>, 8192,
+                                          OccupancyBitmapOptions>;
+  auto counted = std::make_shared<int>(0);
+  FreeListType fl;
+  std::vector<std::shared_ptr<int>*> items;
+  for (int i = 0; i < fl.capacity(); ++i) {
+    items.push_back(fl.alloc(counted));
+  }
+  for (size_t i = 0; i < items.size(); i += 2) {
+    fl.free(items[i]);
+  }
+  EXPECT_EQ(1 + (items.size() / 2), counted.use_count());
+  fl.clear();
+  EXPECT_EQ(1, counted.use_count());
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST(FreeListAddressOrderedTest, lowest_first) {
+  using FreeListType = freelist::FreeList<double, 8192, AddressOrderedOptions>;
+  FreeListType fl;
+  std::vector<double*> items;
+  for (int i = 0; i < fl.capacity(); ++i) {
+    items.push_back(fl.alloc(i));
+  }
+  EXPECT_TRUE(std::is_sorted(items.begin(), items.end()));
+
+  // Free in an order unrelated to address, then reallocate lowest first
+  std::vector<double*> freed;
+  for (size_t i = 0; i < items.size(); i += 7) {
+    freed.push_back(items[(i * 13) % items.size()]);
+  }
+  std::sort(freed.begin(), freed.end());
+  freed.erase(std::unique(freed.begin(), freed.end()), freed.end());
+  for (size_t i = freed.size(); i > 0; --i) {
+    fl.free(freed[(i * 5) % freed.size()]);
+  }
+  for (double* expected : freed) {
+    EXPECT_EQ(expected, fl.alloc());
+  }
+  EXPECT_TRUE(fl.full());
+}
+
+TEST(FreeListAddressOrderedTest, alloc_near) {
+  using FreeListType = freelist::FreeList<double, 8192, AddressOrderedOptions>;
+  FreeListType fl;
+  std::vector<double*> items;
+  for (int i = 0; i < fl.capacity(); ++i) {
+    items.push_back(fl.alloc(i));
+  }
+  fl.free(items[10]);
+  fl.free(items[500]);
+  fl.free(items[1000]);
+
+  EXPECT_EQ(items[500], fl.alloc_near(items[600]));
+  EXPECT_EQ(items[1000], fl.alloc_near(items[900]));
+  EXPECT_EQ(items[10], fl.alloc_near(nullptr));
+  EXPECT_THROW(fl.alloc_near(items[0]), std::bad_alloc);
+
+  // Prefers the next free element within the word of the hint
+  fl.free(items[200]);
+  fl.free(items[203]);
+  EXPECT_EQ(items[203], fl.alloc_near(items[201]));
+  EXPECT_EQ(fl.index(items[200]), fl.push_index_near(fl.index(items[201])));
+}
+
+TEST(FreeListAddressOrderedTest, reserve_fresh_after_alloc) {
+  using FreeListType = freelist::FreeList<double, 8192, AddressOrderedOptions>;
+  FreeListType fl;
+  double* a = fl.alloc();
+  double* b = fl.alloc();
+  fl.free(a);
+  const auto first = fl.reserve_fresh(10);
+  EXPECT_EQ(fl.index(b) + 1, first);
+  EXPECT_EQ(a, fl.alloc());
+  EXPECT_EQ(12u, fl.size());
+}
+
+TYPED_TEST(FreeListTest, compact_free_list) {
+  using T = typename TestFixture::T;
+  std::vector<T*> items;
+  for (int i = 0; i < this->fl.capacity(); ++i) {
+    items.push_back(this->fl.alloc());
+  }
+  std::vector<T*> freed;
+  for (size_t i = items.size(); i > 0; i -= std::min<size_t>(i, 3)) {
+    this->fl.free(items[i - 1]);
+    freed.push_back(items[i - 1]);
+  }
+  std::sort(freed.begin(), freed.end());
+
+  // Sort only part of the free list at first
+  const size_t part = freed.size() / 2;
+  this->fl.compact_free_list(part);
+  for (size_t i = 0; i < part; ++i) {
+    EXPECT_EQ(freed[i], this->fl.alloc());
+  }
+  this->fl.compact_free_list();
+  for (size_t i = part; i < freed.size(); ++i) {
+    EXPECT_EQ(freed[i], this->fl.alloc());
+  }
+  EXPECT_TRUE(this->fl.full());
+}
+
+template <typename Options>
+class FreeListHandleTest : public ::testing::Test {
+ protected:
+  using FreeListType = freelist::FreeList<std::string, 4096, Options>;
+  using Handle = typename FreeListType::Handle;
+  FreeListType fl;
+};
+
+using FreeListHandleTestTypes =
+    ::testing::Types<GenerationsOptions, AddressOrderedGenerationsOptions>;
+TYPED_TEST_CASE(FreeListHandleTest, FreeListHandleTestTypes);
+
+TYPED_TEST(FreeListHandleTest, try_get) {
+  using Handle = typename TestFixture::Handle;
+  EXPECT_EQ(nullptr, this->fl.try_get(Handle()));
+  EXPECT_FALSE(Handle());
+
+  std::string* a = this->fl.alloc("a");
+  const Handle handle = this->fl.handle(a);
+  EXPECT_TRUE(handle);
+  EXPECT_EQ(a, this->fl.try_get(handle));
+  EXPECT_EQ(handle, Handle(handle.value()));
+  EXPECT_EQ(handle, this->fl.handle(a));
+
+  // The element is reused, but the handle no longer refers to it
+  this->fl.free(a);
+  EXPECT_EQ(nullptr, this->fl.try_get(handle));
+  std::string* b = this->fl.alloc("b");
+  ASSERT_EQ(a, b);
+  EXPECT_EQ(nullptr, this->fl.try_get(handle));
+  EXPECT_NE(handle, this->fl.handle(b));
+  EXPECT_EQ(b, this->fl.try_get(this->fl.handle(b)));
+
+  // Handles with an index out of range are rejected
+  EXPECT_EQ(nullptr, this->fl.try_get(Handle(~uint64_t(0))));
+}
+
+TYPED_TEST(FreeListHandleTest, batches_and_clear) {
+  using Handle = typename TestFixture::Handle;
+  std::vector<std::string*> items(10);
+  this->fl.alloc_n(items.data(), items.size(), "x");
+  std::vector<Handle> handles;
+  for (std::string* item : items) {
+    handles.push_back(this->fl.handle(item));
+  }
+  this->fl.free_n(items.data(), 5);
+  for (size_t i = 0; i < items.size(); ++i) {
+    EXPECT_EQ(i < 5 ? nullptr : items[i], this->fl.try_get(handles[i]));
+  }
+
+  this->fl.clear();
+  for (const Handle& handle : handles) {
+    EXPECT_EQ(nullptr, this->fl.try_get(handle));
+  }
+  std::string* item = this->fl.alloc();
+  EXPECT_EQ(item, this->fl.try_get(this->fl.handle(item)));
+}
+
+TEST(FreeListHandleTest, capacity) {
+  using Plain = freelist::FreeList<double, 4096>;
+  using WithGenerations = freelist::FreeList<double, 4096, GenerationsOptions>;
+  EXPECT_EQ(4096u, sizeof(WithGenerations));
+  // The 512 counters take 256 elements
+  EXPECT_EQ(Plain::capacity() - 256, WithGenerations::capacity());
+}
+
+TEST(FreeListWidthsTest, control_words) {
+  // 2^15 doubles fit a 16-bit index, which the default does not choose
+  using Plain = freelist::FreeList<double, 262144>;
+  using Compact = freelist::FreeList<double, 262144, CompactIndexOptions>;
+  static_assert(sizeof(Plain::index_type) == 4, "default index_type");
+  static_assert(sizeof(Compact::index_type) == 2, "IndexType");
+  EXPECT_EQ(262144u, sizeof(Compact));
+  // The control words shrink from 16 to 8 bytes, one element
+  EXPECT_EQ(Plain::capacity() + 1, Compact::capacity());
+
+  // 18-bit indexes in a 4-byte head word, with a 14-bit tag; the control
+  // words shrink from 16 to 12 bytes, one element
+  using PlainInt = freelist::FreeList<int32_t, 1 << 20>;
+  using Head32 = freelist::FreeList<int32_t, 1 << 20, Head32Options>;
+  EXPECT_EQ(PlainInt::capacity() + 1, Head32::capacity());
+
+  Compact fl;
+  std::vector<double*> items;
+  for (size_t i = 0; i < Compact::capacity(); ++i) {
+    items.push_back(fl.alloc(static_cast<double>(i)));
+  }
+  EXPECT_TRUE(fl.full());
+  EXPECT_EQ(Compact::capacity(), fl.size());
+  for (size_t i = 0; i < items.size(); ++i) {
+    EXPECT_EQ(static_cast<double>(i), *items[i]);
+    fl.free(items[i]);
+  }
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST(FreeListStatsTest, snapshot) {
+  using FreeListType = freelist::FreeList<double, 4096, StatsOptions>;
+  FreeListType fl;
+  freelist::FreeListStats stats = fl.snapshot();
+  EXPECT_EQ(0u, stats.allocs);
+  EXPECT_EQ(0u, stats.size);
+  EXPECT_EQ(FreeListType::capacity(), stats.capacity);
+
+  std::vector<double*> items;
+  for (int i = 0; i < fl.capacity(); ++i) {
+    items.push_back(fl.alloc());
+  }
+  EXPECT_THROW(fl.alloc(), std::bad_alloc);
+  for (int i = 0; i < 10; ++i) {
+    fl.free(items.back());
+    items.pop_back();
+  }
+  std::vector<double*> batch(5);
+  fl.alloc_n(batch.data(), batch.size());
+  fl.free_n(batch.data(), batch.size());
+
+  stats = fl.snapshot();
+  EXPECT_EQ(fl.capacity() + 5, stats.allocs);
+  EXPECT_EQ(15u, stats.frees);
+  EXPECT_EQ(1u, stats.failures);
+  EXPECT_EQ(fl.capacity() - 10, stats.size);
+  EXPECT_EQ(fl.capacity(), stats.peak_size);
+  EXPECT_EQ(fl.capacity(), stats.peak_used);
+  // Without contention, no operation retries
+  uint64_t operations = 0;
+  for (uint64_t count : stats.retries) operations += count;
+  EXPECT_EQ(operations, stats.retries[0]);
+  EXPECT_EQ(fl.capacity() + 1 + 10 + 2, operations);
+
+  // Peaks are kept by clear(), which frees the remaining items
+  fl.clear();
+  stats = fl.snapshot();
+  EXPECT_EQ(stats.allocs, stats.frees);
+  EXPECT_EQ(0u, stats.size);
+  EXPECT_EQ(fl.capacity(), stats.peak_size);
+  EXPECT_EQ(fl.capacity(), stats.peak_used);
+}
+
+TEST(FreeListForwardingTest, no_copies) {
+  freelist::FreeList<Constructed, 256> fl;
+  CopyCounter c;
+
+  Constructed* lvalue = fl.alloc(c);
+  EXPECT_EQ(0, lvalue->copies);
+  EXPECT_EQ(0, lvalue->moves);
+
+  Constructed* rvalue = fl.alloc(std::move(c));
+  EXPECT_EQ(0, rvalue->copies);
+  EXPECT_EQ(1, rvalue->moves);
+
+  auto unique = fl.make_unique(CopyCounter());
+  EXPECT_EQ(0, unique->copies);
+  EXPECT_EQ(1, unique->moves);
+
+  auto shared = fl.make_shared(c);
+  EXPECT_EQ(0, shared->copies);
+  EXPECT_EQ(0, shared->moves);
+
+  fl.free(lvalue);
+  fl.free(rvalue);
+}
+
+TEST(FreeListForwardingTest, move_only) {
+  freelist::FreeList<std::unique_ptr<int>, 256> fl;
+  std::unique_ptr<int> value(new int(5));
+  std::unique_ptr<int>* item = fl.alloc(std::move(value));
+  EXPECT_FALSE(value);
+  EXPECT_EQ(5, **item);
+  fl.free(item);
+
+  auto index = fl.emplace(new int(6));
+  EXPECT_EQ(6, **fl.get(index));
+  fl.free(fl.get(index));
+}
+
+TEST(FreeListForwardingTest, emplace_noexcept) {
+  freelist::FreeList<Constructed, 256> fl;
+  freelist::FreeList<ThrowingConstructor, 256> throwing;
+  static_assert(noexcept(fl.emplace(std::declval<CopyCounter>())),
+                "emplace is noexcept if the constructor is");
+  static_assert(!noexcept(throwing.emplace(1)),
+                "emplace may throw if the constructor may");
+  static_assert(!noexcept(fl.alloc(std::declval<CopyCounter>())),
+                "alloc throws std::bad_alloc if full");
+}
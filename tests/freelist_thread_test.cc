@@ -51,6 +51,7 @@ std::mutex printMutex;
     ostream << msg;                               \
   }
 
+template <typename FreeListType>
 bool threadFunc(FreeListType& fl, uint64_t threadNum, uint64_t doubleCount) {
   bool result = false;
 
@@ -61,7 +62,7 @@ bool threadFunc(FreeListType& fl, uint64_t threadNum, uint64_t doubleCount) {
   }
 
   // Prepare a vector of unique_ptr, initially unset
-  std::vector<FreeListType::UniquePtr> vec{doubleCount};
+  std::vector<typename FreeListType::UniquePtr> vec{doubleCount};
 
   // Loop over the array many times
   for (int j = 0; j < doubleCount * 10; ++j) {
@@ -87,6 +88,7 @@ bool threadFunc(FreeListType& fl, uint64_t threadNum, uint64_t doubleCount) {
   return result;
 }
 
+template <typename FreeListType>
 bool testWithNThreads(FreeListType& fl, uint64_t threadCount) {
   uint64_t doubleCount = 100;
   if (fl.max_size() <= doubleCount * threadCount) {
@@ -100,7 +102,7 @@ bool testWithNThreads(FreeListType& fl, uint64_t threadCount) {
 
   for (int i = 0; i < threadCount; ++i) {
     tasks[i] = std::packaged_task<bool()>(
-        std::bind(threadFunc, std::ref(fl), i, doubleCount));
+        std::bind(threadFunc<FreeListType>, std::ref(fl), i, doubleCount));
     futures[i] = tasks[i].get_future();
   }
 
@@ -128,3 +130,88 @@ TEST_F(FreeListThreadTest, tenThreads) {
 TEST_F(FreeListThreadTest, oneHundredThreads) {
   EXPECT_FALSE(testWithNThreads(fl, 100));
 }
+
+TEST_F(FreeListThreadTest, fourByteIndexTenThreads) {
+  // Large enough to require 4-byte indexes
+  using LargeFreeListType = freelist::FreeList<double, 1048576>;
+  std::unique_ptr<LargeFreeListType> large(new LargeFreeListType);
+  EXPECT_FALSE(testWithNThreads(*large, 10));
+  EXPECT_TRUE(large->empty());
+}
+
+struct OccupancyBitmapOptions : freelist::FreeListOptions {
+  static constexpr bool kOccupancyBitmap = true;
+};
+
+TEST_F(FreeListThreadTest, occupancyBitmapTenThreads) {
+  using BitmapFreeListType =
+      freelist::FreeList<double, 80080, OccupancyBitmapOptions>;
+  BitmapFreeListType bitmapFl;
+  std::vector<BitmapFreeListType::UniquePtr> kept;
+  for (int i = 0; i < 100; ++i) {
+    kept.push_back(bitmapFl.make_unique(i));
+  }
+  EXPECT_FALSE(testWithNThreads(bitmapFl, 10));
+  EXPECT_EQ(100u, bitmapFl.count_live(0, BitmapFreeListType::index_type(-1)));
+}
+
+struct AddressOrderedOptions : OccupancyBitmapOptions {
+  static constexpr bool kAddressOrdered = true;
+};
+
+TEST_F(FreeListThreadTest, addressOrderedTenThreads) {
+  using OrderedFreeListType =
+      freelist::FreeList<double, 80080, AddressOrderedOptions>;
+  OrderedFreeListType orderedFl;
+  EXPECT_FALSE(testWithNThreads(orderedFl, 10));
+  EXPECT_TRUE(orderedFl.empty());
+  EXPECT_EQ(0, orderedFl.find_live());
+}
+
+struct StatsOptions : freelist::FreeListOptions {
+  static constexpr bool kStats = true;
+};
+
+TEST_F(FreeListThreadTest, statsTenThreads) {
+  using StatsFreeListType = freelist::FreeList<double, 80064, StatsOptions>;
+  StatsFreeListType statsFl;
+  EXPECT_FALSE(testWithNThreads(statsFl, 10));
+  const freelist::FreeListStats stats = statsFl.snapshot();
+  EXPECT_EQ(10u * 100 * 10, stats.allocs);
+  EXPECT_EQ(stats.allocs, stats.frees);
+  EXPECT_EQ(0u, stats.failures);
+  EXPECT_EQ(0u, stats.size);
+  EXPECT_GE(10u * 100, stats.peak_size);
+  EXPECT_LE(100u, stats.peak_size);
+  uint64_t operations = 0;
+  for (uint64_t count : stats.retries) operations += count;
+  EXPECT_EQ(stats.allocs + stats.frees, operations);
+}
+
+struct EliminationOptions : StatsOptions {
+  static constexpr std::size_t kEliminationSlots = 4;
+};
+
+TEST_F(FreeListThreadTest, eliminationTenThreads) {
+  using EliminationFreeListType =
+      freelist::FreeList<double, 80064, EliminationOptions>;
+  EliminationFreeListType eliminationFl;
+  EXPECT_FALSE(testWithNThreads(eliminationFl, 10));
+  EXPECT_TRUE(eliminationFl.empty());
+  const freelist::FreeListStats stats = eliminationFl.snapshot();
+  EXPECT_EQ(10u * 100 * 10, stats.allocs);
+  EXPECT_EQ(stats.allocs, stats.frees);
+  EXPECT_EQ(0u, stats.failures);
+}
+
+struct Head32Options : freelist::FreeListOptions {
+  using IndexType = uint32_t;
+  using HeadType = uint32_t;
+};
+
+TEST_F(FreeListThreadTest, head32TenThreads) {
+  using Head32FreeListType = freelist::FreeList<double, 80000, Head32Options>;
+  Head32FreeListType head32Fl;
+  EXPECT_FALSE(testWithNThreads(head32Fl, 10));
+  EXPECT_TRUE(head32Fl.empty());
+}
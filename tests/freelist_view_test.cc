@@ -0,0 +1,264 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <freelist/freelist_view.h>
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using ViewType = freelist::FreeListView<double>;
+
+class FreeListViewTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kBytes = 80000;
+  alignas(ViewType::kAlignment) uint8_t buffer[kBytes];
+};
+
+constexpr size_t FreeListViewTest::kBytes;
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_F(FreeListViewTest, capacity) {
+  ViewType fl(buffer, kBytes);
+  EXPECT_TRUE(fl.empty());
+  EXPECT_EQ(ViewType::capacity_for(kBytes), fl.capacity());
+  EXPECT_GT(kBytes / sizeof(double), fl.capacity());
+  EXPECT_LE(kBytes / sizeof(double) - 8, fl.capacity());
+  EXPECT_EQ(buffer, fl.buffer());
+}
+
+TEST_F(FreeListViewTest, invalid_buffer) {
+  EXPECT_THROW(ViewType(buffer + 1, kBytes - 1), std::invalid_argument);
+  EXPECT_THROW(ViewType(buffer, 8), std::invalid_argument);
+  EXPECT_THROW(ViewType(nullptr, kBytes), std::invalid_argument);
+  EXPECT_EQ(0, ViewType::capacity_for(8));
+}
+
+TEST_F(FreeListViewTest, alloc_and_free) {
+  ViewType fl(buffer, kBytes);
+  std::vector<double*> items;
+  for (size_t i = 0; i < fl.capacity(); ++i) {
+    items.push_back(fl.alloc(static_cast<double>(i)));
+    EXPECT_LE(reinterpret_cast<uint8_t*>(buffer),
+              reinterpret_cast<uint8_t*>(items.back()));
+    EXPECT_GT(reinterpret_cast<uint8_t*>(buffer) + kBytes,
+              reinterpret_cast<uint8_t*>(items.back()));
+  }
+  EXPECT_TRUE(fl.full());
+  EXPECT_THROW(fl.alloc(0.0), std::bad_alloc);
+
+  for (size_t i = 0; i < items.size(); ++i) {
+    EXPECT_EQ(static_cast<double>(i), *items[i]);
+    EXPECT_EQ(items[i], fl.get(fl.index(items[i])));
+  }
+
+  fl.free(items.back());
+  items.pop_back();
+  EXPECT_FALSE(fl.full());
+  items.push_back(fl.alloc(1.0));
+
+  for (double* d : items) {
+    fl.free(d);
+  }
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(FreeListViewTest, indices) {
+  ViewType fl(buffer, kBytes);
+  ViewType::index_type indices[100];
+  EXPECT_EQ(100, fl.push_indices(indices, 100));
+  EXPECT_EQ(100, fl.size());
+  fl.pop_indices(indices, 100);
+  EXPECT_TRUE(fl.empty());
+
+  ViewType::index_type first = fl.reserve_fresh(10);
+  EXPECT_NE(0, first);
+  for (ViewType::index_type i = 0; i < 10; ++i) {
+    fl.pop_index(first + i);
+  }
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(FreeListViewTest, attach) {
+  // The buffer may hold a FreeList from a previous test
+  std::fill(buffer, buffer + kBytes, 0);
+  EXPECT_THROW(ViewType::attach(buffer, kBytes), std::invalid_argument);
+
+  ViewType fl(buffer, kBytes);
+  double* d = fl.alloc(1.0);
+  ViewType::index_type index = fl.index(d);
+
+  ViewType attached = ViewType::attach(buffer, kBytes);
+  EXPECT_EQ(1, attached.size());
+  EXPECT_EQ(fl.capacity(), attached.capacity());
+  EXPECT_EQ(1.0, *attached.get(index));
+  attached.free(d);
+  EXPECT_TRUE(fl.empty());
+
+  EXPECT_THROW(ViewType::attach(buffer + 1, kBytes), std::invalid_argument);
+  EXPECT_THROW(ViewType::attach(buffer, kBytes / 2), std::invalid_argument);
+  EXPECT_THROW(freelist::FreeListView<int64_t[2]>::attach(buffer, kBytes),
+               std::invalid_argument);
+}
+
+namespace {
+
+struct AlignedOptions : freelist::FreeListOptions {
+  static constexpr bool kCacheLineAligned = true;
+};
+
+}  // namespace
+
+TEST_F(FreeListViewTest, attach_checks_options) {
+  using AlignedType = freelist::FreeListView<double, AlignedOptions>;
+  using SingleThreadedType =
+      freelist::FreeListView<double, freelist::SingleThreaded>;
+  alignas(AlignedType::kAlignment) static uint8_t aligned[kBytes];
+
+  ViewType fl(aligned, kBytes);
+  EXPECT_THROW(AlignedType::attach(aligned, kBytes), std::invalid_argument);
+  EXPECT_THROW(SingleThreadedType::attach(aligned, kBytes),
+               std::invalid_argument);
+  EXPECT_NO_THROW(ViewType::attach(aligned, kBytes));
+
+  AlignedType alignedFl(aligned, kBytes);
+  EXPECT_THROW(ViewType::attach(aligned, kBytes), std::invalid_argument);
+  EXPECT_NO_THROW(AlignedType::attach(aligned, kBytes));
+}
+
+TEST_F(FreeListViewTest, emplace_move_only) {
+  freelist::FreeListView<std::unique_ptr<int>> fl(buffer, kBytes);
+  std::unique_ptr<int> value(new int(5));
+  std::unique_ptr<int>* item = fl.alloc(std::move(value));
+  EXPECT_FALSE(value);
+  EXPECT_EQ(5, **item);
+  fl.free(item);
+
+  auto index = fl.emplace(new int(6));
+  EXPECT_NE(0, index);
+  EXPECT_EQ(6, **fl.get(index));
+  fl.free(fl.get(index));
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(FreeListViewTest, deleter) {
+  static_assert(sizeof(ViewType::Deleter) == sizeof(ViewType),
+                "Deleter must hold only a copy of the view");
+  ViewType::UniquePtr empty;
+  EXPECT_FALSE(empty);
+
+  ViewType fl(buffer, kBytes);
+  ViewType::Deleter deleter = fl.deleter();
+  deleter(fl.alloc(1.0));
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(FreeListViewTest, live) {
+  ViewType fl(buffer, kBytes);
+  EXPECT_TRUE(fl.live().begin() == fl.live().end());
+
+  std::vector<double*> items;
+  for (int i = 0; i < 100; ++i) {
+    items.push_back(fl.alloc(static_cast<double>(i)));
+  }
+  for (int i = 99; i >= 0; i -= 2) {
+    fl.free(items[i]);
+  }
+
+  double expected = 0;
+  for (double d : fl.live()) {
+    EXPECT_EQ(expected, d);
+    expected += 2;
+  }
+  EXPECT_EQ(100, expected);
+
+  double sum = 0;
+  fl.for_each_live([&sum](double d) { sum += d; });
+  EXPECT_EQ(2450, sum);
+}
+
+TEST_F(FreeListViewTest, copies_share_buffer) {
+  ViewType fl(buffer, kBytes);
+  ViewType copy = fl;
+  double* d = copy.alloc(1.0);
+  EXPECT_EQ(1, fl.size());
+  fl.free(d);
+  EXPECT_TRUE(copy.empty());
+
+  {
+    auto p = fl.make_unique(2.0);
+    EXPECT_EQ(1, copy.size());
+  }
+  EXPECT_TRUE(copy.empty());
+}
+
+TEST_F(FreeListViewTest, clear) {
+  std::vector<uint64_t> storage(1000);
+  freelist::FreeListView<std::string> fl(storage.data(),
+                                         storage.size() * sizeof(uint64_t));
+  std::vector<std::string*> items;
+  for (int i = 0; i < 50; ++i) {
+    items.push_back(fl.alloc("a string long enough to require allocation"));
+  }
+  for (int i = 0; i < 50; i += 2) {
+    fl.free(items[i]);
+  }
+  fl.clear();
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(FreeListViewTest, mmap_buffer) {
+  const size_t bytes = 1 << 22;
+  void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(MAP_FAILED, memory);
+
+  ViewType fl(memory, bytes);
+  std::vector<std::future<void>> futures;
+  for (int t = 0; t < 8; ++t) {
+    futures.push_back(std::async(std::launch::async, [&fl, t]() {
+      std::vector<double*> items;
+      for (int j = 0; j < 10000; ++j) {
+        items.push_back(fl.alloc(static_cast<double>(t)));
+        if (items.size() > 100) {
+          EXPECT_EQ(static_cast<double>(t), *items.front());
+          fl.free(items.front());
+          items.erase(items.begin());
+        }
+      }
+      for (double* d : items) fl.free(d);
+    }));
+  }
+  for (auto& f : futures) f.get();
+  EXPECT_TRUE(fl.empty());
+
+  munmap(memory, bytes);
+}
@@ -0,0 +1,262 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <freelist/growable_freelist.h>
+
+#include <future>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using GrowableType = freelist::GrowableFreeList<double, 4096>;
+
+class GrowableFreeListTest : public ::testing::Test {
+ protected:
+  GrowableType fl;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_F(GrowableFreeListTest, empty) {
+  EXPECT_TRUE(fl.empty());
+  EXPECT_EQ(0, fl.size());
+  EXPECT_EQ(0, fl.slab_count());
+  EXPECT_EQ(0, fl.capacity());
+}
+
+TEST_F(GrowableFreeListTest, grows_on_demand) {
+  std::vector<double*> items;
+  const size_t perSlab = GrowableType::Slab::capacity();
+
+  for (size_t i = 0; i < perSlab * 3 + 1; ++i) {
+    items.push_back(fl.alloc(static_cast<double>(i)));
+  }
+  EXPECT_EQ(4, fl.slab_count());
+  EXPECT_EQ(perSlab * 3 + 1, fl.size());
+  EXPECT_EQ(perSlab * 4, fl.capacity());
+
+  std::set<GrowableType::Slab*> slabs;
+  for (size_t i = 0; i < items.size(); ++i) {
+    EXPECT_EQ(static_cast<double>(i), *items[i]);
+    slabs.insert(GrowableType::slab(items[i]));
+  }
+  EXPECT_EQ(4, slabs.size());
+
+  for (double* d : items) {
+    fl.free(d);
+  }
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(GrowableFreeListTest, slab_of_item) {
+  double* d = fl.alloc(1.0);
+  GrowableType::Slab* s = GrowableType::slab(d);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(s) % 4096);
+  EXPECT_EQ(d, s->get(s->index(d)));
+  EXPECT_EQ(1, s->size());
+  fl.free(d);
+}
+
+TEST_F(GrowableFreeListTest, make_unique) {
+  static_assert(sizeof(GrowableType::UniquePtr) == sizeof(double*),
+                "UniquePtr must be the size of a pointer");
+  const size_t perSlab = GrowableType::Slab::capacity();
+  {
+    std::vector<GrowableType::UniquePtr> items;
+    for (size_t i = 0; i < perSlab + 1; ++i) {
+      items.push_back(fl.make_unique(static_cast<double>(i)));
+    }
+    EXPECT_EQ(2, fl.slab_count());
+    EXPECT_EQ(perSlab + 1, fl.size());
+    EXPECT_EQ(static_cast<double>(perSlab), *items.back());
+  }
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(GrowableFreeListTest, for_each_live) {
+  const size_t perSlab = GrowableType::Slab::capacity();
+  std::vector<double*> items;
+  for (size_t i = 0; i < perSlab * 2 + 10; ++i) {
+    items.push_back(fl.alloc(1.0));
+  }
+  fl.free(items[0]);
+  fl.free(items[perSlab]);
+
+  size_t count = 0;
+  fl.for_each_live([&count](double& d) {
+    EXPECT_EQ(1.0, d);
+    ++count;
+  });
+  EXPECT_EQ(items.size() - 2, count);
+
+  for (size_t i = 0; i < items.size(); ++i) {
+    if (i != 0 && i != perSlab) fl.free(items[i]);
+  }
+}
+
+TEST_F(GrowableFreeListTest, reuses_freed_space) {
+  const size_t perSlab = GrowableType::Slab::capacity();
+  std::vector<double*> items;
+  for (size_t i = 0; i < perSlab * 2; ++i) {
+    items.push_back(fl.alloc(0.0));
+  }
+  EXPECT_EQ(2, fl.slab_count());
+
+  fl.free(items[0]);
+  items[0] = fl.alloc(0.0);
+  EXPECT_EQ(2, fl.slab_count());
+
+  for (double* d : items) {
+    fl.free(d);
+  }
+}
+
+TEST_F(GrowableFreeListTest, reuses_space_freed_by_deleter) {
+  const size_t perSlab = GrowableType::Slab::capacity();
+  std::vector<GrowableType::UniquePtr> items;
+  for (size_t i = 0; i < perSlab * 2; ++i) {
+    items.push_back(fl.make_unique(0.0));
+  }
+  EXPECT_EQ(2, fl.slab_count());
+
+  // The deleter does not list the slab as having space, but alloc() finds
+  // it before adding a slab
+  items[0].reset();
+  items[0] = fl.make_unique(1.0);
+  EXPECT_EQ(2, fl.slab_count());
+}
+
+TEST_F(GrowableFreeListTest, burst_adds_one_slab) {
+  const size_t perSlab = GrowableType::Slab::capacity();
+  std::vector<double*> items;
+  for (size_t i = 0; i < perSlab; ++i) {
+    items.push_back(fl.alloc(0.0));
+  }
+  EXPECT_EQ(1, fl.slab_count());
+
+  // Threads that all find the only slab full add a single slab between them
+  const size_t kThreads = 8;
+  std::promise<void> start;
+  std::shared_future<void> started = start.get_future().share();
+  std::vector<std::future<double*>> futures;
+  for (size_t i = 0; i < kThreads; ++i) {
+    futures.push_back(std::async(std::launch::async, [this, started]() {
+      started.wait();
+      return fl.alloc(1.0);
+    }));
+  }
+  start.set_value();
+  for (auto& f : futures) {
+    items.push_back(f.get());
+  }
+  EXPECT_EQ(2, fl.slab_count());
+  EXPECT_EQ(perSlab + kThreads, fl.size());
+
+  for (double* d : items) {
+    fl.free(d);
+  }
+}
+
+TEST_F(GrowableFreeListTest, max_slabs) {
+  using LimitedType = freelist::GrowableFreeList<double, 256>;
+  LimitedType limited(2);
+  std::vector<double*> items;
+  for (size_t i = 0; i < LimitedType::Slab::capacity() * 2; ++i) {
+    items.push_back(limited.alloc(0.0));
+  }
+  EXPECT_THROW(limited.alloc(0.0), std::bad_alloc);
+  EXPECT_EQ(2, limited.slab_count());
+}
+
+TEST_F(GrowableFreeListTest, release_empty_slabs) {
+  const size_t perSlab = GrowableType::Slab::capacity();
+  std::vector<double*> items;
+  for (size_t i = 0; i < perSlab * 3; ++i) {
+    items.push_back(fl.alloc(0.0));
+  }
+  EXPECT_EQ(3, fl.slab_count());
+
+  // Empty two slabs, keep one item in the other
+  GrowableType::Slab* kept = GrowableType::slab(items[0]);
+  for (size_t i = 1; i < items.size(); ++i) {
+    fl.free(items[i]);
+  }
+  EXPECT_EQ(2, fl.release_empty_slabs());
+  EXPECT_EQ(1, fl.slab_count());
+  EXPECT_EQ(1, fl.size());
+
+  double* d = fl.alloc(2.0);
+  EXPECT_EQ(kept, GrowableType::slab(d));
+  fl.free(d);
+  fl.free(items[0]);
+}
+
+TEST_F(GrowableFreeListTest, destructor) {
+  // Items left in the list are destroyed with it
+  freelist::GrowableFreeList<std::string, 1024> strings;
+  for (int i = 0; i < 200; ++i) {
+    strings.alloc("a string long enough to require a heap allocation");
+  }
+  EXPECT_LT(1, strings.slab_count());
+}
+
+bool growableThreadFunc(GrowableType& fl, uint64_t threadNum) {
+  const uint64_t itemCount = 1000;
+  std::vector<double*> vec(itemCount, nullptr);
+  bool result = false;
+
+  for (uint64_t j = 0; j < itemCount * 10; ++j) {
+    uint64_t i = (j * (threadNum * (itemCount + 1) + 1)) % itemCount;
+    double expected = static_cast<double>(threadNum * 100000 + i);
+    if (vec[i]) {
+      result = result || *vec[i] != expected;
+      fl.free(vec[i]);
+    }
+    vec[i] = fl.alloc(expected);
+  }
+
+  for (double* d : vec) {
+    if (d) fl.free(d);
+  }
+  return result;
+}
+
+TEST_F(GrowableFreeListTest, tenThreads) {
+  std::vector<std::future<bool>> futures;
+  for (uint64_t i = 0; i < 10; ++i) {
+    futures.push_back(
+        std::async(std::launch::async, growableThreadFunc, std::ref(fl), i));
+  }
+  for (auto& f : futures) {
+    EXPECT_FALSE(f.get());
+  }
+  EXPECT_TRUE(fl.empty());
+  EXPECT_LE(1000 / GrowableType::Slab::capacity(), fl.slab_count());
+  // Slabs are only added when all are full, so at most one more than the
+  // peak of 10 * 1000 items needs, with some slack for concurrent frees
+  EXPECT_GE(2 * (10 * 1000 / GrowableType::Slab::capacity() + 1),
+            fl.slab_count());
+}
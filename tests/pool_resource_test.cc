@@ -0,0 +1,187 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <freelist/pool_resource.h>
+
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Upstream resource counting its allocations
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  int allocations = 0;
+
+ protected:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override {
+    --allocations;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(
+      std::pmr::memory_resource const& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+}  // namespace
+
+template <typename Resource>
+class PoolResourceTest : public ::testing::Test {
+ protected:
+  CountingResource upstream;
+  Resource resource{&upstream};
+};
+
+using ResourceTypes = ::testing::Types<freelist::pool_resource,
+                                       freelist::unsynchronized_pool_resource>;
+TYPED_TEST_SUITE(PoolResourceTest, ResourceTypes);
+
+////////////////////////////////////////////////////////////////////////////////
+
+TYPED_TEST(PoolResourceTest, size_classes) {
+  std::vector<std::pair<void*, std::size_t>> blocks;
+  for (std::size_t bytes = 1; bytes <= TypeParam::kMaxBlockBytes; bytes *= 3) {
+    void* p = this->resource.allocate(bytes, alignof(std::max_align_t));
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) % alignof(std::max_align_t));
+    std::memset(p, 0xab, bytes);
+    blocks.emplace_back(p, bytes);
+  }
+  EXPECT_EQ(0, this->upstream.allocations);
+
+  for (auto const& b : blocks) {
+    this->resource.deallocate(b.first, b.second, alignof(std::max_align_t));
+  }
+}
+
+TYPED_TEST(PoolResourceTest, alignment) {
+  for (std::size_t align = 1; align <= TypeParam::kMaxBlockBytes; align *= 2) {
+    void* p = this->resource.allocate(1, align);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) % align);
+    this->resource.deallocate(p, 1, align);
+  }
+  EXPECT_EQ(0, this->upstream.allocations);
+}
+
+TYPED_TEST(PoolResourceTest, oversized_upstream) {
+  void* p = this->resource.allocate(TypeParam::kMaxBlockBytes + 1);
+  EXPECT_EQ(1, this->upstream.allocations);
+  this->resource.deallocate(p, TypeParam::kMaxBlockBytes + 1);
+  EXPECT_EQ(0, this->upstream.allocations);
+
+  p = this->resource.allocate(8, TypeParam::kMaxBlockBytes * 2);
+  EXPECT_EQ(1, this->upstream.allocations);
+  this->resource.deallocate(p, 8, TypeParam::kMaxBlockBytes * 2);
+  EXPECT_EQ(0, this->upstream.allocations);
+  EXPECT_EQ(&this->upstream, this->resource.upstream_resource());
+}
+
+TYPED_TEST(PoolResourceTest, reuse) {
+  void* a = this->resource.allocate(24);
+  this->resource.deallocate(a, 24);
+  void* b = this->resource.allocate(32);
+  EXPECT_EQ(a, b);
+  this->resource.deallocate(b, 32);
+}
+
+TYPED_TEST(PoolResourceTest, containers) {
+  std::pmr::vector<std::pmr::string> strings(&this->resource);
+  std::pmr::unordered_map<int, std::pmr::string> map(&this->resource);
+  std::pmr::map<int, int> ordered(&this->resource);
+  for (int i = 0; i < 1000; ++i) {
+    strings.emplace_back("a string long enough to need allocation");
+    map.emplace(i, std::to_string(i));
+    ordered[i] = i;
+  }
+  EXPECT_EQ("999", map.at(999));
+  EXPECT_EQ(1000, ordered.size());
+  EXPECT_EQ(1000, strings.size());
+}
+
+TYPED_TEST(PoolResourceTest, equality) {
+  TypeParam other;
+  EXPECT_TRUE(this->resource.is_equal(this->resource));
+  EXPECT_FALSE(this->resource.is_equal(other));
+}
+
+TEST(SynchronizedPoolResourceTest, threads) {
+  freelist::pool_resource resource;
+  std::vector<std::future<void>> futures;
+  for (int t = 0; t < 8; ++t) {
+    futures.push_back(std::async(std::launch::async, [&resource, t]() {
+      std::pmr::vector<std::pmr::vector<int>> vectors(&resource);
+      for (int i = 0; i < 2000; ++i) {
+        vectors.emplace_back(static_cast<std::size_t>(i % 64), t);
+        if (vectors.size() > 50) vectors.erase(vectors.begin());
+      }
+      for (auto const& v : vectors) {
+        for (int x : v) EXPECT_EQ(t, x);
+      }
+    }));
+  }
+  for (auto& f : futures) f.get();
+}
+
+TEST(SizeClassPoolResourceTest, upstream_when_full) {
+  using Resource = freelist::size_class_pool_resource<
+      freelist::PowerOfTwoSizeClassPool<4096, 256>>;
+  CountingResource upstream;
+  std::unique_ptr<Resource> resource(new Resource(&upstream));
+
+  std::vector<void*> blocks;
+  for (int i = 0; i < 1000; ++i) {
+    blocks.push_back(resource->allocate(64));
+  }
+  // Each class holds fewer than 4096 / 64 blocks
+  EXPECT_LT(0, upstream.allocations);
+  EXPECT_GT(1000 - 4096 / 64, upstream.allocations);
+  void* large = resource->allocate(257);
+  EXPECT_FALSE(resource->pool().owns(large));
+  resource->deallocate(large, 257);
+
+  for (void* p : blocks) resource->deallocate(p, 64);
+  EXPECT_EQ(0, upstream.allocations);
+
+  std::pmr::vector<std::pmr::string> strings(resource.get());
+  for (int i = 0; i < 100; ++i) {
+    strings.emplace_back("a string long enough to need allocation");
+  }
+  EXPECT_EQ(100, strings.size());
+}
@@ -0,0 +1,207 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <freelist/sharded_freelist.h>
+
+#include <future>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Shard selected by the test for the calling thread
+thread_local uint32_t testShard = 0;
+
+uint32_t selectTestShard() { return testShard; }
+
+}  // namespace
+
+using ShardedType = freelist::ShardedFreeList<double, 4096, 4>;
+
+class ShardedFreeListTest : public ::testing::Test {
+ protected:
+  void SetUp() override { testShard = 0; }
+
+  ShardedType fl{&selectTestShard};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_F(ShardedFreeListTest, empty) {
+  EXPECT_TRUE(fl.empty());
+  EXPECT_EQ(0, fl.size());
+  EXPECT_EQ(0, fl.shard_count());
+  EXPECT_EQ(0, fl.capacity());
+  EXPECT_EQ(4, ShardedType::max_shards());
+}
+
+TEST_F(ShardedFreeListTest, local_first) {
+  testShard = 2;
+  EXPECT_EQ(2, fl.local_shard());
+  double* a = fl.alloc(1.0);
+  testShard = 5;
+  EXPECT_EQ(1, fl.local_shard());
+  double* b = fl.alloc(2.0);
+
+  EXPECT_EQ(2, fl.shard_count());
+  EXPECT_NE(ShardedType::shard(a), ShardedType::shard(b));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(ShardedType::shard(a)) % 4096);
+  EXPECT_EQ(1.0, *a);
+  EXPECT_EQ(2.0, *b);
+  EXPECT_EQ(2, fl.size());
+
+  fl.free(b);
+  testShard = 2;
+  fl.free(a);
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(ShardedFreeListTest, steals_when_full) {
+  const size_t perShard = ShardedType::Shard::capacity();
+  testShard = 1;
+  double* other = fl.alloc(0.0);
+
+  testShard = 0;
+  std::vector<double*> items;
+  for (size_t i = 0; i < perShard; ++i) {
+    items.push_back(fl.alloc(0.0));
+  }
+  ShardedType::Shard* local = ShardedType::shard(items[0]);
+  EXPECT_TRUE(local->full());
+
+  // The local shard is full, so take from the other existing shard
+  double* stolen = fl.alloc(1.0);
+  EXPECT_EQ(ShardedType::shard(other), ShardedType::shard(stolen));
+  EXPECT_EQ(2, fl.shard_count());
+
+  for (size_t i = 2; i < perShard; ++i) {
+    fl.alloc(0.0);
+  }
+  EXPECT_THROW(fl.alloc(0.0), std::bad_alloc);
+  EXPECT_EQ(perShard * 2, fl.size());
+}
+
+TEST_F(ShardedFreeListTest, remote_free) {
+  const size_t perShard = ShardedType::Shard::capacity();
+  std::vector<double*> items;
+  for (size_t i = 0; i < perShard; ++i) {
+    items.push_back(fl.alloc(0.0));
+  }
+  ShardedType::Shard* owner = ShardedType::shard(items[0]);
+
+  // Free from another shard, the items are queued for their owner
+  testShard = 3;
+  for (size_t i = 0; i < 100; ++i) {
+    fl.free(items[i]);
+  }
+  EXPECT_EQ(perShard - 100, fl.size());
+  EXPECT_TRUE(owner->full());
+  EXPECT_EQ(1, fl.shard_count());
+
+  // The owner drains its queue when it finds its shard full
+  testShard = 0;
+  for (size_t i = 0; i < 100; ++i) {
+    items[i] = fl.alloc(1.0);
+    EXPECT_EQ(owner, ShardedType::shard(items[i]));
+  }
+  EXPECT_EQ(1, fl.shard_count());
+  EXPECT_EQ(perShard, fl.size());
+
+  testShard = 1;
+  for (double* d : items) {
+    fl.free(d);
+  }
+  EXPECT_TRUE(fl.empty());
+  EXPECT_EQ(perShard, fl.collect());
+  EXPECT_TRUE(owner->empty());
+}
+
+TEST_F(ShardedFreeListTest, destructor) {
+  // Items left in the list or queued are destroyed exactly once
+  freelist::ShardedFreeList<std::string, 1024, 2> strings(&selectTestShard);
+  std::vector<std::string*> items;
+  for (int i = 0; i < 20; ++i) {
+    items.push_back(
+        strings.alloc("a string long enough to require a heap allocation"));
+  }
+  testShard = 1;
+  for (int i = 0; i < 10; ++i) {
+    strings.free(items[i]);
+  }
+  EXPECT_EQ(10, strings.size());
+}
+
+bool shardedThreadFunc(ShardedType& fl, uint32_t threadNum,
+                       std::vector<double*>& remote) {
+  testShard = threadNum;
+  const uint64_t itemCount = 100;
+  std::vector<double*> vec(itemCount, nullptr);
+  bool result = false;
+
+  // Free the items of another thread while allocating locally
+  for (uint64_t j = 0; j < itemCount * 10; ++j) {
+    uint64_t i = (j * (threadNum * (itemCount + 1) + 1)) % itemCount;
+    double expected = static_cast<double>(threadNum * 100000 + i);
+    if (vec[i]) {
+      result = result || *vec[i] != expected;
+      fl.free(vec[i]);
+    }
+    vec[i] = fl.alloc(expected);
+    if (j < remote.size()) {
+      fl.free(remote[j]);
+    }
+  }
+
+  for (double* d : vec) {
+    if (d) fl.free(d);
+  }
+  return result;
+}
+
+TEST_F(ShardedFreeListTest, eightThreads) {
+  const uint32_t threads = 8;
+  std::vector<std::vector<double*>> items(threads);
+  for (uint32_t i = 0; i < threads; ++i) {
+    testShard = i;
+    for (int j = 0; j < 200; ++j) {
+      items[i].push_back(fl.alloc(0.0));
+    }
+  }
+
+  std::vector<std::future<bool>> futures;
+  for (uint32_t i = 0; i < threads; ++i) {
+    futures.push_back(std::async(std::launch::async, shardedThreadFunc,
+                                 std::ref(fl), i,
+                                 std::ref(items[(i + 1) % threads])));
+  }
+  for (auto& f : futures) {
+    EXPECT_FALSE(f.get());
+  }
+  EXPECT_TRUE(fl.empty());
+  fl.collect();
+  EXPECT_EQ(0, fl.size());
+  EXPECT_EQ(4, fl.shard_count());
+}
@@ -0,0 +1,144 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <freelist/shared_freelist.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct Message {
+  uint64_t sequence;
+  int32_t sender;
+};
+
+using SharedType = freelist::SharedMemoryFreeList<Message>;
+
+class SharedMemoryFreeListTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    name = "/freelist_test_" + std::to_string(getpid());
+    SharedType::unlink(name);
+  }
+
+  void TearDown() override { SharedType::unlink(name); }
+
+  static constexpr size_t kBytes = 1 << 20;
+  std::string name;
+};
+
+constexpr size_t SharedMemoryFreeListTest::kBytes;
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_F(SharedMemoryFreeListTest, create_and_open) {
+  EXPECT_THROW(SharedType::open(name), std::system_error);
+
+  SharedType created = SharedType::create(name, kBytes);
+  EXPECT_THROW(SharedType::create(name, kBytes), std::system_error);
+  EXPECT_TRUE(created.view().empty());
+
+  Message* m = created.view().alloc(Message{1, 2});
+  SharedType::view_type::index_type index = created.view().index(m);
+
+  // A second mapping of the same segment is at a different address
+  SharedType opened = SharedType::open(name);
+  EXPECT_NE(created.data(), opened.data());
+  EXPECT_EQ(1, opened.view().size());
+  EXPECT_EQ(created.view().capacity(), opened.view().capacity());
+
+  Message* other = opened.view().get(index);
+  EXPECT_NE(m, other);
+  EXPECT_EQ(1, other->sequence);
+  EXPECT_EQ(2, other->sender);
+
+  opened.view().free(other);
+  EXPECT_TRUE(created.view().empty());
+}
+
+TEST_F(SharedMemoryFreeListTest, open_wrong_type) {
+  SharedType created = SharedType::create(name, kBytes);
+  EXPECT_THROW(freelist::SharedMemoryFreeList<char[64]>::open(name),
+               std::invalid_argument);
+}
+
+TEST_F(SharedMemoryFreeListTest, unlinked_mapping_remains_valid) {
+  SharedType created = SharedType::create(name, kBytes);
+  EXPECT_TRUE(SharedType::unlink(name));
+  EXPECT_FALSE(SharedType::unlink(name));
+  Message* m = created.view().alloc(Message{3, 4});
+  EXPECT_EQ(3, m->sequence);
+  created.view().free(m);
+}
+
+TEST_F(SharedMemoryFreeListTest, processes) {
+  const int kProcesses = 4;
+  const int kIterations = 20000;
+  SharedType created = SharedType::create(name, kBytes);
+
+  std::vector<pid_t> children;
+  for (int p = 0; p < kProcesses; ++p) {
+    pid_t pid = fork();
+    ASSERT_LE(0, pid);
+    if (pid == 0) {
+      // Map the segment again rather than using the inherited mapping
+      int status = 0;
+      try {
+        SharedType opened = SharedType::open(name);
+        auto& fl = opened.view();
+        std::vector<Message*> items;
+        for (int i = 0; i < kIterations; ++i) {
+          items.push_back(fl.alloc(Message{static_cast<uint64_t>(i), p}));
+          if (items.size() > 50) {
+            Message* front = items.front();
+            if (front->sender != p) status = 1;
+            fl.free(front);
+            items.erase(items.begin());
+          }
+        }
+        for (Message* m : items) fl.free(m);
+      } catch (...) {
+        status = 2;
+      }
+      _exit(status);
+    }
+    children.push_back(pid);
+  }
+
+  for (pid_t pid : children) {
+    int status = 0;
+    ASSERT_EQ(pid, waitpid(pid, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+  }
+  EXPECT_TRUE(created.view().empty());
+}
@@ -0,0 +1,207 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <freelist/freelist.h>
+#include <freelist/growable_freelist.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Number of calls to the global operator new and operator delete
+std::atomic<uint64_t> newCount{0};
+std::atomic<uint64_t> deleteCount{0};
+
+}  // namespace
+
+void* operator new(std::size_t bytes) {
+  newCount.fetch_add(1, std::memory_order_relaxed);
+  void* p = std::malloc(bytes ? bytes : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  if (p) deleteCount.fetch_add(1, std::memory_order_relaxed);
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  if (p) deleteCount.fetch_add(1, std::memory_order_relaxed);
+  std::free(p);
+}
+
+namespace {
+
+struct Request : freelist::RefCounted {
+  explicit Request(int id) : id(id) {}
+  int id;
+};
+
+}  // namespace
+
+using FreeListType = freelist::FreeList<Request, 4096>;
+using GrowableType = freelist::GrowableFreeList<Request, 4096>;
+
+class SharedHandleTest : public ::testing::Test {
+ protected:
+  FreeListType fl;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_F(SharedHandleTest, size) {
+  static_assert(sizeof(FreeListType::SharedHandle) == 2 * sizeof(void*),
+                "SharedHandle holds the item and FreeList pointers");
+  static_assert(sizeof(GrowableType::SharedHandle) == sizeof(void*),
+                "SharedHandle with an empty deleter is one pointer");
+}
+
+TEST_F(SharedHandleTest, reference_count) {
+  FreeListType::SharedHandle empty;
+  EXPECT_FALSE(empty);
+  EXPECT_EQ(0, empty.use_count());
+
+  {
+    FreeListType::SharedHandle a = fl.make_handle(1);
+    EXPECT_EQ(1, a.use_count());
+    EXPECT_EQ(1, a->id);
+    EXPECT_EQ(1, fl.size());
+
+    FreeListType::SharedHandle b = a;
+    EXPECT_EQ(2, a.use_count());
+    EXPECT_EQ(a, b);
+
+    FreeListType::SharedHandle c = std::move(b);
+    EXPECT_FALSE(b);
+    EXPECT_EQ(2, c.use_count());
+
+    empty = c;
+    EXPECT_EQ(3, a.use_count());
+    c.reset();
+    EXPECT_EQ(2, a.use_count());
+    EXPECT_EQ(1, fl.size());
+  }
+  EXPECT_EQ(1, fl.size());
+  empty.reset();
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(SharedHandleTest, growable) {
+  GrowableType growable;
+  {
+    GrowableType::SharedHandle a = growable.make_handle(3);
+    GrowableType::SharedHandle b = a;
+    EXPECT_EQ(2, b.use_count());
+    EXPECT_EQ(1, growable.size());
+  }
+  EXPECT_TRUE(growable.empty());
+}
+
+TEST_F(SharedHandleTest, copied_item_has_own_count) {
+  auto a = fl.make_handle(1);
+  auto b = fl.make_handle(*a);
+  EXPECT_EQ(1, a.use_count());
+  EXPECT_EQ(1, b.use_count());
+  EXPECT_EQ(1, b->id);
+  EXPECT_NE(a, b);
+}
+
+TEST_F(SharedHandleTest, threads) {
+  auto handle = fl.make_handle(7);
+  std::vector<std::future<void>> futures;
+  for (int t = 0; t < 8; ++t) {
+    futures.push_back(std::async(std::launch::async, [handle]() {
+      for (int i = 0; i < 10000; ++i) {
+        FreeListType::SharedHandle copy = handle;
+        EXPECT_EQ(7, copy->id);
+      }
+    }));
+  }
+  for (auto& f : futures) f.get();
+  EXPECT_EQ(1, handle.use_count());
+  handle.reset();
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(SharedHandleTest, no_heap_allocation) {
+  // The first make_shared allocates the control block FreeList
+  fl.make_shared(0);
+
+  const uint64_t before = newCount.load();
+  {
+    auto handle = fl.make_handle(1);
+    auto copy = handle;
+    std::shared_ptr<Request> shared = fl.make_shared(2);
+    std::shared_ptr<Request> sharedCopy = shared;
+    EXPECT_EQ(2, sharedCopy->id);
+    EXPECT_EQ(2, fl.size());
+  }
+  EXPECT_EQ(before, newCount.load());
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(SharedHandleTest, make_shared_control_blocks_freed_with_freelist) {
+  const uint64_t news = newCount.load();
+  const uint64_t deletes = deleteCount.load();
+  {
+    std::unique_ptr<FreeListType> owner(new FreeListType());
+    std::shared_ptr<Request> shared = owner->make_shared(4);
+    EXPECT_EQ(4, shared->id);
+    shared.reset();
+  }
+  // Everything allocated for the control blocks went with the FreeList
+  EXPECT_EQ(newCount.load() - news, deleteCount.load() - deletes);
+}
+
+TEST_F(SharedHandleTest, make_shared_with_allocator) {
+  const uint64_t before = newCount.load();
+  {
+    std::shared_ptr<Request> shared =
+        fl.make_shared(std::allocator_arg, std::allocator<Request>(), 3);
+    EXPECT_EQ(3, shared->id);
+    EXPECT_EQ(1, fl.size());
+  }
+  // The control block came from the supplied allocator
+  EXPECT_EQ(before + 1, newCount.load());
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(SharedHandleTest, make_shared_full) {
+  std::vector<std::shared_ptr<Request>> items;
+  for (size_t i = 0; i < fl.capacity(); ++i) {
+    items.push_back(fl.make_shared(static_cast<int>(i)));
+  }
+  EXPECT_THROW(fl.make_shared(0), std::bad_alloc);
+  items.clear();
+  EXPECT_TRUE(fl.empty());
+}
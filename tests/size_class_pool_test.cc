@@ -0,0 +1,165 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <freelist/size_class_pool.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+using Pool = freelist::SizeClassPool<4096, 8, 24, 48, 64, 256>;
+using PowerOfTwoPool = freelist::PowerOfTwoSizeClassPool<65536, 1024>;
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(SizeClassPoolTest, size_classes) {
+  static_assert(Pool::kClassCount == 5, "kClassCount");
+  static_assert(Pool::kMaxBytes == 256, "kMaxBytes");
+  EXPECT_EQ(0u, Pool::size_class(0));
+  EXPECT_EQ(0u, Pool::size_class(1));
+  EXPECT_EQ(0u, Pool::size_class(8));
+  EXPECT_EQ(1u, Pool::size_class(9));
+  EXPECT_EQ(1u, Pool::size_class(24));
+  EXPECT_EQ(2u, Pool::size_class(25));
+  EXPECT_EQ(3u, Pool::size_class(64));
+  EXPECT_EQ(4u, Pool::size_class(65));
+  EXPECT_EQ(4u, Pool::size_class(256));
+  EXPECT_EQ(Pool::kClassCount, Pool::size_class(257));
+
+  // 16-byte alignment skips the 8 and 24-byte classes, 64-byte alignment the
+  // 48-byte class, and stricter alignment than a cache line is not supported
+  EXPECT_EQ(2u, Pool::size_class(8, 16));
+  EXPECT_EQ(2u, Pool::size_class(24, 16));
+  EXPECT_EQ(3u, Pool::size_class(48, 64));
+  EXPECT_EQ(Pool::kClassCount, Pool::size_class(8, 128));
+
+  static_assert(PowerOfTwoPool::kClassCount == 8, "kClassCount");
+  EXPECT_EQ(8u, PowerOfTwoPool::class_bytes(0));
+  EXPECT_EQ(1024u, PowerOfTwoPool::class_bytes(7));
+  EXPECT_EQ(4u, PowerOfTwoPool::size_class(100));
+}
+
+TEST(SizeClassPoolTest, allocate_and_deallocate) {
+  // Pools are over-aligned, which new only respects from C++17, and this one
+  // is too large for the stack
+  static PowerOfTwoPool pool_;
+  PowerOfTwoPool* pool = &pool_;
+  std::vector<std::pair<void*, std::size_t>> blocks;
+  for (std::size_t bytes = 1; bytes <= PowerOfTwoPool::kMaxBytes; bytes += 13) {
+    void* p = pool->allocate(bytes);
+    EXPECT_TRUE(pool->owns(p));
+    // Aligned enough for any object of that size
+    const std::size_t natural = bytes & (~bytes + 1);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(p) %
+                      std::min(natural, alignof(std::max_align_t)));
+    std::memset(p, static_cast<int>(bytes), bytes);
+    blocks.emplace_back(p, bytes);
+  }
+  EXPECT_THROW(pool->allocate(PowerOfTwoPool::kMaxBytes + 1), std::bad_alloc);
+  EXPECT_EQ(nullptr, pool->try_allocate(PowerOfTwoPool::kMaxBytes + 1));
+  EXPECT_FALSE(pool->owns(&blocks));
+
+  for (auto const& b : blocks) {
+    unsigned char const* bytes = static_cast<unsigned char const*>(b.first);
+    for (std::size_t i = 0; i < b.second; ++i) {
+      EXPECT_EQ(static_cast<unsigned char>(b.second), bytes[i]);
+    }
+    pool->deallocate(b.first, b.second);
+  }
+  for (std::size_t c = 0; c < PowerOfTwoPool::kClassCount; ++c) {
+    EXPECT_EQ(0u, pool->size(c));
+  }
+}
+
+TEST(SizeClassPoolTest, alignment) {
+  Pool pool;
+  for (std::size_t bytes : {1, 8, 24, 40}) {
+    for (std::size_t align = 1; align <= 64; align *= 2) {
+      void* p = pool.allocate(bytes, align);
+      EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(p) % align);
+      pool.deallocate(p, bytes, align);
+    }
+  }
+  EXPECT_THROW(pool.allocate(8, 128), std::bad_alloc);
+}
+
+TEST(SizeClassPoolTest, full_class_uses_larger_class) {
+  Pool pool;
+  std::vector<void*> blocks;
+  while (pool.size(1) == 0) {
+    blocks.push_back(pool.allocate(8));
+  }
+  // Once the 8-byte class is full, 24-byte blocks are used
+  const Pool::size_type full = pool.size(0);
+  EXPECT_LT(4096u / 8 - 4, full);
+  blocks.push_back(pool.allocate(8));
+  EXPECT_EQ(2u, pool.size(1));
+
+  // Freeing from the 8-byte class makes room in it again
+  pool.deallocate(blocks.front(), 8);
+  blocks.erase(blocks.begin());
+  blocks.push_back(pool.allocate(8));
+  EXPECT_EQ(full, pool.size(0));
+  EXPECT_EQ(2u, pool.size(1));
+
+  for (void* b : blocks) pool.deallocate(b, 8);
+  EXPECT_EQ(0u, pool.size(0));
+  EXPECT_EQ(0u, pool.size(1));
+}
+
+TEST(SizeClassPoolTest, threads) {
+  static PowerOfTwoPool pool_;
+  PowerOfTwoPool* pool = &pool_;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&pool, t]() {
+      std::vector<std::pair<uint32_t*, std::size_t>> blocks;
+      for (int i = 0; i < 20000; ++i) {
+        const std::size_t bytes = 4 + (i % 50) * 4;
+        uint32_t* p = static_cast<uint32_t*>(pool->allocate(bytes));
+        *p = static_cast<uint32_t>(t);
+        blocks.emplace_back(p, bytes);
+        if (blocks.size() > 50) {
+          EXPECT_EQ(static_cast<uint32_t>(t), *blocks.front().first);
+          pool->deallocate(blocks.front().first, blocks.front().second);
+          blocks.erase(blocks.begin());
+        }
+      }
+      for (auto const& b : blocks) pool->deallocate(b.first, b.second);
+    });
+  }
+  for (std::thread& t : threads) t.join();
+  for (std::size_t c = 0; c < PowerOfTwoPool::kClassCount; ++c) {
+    EXPECT_EQ(0u, pool->size(c));
+  }
+}
@@ -0,0 +1,157 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <freelist/soa_freelist.h>
+
+#include <cstdint>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct Position {
+  float x, y, z;
+};
+
+using EntityList = freelist::SoAFreeList<Position, float, uint8_t>;
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(SoAFreeListTest, columns) {
+  EntityList fl(1000);
+  EXPECT_TRUE(fl.empty());
+  EXPECT_EQ(1000u, fl.capacity());
+
+  // Each column is a separate, aligned array
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(fl.column<0>()) % 64);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(fl.column<1>()) % 64);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(fl.column<2>()) % 64);
+  EXPECT_LE(reinterpret_cast<char*>(fl.column<0>() + 1001),
+            reinterpret_cast<char*>(fl.column<1>()));
+  EXPECT_LE(reinterpret_cast<char*>(fl.column<1>() + 1001),
+            reinterpret_cast<char*>(fl.column<2>()));
+
+  const EntityList::index_type a = fl.alloc(Position{1, 2, 3}, 4.5f, 6);
+  const EntityList::index_type b = fl.alloc(Position{7, 8, 9}, 1.5f, 2);
+  EXPECT_EQ(2u, fl.size());
+  EXPECT_EQ(3u, fl.end_index());
+
+  EXPECT_EQ(4.5f, fl.column<1>()[a]);
+  EXPECT_EQ(1.5f, fl.get<1>(b));
+  EXPECT_EQ(8, fl.get<0>(b).y);
+
+  Position p;
+  float f;
+  uint8_t u;
+  std::tie(p, f, u) = fl.get(a);
+  EXPECT_EQ(3, p.z);
+  EXPECT_EQ(4.5f, f);
+  EXPECT_EQ(6, u);
+
+  std::get<2>(fl.get(a)) = 10;
+  EXPECT_EQ(10, fl.column<2>()[a]);
+}
+
+TEST(SoAFreeListTest, alloc_and_free) {
+  EntityList fl(100);
+  std::vector<EntityList::index_type> items;
+  for (int i = 0; i < 100; ++i) {
+    items.push_back(fl.alloc(Position{}, static_cast<float>(i), 0));
+  }
+  EXPECT_TRUE(fl.full());
+  EXPECT_THROW(fl.alloc(Position{}, 0.f, 0), std::bad_alloc);
+  EXPECT_EQ(0u, fl.emplace(Position{}, 0.f, 0));
+
+  fl.free(items[10]);
+  fl.free(items[20]);
+  EXPECT_EQ(98u, fl.size());
+  // Freed elements are reused, most recently freed first
+  EXPECT_EQ(items[20], fl.alloc(Position{}, -1.f, 0));
+  EXPECT_EQ(items[10], fl.emplace(Position{}, -2.f, 0));
+  EXPECT_EQ(-1.f, fl.get<1>(items[20]));
+  EXPECT_EQ(-2.f, fl.get<1>(items[10]));
+  EXPECT_EQ(50.f, fl.get<1>(items[50]));
+
+  fl.clear();
+  EXPECT_TRUE(fl.empty());
+  EXPECT_EQ(1u, fl.end_index());
+}
+
+TEST(SoAFreeListTest, for_each_live) {
+  freelist::SoAFreeList<double> fl(1000);
+  std::vector<freelist::SoAFreeList<double>::index_type> items;
+  for (int i = 0; i < 1000; ++i) {
+    items.push_back(fl.alloc(i));
+  }
+  for (int i = 0; i < 1000; i += 3) {
+    fl.free(items[i]);
+  }
+
+  double sum = 0;
+  freelist::SoAFreeList<double>::index_type last = 0;
+  fl.for_each_live([&](freelist::SoAFreeList<double>::index_type index) {
+    EXPECT_LT(last, index);
+    last = index;
+    sum += fl.column<0>()[index];
+  });
+  double expected = 0;
+  for (int i = 0; i < 1000; ++i) {
+    if (i % 3) expected += i;
+  }
+  EXPECT_EQ(expected, sum);
+}
+
+TEST(SoAFreeListTest, capacity_out_of_range) {
+  EXPECT_THROW(freelist::SoAFreeList<int>(0), std::invalid_argument);
+  EXPECT_THROW(freelist::SoAFreeList<int>(uint64_t{1} << 32),
+               std::invalid_argument);
+}
+
+TEST(SoAFreeListTest, threads) {
+  const int kThreads = 8;
+  const int kItems = 10000;
+  freelist::SoAFreeList<int, int> fl(kThreads * 100);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&fl, t]() {
+      std::vector<freelist::SoAFreeList<int, int>::index_type> items;
+      for (int i = 0; i < kItems; ++i) {
+        items.push_back(fl.alloc(t, i));
+        if (items.size() > 50) {
+          EXPECT_EQ(t, fl.get<0>(items.front()));
+          fl.free(items.front());
+          items.erase(items.begin());
+        }
+      }
+      for (auto index : items) fl.free(index);
+    });
+  }
+  for (std::thread& t : threads) t.join();
+  EXPECT_TRUE(fl.empty());
+}
@@ -0,0 +1,193 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <freelist/spsc_freelist.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using SpscType = freelist::SpscFreeList<double, 4096>;
+
+class SpscFreeListTest : public ::testing::Test {
+ protected:
+  SpscType fl;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_F(SpscFreeListTest, empty) {
+  static_assert(sizeof(SpscType) == 4096, "sizeof must equal Size");
+  EXPECT_TRUE(fl.empty());
+  EXPECT_EQ(0, fl.size());
+  EXPECT_LT(500, SpscType::max_size());
+}
+
+TEST_F(SpscFreeListTest, alloc_and_free) {
+  double* a = fl.alloc(1.0);
+  double* b = fl.alloc(2.0);
+  EXPECT_EQ(1.0, *a);
+  EXPECT_EQ(2.0, *b);
+  EXPECT_EQ(2, fl.size());
+  EXPECT_EQ(a, fl.get(fl.index(a)));
+
+  fl.free(a);
+  EXPECT_EQ(1, fl.size());
+  fl.free(b);
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(SpscFreeListTest, reuses_returned_chain) {
+  std::vector<double*> items;
+  for (size_t i = 0; i < SpscType::max_size(); ++i) {
+    items.push_back(fl.alloc(0.0));
+  }
+  EXPECT_THROW(fl.alloc(0.0), std::bad_alloc);
+
+  // Freed elements are taken back, most recently freed first
+  fl.free(items[3]);
+  fl.free(items[7]);
+  EXPECT_EQ(SpscType::max_size() - 2, fl.size());
+  EXPECT_EQ(items[7], fl.alloc(1.0));
+  EXPECT_EQ(items[3], fl.alloc(1.0));
+  EXPECT_THROW(fl.alloc(0.0), std::bad_alloc);
+  EXPECT_EQ(SpscType::max_size(), fl.size());
+
+  for (double* d : items) {
+    fl.free(d);
+  }
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(SpscFreeListTest, clear) {
+  freelist::SpscFreeList<std::string, sizeof(std::string) * 50> strings;
+  std::vector<std::string*> items;
+  for (int i = 0; i < 20; ++i) {
+    items.push_back(
+        strings.alloc("a string long enough to require a heap allocation"));
+  }
+  for (int i = 0; i < 10; ++i) {
+    strings.free(items[i * 2]);
+  }
+  strings.alloc("another");
+  EXPECT_EQ(11, strings.size());
+  strings.clear();
+  EXPECT_TRUE(strings.empty());
+  // Items left in the list are destroyed with it
+  strings.alloc("a string long enough to require a heap allocation");
+}
+
+TEST_F(SpscFreeListTest, small_index) {
+  freelist::SpscFreeList<uint8_t, 128> small;
+  std::vector<uint8_t*> items;
+  for (size_t i = 0; i < small.max_size(); ++i) {
+    items.push_back(small.alloc(static_cast<uint8_t>(i)));
+  }
+  for (uint8_t* item : items) {
+    small.free(item);
+  }
+  EXPECT_TRUE(small.empty());
+  EXPECT_EQ(items.back(), small.alloc(0));
+}
+
+TEST_F(SpscFreeListTest, pipeline) {
+  // One thread allocates, the other frees, through a ring of pointers
+  const uint64_t itemCount = 100000;
+  const size_t kRing = 64;
+  std::atomic<double*> ring[kRing];
+  for (auto& slot : ring) slot.store(nullptr);
+
+  std::thread freeing([&ring, this]() {
+    for (uint64_t i = 0; i < itemCount; ++i) {
+      std::atomic<double*>& slot = ring[i % kRing];
+      double* d;
+      while (!(d = slot.load(std::memory_order_acquire))) {
+        std::this_thread::yield();
+      }
+      slot.store(nullptr, std::memory_order_relaxed);
+      EXPECT_EQ(static_cast<double>(i), *d);
+      fl.free(d);
+    }
+  });
+
+  for (uint64_t i = 0; i < itemCount; ++i) {
+    std::atomic<double*>& slot = ring[i % kRing];
+    while (slot.load(std::memory_order_relaxed)) {
+      std::this_thread::yield();
+    }
+    // Never more items in use than the ring holds, so never full
+    double* d = fl.alloc(static_cast<double>(i));
+    slot.store(d, std::memory_order_release);
+  }
+  freeing.join();
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(SpscFreeListTest, never_full_while_free_in_progress) {
+  // Every element in use, and the freeing thread freeing them as they come
+  using SmallType = freelist::SpscFreeList<uint64_t, 128>;
+  SmallType small;
+  const uint64_t itemCount = 100000;
+  const size_t kRing = SmallType::max_size();
+  std::vector<std::atomic<uint64_t*>> ring(kRing);
+  for (auto& slot : ring) slot.store(nullptr);
+  std::atomic<uint64_t> freed{0};
+
+  std::thread freeing([&]() {
+    for (uint64_t i = 0; i < itemCount; ++i) {
+      std::atomic<uint64_t*>& slot = ring[i % kRing];
+      uint64_t* item;
+      while (!(item = slot.load(std::memory_order_acquire))) {
+        std::this_thread::yield();
+      }
+      slot.store(nullptr, std::memory_order_relaxed);
+      small.free(item);
+      freed.fetch_add(1, std::memory_order_release);
+    }
+  });
+
+  uint64_t failures = 0;
+  for (uint64_t i = 0; i < itemCount; ++i) {
+    // Wait until fewer than max_size() items have not finished being freed
+    while (i - freed.load(std::memory_order_acquire) >= kRing) {
+      std::this_thread::yield();
+    }
+    uint64_t* item = nullptr;
+    while (!item) {
+      try {
+        item = small.alloc(i);
+      } catch (std::bad_alloc&) {
+        ++failures;
+        std::this_thread::yield();
+      }
+    }
+    ring[i % kRing].store(item, std::memory_order_release);
+  }
+  freeing.join();
+  EXPECT_EQ(0, failures);
+  EXPECT_TRUE(small.empty());
+}
@@ -27,6 +27,8 @@
 #define TESTS_TEST_VALUES_H_
 
 #include <cstdint>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -53,7 +55,6 @@ struct ValueStore {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template <>
 template <typename T>
 struct TypeTraits<std::vector<T>> {
   static const std::vector<T> zero;
@@ -115,7 +116,6 @@ struct AbnormalSize {
   char data[Size];
 };
 
-template <>
 template <int Size>
 struct TypeTraits<AbnormalSize<Size>> {
   static const AbnormalSize<Size> zero;
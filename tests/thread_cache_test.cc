@@ -0,0 +1,210 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <freelist/freelist.h>
+#include <freelist/thread_cache.h>
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using FreeListType = freelist::FreeList<double, 80080>;
+using CacheType = freelist::ThreadCache<FreeListType, 16>;
+
+namespace {
+
+struct GenerationsOptions : freelist::FreeListOptions {
+  static constexpr bool kGenerations = true;
+};
+
+struct OccupancyBitmapOptions : freelist::FreeListOptions {
+  static constexpr bool kOccupancyBitmap = true;
+};
+
+}  // namespace
+
+class ThreadCacheTest : public ::testing::Test {
+ protected:
+  FreeListType fl;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_F(ThreadCacheTest, refill_takes_half_magazine) {
+  CacheType cache(fl);
+  EXPECT_EQ(0, cache.size());
+
+  double* d = cache.alloc(1.0);
+  EXPECT_EQ(1.0, *d);
+  EXPECT_EQ(CacheType::max_size() / 2 - 1, cache.size());
+  EXPECT_EQ(CacheType::max_size() / 2, fl.size());
+
+  cache.free(d);
+  EXPECT_EQ(CacheType::max_size() / 2, cache.size());
+  EXPECT_EQ(CacheType::max_size() / 2, fl.size());
+}
+
+TEST_F(ThreadCacheTest, flush_returns_to_parent) {
+  {
+    CacheType cache(fl);
+    std::vector<double*> items;
+    for (int i = 0; i < 100; ++i) {
+      items.push_back(cache.alloc(i));
+    }
+    for (double* d : items) {
+      cache.free(d);
+    }
+    EXPECT_GE(CacheType::max_size(), cache.size());
+    EXPECT_EQ(cache.size(), fl.size());
+
+    cache.flush();
+    EXPECT_EQ(0, cache.size());
+    EXPECT_TRUE(fl.empty());
+
+    cache.alloc(0.0);
+  }
+  // Destructor flushes the remaining cached indexes
+  EXPECT_EQ(1, fl.size());
+}
+
+TEST_F(ThreadCacheTest, mixed_with_parent) {
+  CacheType cache(fl);
+  double* d1 = fl.alloc(1.0);
+  double* d2 = cache.alloc(2.0);
+
+  // Items may be freed through either the cache or the parent
+  cache.free(d1);
+  fl.free(d2);
+  cache.flush();
+  EXPECT_TRUE(fl.empty());
+}
+
+TEST_F(ThreadCacheTest, exhausted_parent) {
+  freelist::FreeList<int32_t, 64> small;
+  freelist::ThreadCache<freelist::FreeList<int32_t, 64>, 4> cache(small);
+
+  std::vector<int32_t*> items;
+  for (int i = 0; i < small.capacity(); ++i) {
+    items.push_back(cache.alloc(i));
+  }
+  EXPECT_TRUE(small.full());
+  EXPECT_THROW(cache.alloc(0), std::bad_alloc);
+  EXPECT_EQ(0, cache.push_index());
+
+  for (int32_t* i : items) {
+    cache.free(i);
+  }
+  cache.flush();
+  EXPECT_TRUE(small.empty());
+}
+
+TEST_F(ThreadCacheTest, free_invalidates_handle) {
+  using GenerationsType = freelist::FreeList<double, 4096, GenerationsOptions>;
+  GenerationsType generations;
+  freelist::ThreadCache<GenerationsType, 4> cache(generations);
+
+  double* d = cache.alloc(1.0);
+  const GenerationsType::Handle handle = generations.handle(d);
+  EXPECT_EQ(d, generations.try_get(handle));
+
+  // The index stays in the magazine, but the handle is already stale
+  const auto cached = cache.size();
+  cache.free(d);
+  EXPECT_EQ(cached + 1, cache.size());
+  EXPECT_EQ(nullptr, generations.try_get(handle));
+
+  // Reusing the index from the magazine gives a new handle
+  double* reused = cache.alloc(2.0);
+  EXPECT_EQ(d, reused);
+  EXPECT_EQ(nullptr, generations.try_get(handle));
+  EXPECT_EQ(reused, generations.try_get(generations.handle(reused)));
+  cache.free(reused);
+}
+
+TEST_F(ThreadCacheTest, cached_indexes_are_not_live) {
+  using BitmapType = freelist::FreeList<double, 4096, OccupancyBitmapOptions>;
+  BitmapType bitmap;
+  freelist::ThreadCache<BitmapType, 8> cache(bitmap);
+
+  // The cache holds indexes taken but not constructed, and freed ones
+  double* d1 = cache.alloc(1.0);
+  double* d2 = cache.alloc(2.0);
+  double* d3 = cache.alloc(3.0);
+  cache.free(d2);
+  EXPECT_LT(2u, bitmap.size());
+
+  std::vector<double> visited;
+  bitmap.for_each_live([&visited](double& d) { visited.push_back(d); });
+  std::sort(visited.begin(), visited.end());
+  EXPECT_EQ((std::vector<double>{1.0, 3.0}), visited);
+  EXPECT_EQ(2u, bitmap.count_live(0, bitmap.capacity() + 1));
+  EXPECT_FALSE(bitmap.is_live(bitmap.index(d2)));
+  EXPECT_EQ(bitmap.index(d1) < bitmap.index(d3) ? bitmap.index(d1)
+                                                : bitmap.index(d3),
+            bitmap.find_live());
+
+  cache.free(d1);
+  cache.free(d3);
+  cache.flush();
+  EXPECT_TRUE(bitmap.empty());
+}
+
+bool cachedThreadFunc(FreeListType& fl, uint64_t threadNum) {
+  const uint64_t itemCount = 100;
+  CacheType cache(fl);
+  std::vector<double*> vec(itemCount, nullptr);
+  bool result = false;
+
+  for (uint64_t j = 0; j < itemCount * 100; ++j) {
+    uint64_t i = (j * (threadNum * (itemCount + 1) + 1)) % itemCount;
+    double expected = static_cast<double>(threadNum * 100000 + i);
+    if (vec[i]) {
+      result = result || *vec[i] != expected;
+      cache.free(vec[i]);
+    }
+    vec[i] = cache.alloc(expected);
+  }
+
+  for (double* d : vec) {
+    if (d) cache.free(d);
+  }
+  return result;
+}
+
+TEST_F(ThreadCacheTest, tenThreads) {
+  const uint64_t threadCount = 10;
+  std::vector<std::future<bool>> futures;
+  for (uint64_t i = 0; i < threadCount; ++i) {
+    futures.push_back(
+        std::async(std::launch::async, cachedThreadFunc, std::ref(fl), i));
+  }
+
+  for (auto& f : futures) {
+    EXPECT_FALSE(f.get());
+  }
+  EXPECT_TRUE(fl.empty());
+}
@@ -0,0 +1,168 @@
+// MIT License
+//
+// Copyright (c) 2019 Daniel Jones
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <freelist/virtual_freelist.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+using VirtualType = freelist::VirtualMemoryFreeList<double>;
+
+constexpr size_t kBytes = size_t{1} << 30;
+
+// Number of resident pages in [p, p + bytes)
+size_t resident_pages(void* p, size_t bytes) {
+  const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  std::vector<unsigned char> vec((bytes + page - 1) / page);
+  EXPECT_EQ(0, mincore(p, bytes, vec.data()));
+  size_t n = 0;
+  for (unsigned char c : vec) n += c & 1;
+  return n;
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(VirtualMemoryFreeListTest, commit_on_use) {
+  VirtualType fl(kBytes);
+  EXPECT_EQ(kBytes, fl.reserved_bytes());
+  EXPECT_EQ(VirtualType::view_type::capacity_for(kBytes), fl.capacity());
+  EXPECT_EQ(VirtualType::kCommitBytes, fl.committed_bytes());
+
+  std::vector<double*> items;
+  for (int i = 0; i < 100000; ++i) {
+    items.push_back(fl.alloc(i));
+  }
+  EXPECT_LE(100000 * sizeof(double), fl.committed_bytes());
+  EXPECT_GT(100000 * sizeof(double) + VirtualType::kCommitBytes,
+            fl.committed_bytes());
+  for (int i = 0; i < 100000; ++i) {
+    EXPECT_EQ(i, *items[i]);
+  }
+}
+
+TEST(VirtualMemoryFreeListTest, trim_after_burst) {
+  VirtualType fl(kBytes);
+  std::vector<double*> items;
+  for (int i = 0; i < 1000000; ++i) {
+    items.push_back(fl.alloc(i));
+  }
+  const size_t peak = fl.committed_bytes();
+  EXPECT_LT(peak / 2, resident_pages(fl.data(), peak) *
+                          static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+
+  // Keep a few items at the start of the burst
+  for (size_t i = 10; i < items.size(); ++i) {
+    fl.free(items[i]);
+  }
+  EXPECT_EQ(peak, fl.committed_bytes());
+  EXPECT_EQ(peak - VirtualType::kCommitBytes, fl.trim());
+  EXPECT_EQ(VirtualType::kCommitBytes, fl.committed_bytes());
+  EXPECT_EQ(0u, resident_pages(static_cast<char*>(fl.data()) +
+                                   VirtualType::kCommitBytes,
+                               peak - VirtualType::kCommitBytes));
+  EXPECT_EQ(0u, fl.trim());
+
+  // The remaining items are intact, and the trimmed elements can be reused
+  EXPECT_EQ(10, fl.size());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(i, *items[i]);
+  }
+  for (int i = 10; i < 1000000; ++i) {
+    items[i] = fl.alloc(-i);
+  }
+  EXPECT_EQ(peak, fl.committed_bytes());
+  for (int i = 0; i < 1000000; ++i) {
+    EXPECT_EQ(i < 10 ? i : -i, *items[i]);
+  }
+}
+
+TEST(VirtualMemoryFreeListTest, trim_keeps_interior_free_elements) {
+  VirtualType fl(1 << 24);
+  std::vector<double*> items;
+  for (int i = 0; i < 100000; ++i) {
+    items.push_back(fl.alloc(i));
+  }
+  // The free elements are all below the last item, so none can be trimmed
+  for (int i = 0; i < 99999; ++i) {
+    fl.free(items[i]);
+  }
+  EXPECT_EQ(0u, fl.trim());
+
+  fl.free(items[99999]);
+  EXPECT_LT(0u, fl.trim());
+  EXPECT_TRUE(fl.empty());
+  EXPECT_EQ(VirtualType::kCommitBytes, fl.committed_bytes());
+
+  // The free list was truncated consistently: every element is reusable
+  size_t count = 0;
+  while (fl.emplace(1.0)) ++count;
+  EXPECT_EQ(fl.capacity(), count);
+}
+
+TEST(VirtualMemoryFreeListTest, clear) {
+  VirtualType fl(kBytes);
+  for (int i = 0; i < 100000; ++i) {
+    fl.alloc(i);
+  }
+  fl.clear();
+  EXPECT_TRUE(fl.empty());
+  EXPECT_EQ(VirtualType::kCommitBytes, fl.committed_bytes());
+  EXPECT_EQ(5, *fl.alloc(5));
+}
+
+TEST(VirtualMemoryFreeListTest, too_small) {
+  EXPECT_THROW(VirtualType(0), std::invalid_argument);
+}
+
+TEST(VirtualMemoryFreeListTest, threads) {
+  VirtualType fl(kBytes);
+  const int kThreads = 8;
+  const int kItems = 50000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&fl, t]() {
+      std::vector<double*> items;
+      for (int i = 0; i < kItems; ++i) {
+        items.push_back(fl.alloc(t * kItems + i));
+      }
+      for (int i = 0; i < kItems; ++i) {
+        EXPECT_EQ(t * kItems + i, *items[i]);
+        fl.free(items[i]);
+      }
+    });
+  }
+  for (std::thread& t : threads) t.join();
+  EXPECT_TRUE(fl.empty());
+  EXPECT_LT(0u, fl.trim());
+  EXPECT_EQ(VirtualType::kCommitBytes, fl.committed_bytes());
+}